@@ -0,0 +1,379 @@
+// nexusterm-bench：热点路径的微基准 (Google Benchmark)。
+// 所有输入都由固定种子的伪随机数生成，每次运行完全相同，结果可以跨提交直接比较：
+//   ./nexusterm-bench --benchmark_out=bench.json --benchmark_out_format=json
+#include <benchmark/benchmark.h>
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QImage>
+#include <QImageReader>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "LogFormatter.h"
+#include "LogModel.h"
+#include "Rgb565Kernels.h"
+#include "StreamFramer.h"
+#include "VideoPacketHeader.h"
+#include "VideoStreamDecoder.h"
+
+namespace {
+
+constexpr quint32 kSeed = 20240601;
+constexpr int kDatagramSize = 1472;           // 以太网 MTU 下的 UDP 负载
+constexpr int kFramesPerIteration = 4;
+
+QByteArray randomBytes(qsizetype size, quint32 seed) {
+    std::mt19937 rng(seed);
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i) {
+        data[i] = static_cast<char>(rng() & 0xFF);
+    }
+    return data;
+}
+
+// 像素数据中不出现 0xF0，保证帧内不会偶然拼出帧头 F0 5A A5 0F
+QByteArray randomPixels(qsizetype size, quint32 seed) {
+    QByteArray data = randomBytes(size, seed);
+    for (char &byte : data) {
+        if (static_cast<uchar>(byte) == 0xF0) byte = static_cast<char>(0xF1);
+    }
+    return data;
+}
+
+// 字节流模式的连续视频流：每帧 F0 5A A5 0F | 宽 高 | FF xx xx xx FF | 像素，
+// junkBytes > 0 时在帧之间插入不含帧头的垃圾数据，模拟重新同步
+QByteArray buildByteStream(int width, int height, int frames, int junkBytes) {
+    const QByteArray pixels = randomPixels(qsizetype(width) * height * 2, kSeed);
+    const QByteArray junk = randomPixels(junkBytes, kSeed + 1);
+    QByteArray stream;
+    stream.reserve((pixels.size() + 13 + junk.size()) * frames);
+    for (int i = 0; i < frames; ++i) {
+        const uchar header[13] = { 0xF0, 0x5A, 0xA5, 0x0F,
+                                   uchar(width >> 8), uchar(width), uchar(height >> 8), uchar(height),
+                                   0xFF, 0x01, 0x02, uchar(i), 0xFF };
+        stream.append(reinterpret_cast<const char *>(header), sizeof(header));
+        stream.append(pixels);
+        stream.append(junk);
+    }
+    return stream;
+}
+
+QList<QByteArray> splitDatagrams(const QByteArray &stream, int datagramSize) {
+    QList<QByteArray> datagrams;
+    for (qsizetype offset = 0; offset < stream.size(); offset += datagramSize) {
+        datagrams.append(stream.mid(offset, datagramSize));
+    }
+    return datagrams;
+}
+
+QList<QByteArray> buildPacketizedStream(int width, int height, int frames) {
+    const QByteArray pixels = randomBytes(qsizetype(width) * height * 2, kSeed);
+    const int segment = kDatagramSize - int(VideoPacketHeader::kSize);
+    const int packetCount = int((pixels.size() + segment - 1) / segment);
+    QList<QByteArray> datagrams;
+    for (int frame = 0; frame < frames; ++frame) {
+        for (int packet = 0; packet < packetCount; ++packet) {
+            VideoPacketHeader header;
+            header.frameId = quint32(frame);
+            header.packetIndex = quint16(packet);
+            header.packetCount = quint16(packetCount);
+            header.offset = quint32(packet) * segment;
+            header.width = quint16(width);
+            header.height = quint16(height);
+            const qsizetype length = qMin<qsizetype>(segment, pixels.size() - header.offset);
+            QByteArray datagram(VideoPacketHeader::kSize + length, Qt::Uninitialized);
+            header.write(reinterpret_cast<uchar *>(datagram.data()));
+            std::memcpy(datagram.data() + VideoPacketHeader::kSize, pixels.constData() + header.offset, length);
+            datagrams.append(datagram);
+        }
+    }
+    return datagrams;
+}
+
+// 视频帧同步、校验和解码 (processVideoFrameBuffer)。参数：宽、高、帧间垃圾字节数
+void BM_VideoByteStream(benchmark::State &state) {
+    const int width = int(state.range(0));
+    const int height = int(state.range(1));
+    const QList<QByteArray> datagrams = splitDatagrams(buildByteStream(width, height, kFramesPerIteration, int(state.range(2))), kDatagramSize);
+    qint64 bytes = 0;
+    for (const QByteArray &datagram : datagrams) bytes += datagram.size();
+
+    VideoStreamDecoder decoder;
+    QImage image;
+    QByteArray status;
+    for (auto _ : state) {
+        for (const QByteArray &datagram : datagrams) {
+            decoder.appendData(datagram);
+        }
+        benchmark::DoNotOptimize(decoder.takeLatestFrame(&image, &status));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * kFramesPerIteration);
+}
+BENCHMARK(BM_VideoByteStream)->Args({ 640, 480, 0 })->Args({ 1280, 720, 0 })->Args({ 640, 480, 65536 });
+
+// 分包协议：按报头偏移直接放入帧缓冲
+void BM_VideoPacketized(benchmark::State &state) {
+    const int width = int(state.range(0));
+    const int height = int(state.range(1));
+    // 每轮使用新的帧号，避免被当作迟到包丢弃
+    const int rounds = 64;
+    const QList<QByteArray> datagrams = buildPacketizedStream(width, height, kFramesPerIteration * rounds);
+    const qsizetype perIteration = datagrams.size() / rounds;
+    qint64 bytes = 0;
+    for (qsizetype i = 0; i < perIteration; ++i) bytes += datagrams.at(i).size();
+
+    VideoStreamDecoder decoder;
+    decoder.setPacketizedMode(true);
+    QImage image;
+    QByteArray status;
+    qsizetype next = 0;
+    for (auto _ : state) {
+        if (next >= datagrams.size()) {
+            state.PauseTiming();
+            decoder.reset();
+            next = 0;
+            state.ResumeTiming();
+        }
+        for (qsizetype i = 0; i < perIteration; ++i) {
+            decoder.appendData(datagrams.at(next++));
+        }
+        benchmark::DoNotOptimize(decoder.takeLatestFrame(&image, &status));
+    }
+    state.SetBytesProcessed(state.iterations() * bytes);
+    state.SetItemsProcessed(state.iterations() * kFramesPerIteration);
+}
+BENCHMARK(BM_VideoPacketized)->Args({ 640, 480 })->Args({ 1280, 720 });
+
+// RGB565 字节交换 / 扩展为 RGB32：分派后的实现与标量参考实现
+template <bool Scalar>
+void BM_Rgb565Swap(benchmark::State &state) {
+    const qsizetype pixels = state.range(0);
+    const QByteArray src = randomBytes(pixels * 2, kSeed);
+    std::vector<uchar> dst(static_cast<size_t>(pixels) * 2);
+    for (auto _ : state) {
+        if (Scalar) {
+            Rgb565Kernels::swapBytesScalar(reinterpret_cast<const uchar *>(src.constData()), dst.data(), pixels);
+        } else {
+            Rgb565Kernels::swapBytes(reinterpret_cast<const uchar *>(src.constData()), dst.data(), pixels);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * pixels * 2);
+    state.SetLabel(Scalar ? "scalar" : Rgb565Kernels::activeKernelName());
+}
+BENCHMARK_TEMPLATE(BM_Rgb565Swap, false)->Arg(640 * 480)->Arg(1920 * 1080);
+BENCHMARK_TEMPLATE(BM_Rgb565Swap, true)->Arg(640 * 480)->Arg(1920 * 1080);
+
+template <bool Scalar>
+void BM_Rgb565ToRgb32(benchmark::State &state) {
+    const qsizetype pixels = state.range(0);
+    const QByteArray src = randomBytes(pixels * 2, kSeed);
+    std::vector<quint32> dst(static_cast<size_t>(pixels));
+    for (auto _ : state) {
+        if (Scalar) {
+            Rgb565Kernels::convertBigEndianToRgb32Scalar(reinterpret_cast<const uchar *>(src.constData()), dst.data(), pixels);
+        } else {
+            Rgb565Kernels::convertBigEndianToRgb32(reinterpret_cast<const uchar *>(src.constData()), dst.data(), pixels);
+        }
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * pixels * 2);
+    state.SetLabel(Scalar ? "scalar" : Rgb565Kernels::activeKernelName());
+}
+BENCHMARK_TEMPLATE(BM_Rgb565ToRgb32, false)->Arg(640 * 480)->Arg(1920 * 1080);
+BENCHMARK_TEMPLATE(BM_Rgb565ToRgb32, true)->Arg(640 * 480)->Arg(1920 * 1080);
+
+// 日志十六进制 / 十进制格式化 (updateLogDisplay 切换格式后可见行的重新格式化)
+void BM_LogToHex(benchmark::State &state) {
+    const QByteArray data = randomBytes(state.range(0), kSeed);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LogFormatter::toHex(data));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+    state.SetLabel(LogFormatter::activeKernelName());
+}
+BENCHMARK(BM_LogToHex)->RangeMultiplier(16)->Range(16, 65536);
+
+void BM_LogToHexScalar(benchmark::State &state) {
+    const QByteArray data = randomBytes(state.range(0), kSeed);
+    std::vector<char16_t> out(static_cast<size_t>(data.size()) * 3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LogFormatter::writeHexScalar(reinterpret_cast<const uchar *>(data.constData()), data.size(), out.data()));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_LogToHexScalar)->RangeMultiplier(16)->Range(16, 65536);
+
+void BM_LogToDecimal(benchmark::State &state) {
+    const QByteArray data = randomBytes(state.range(0), kSeed);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LogFormatter::toDecimal(data));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_LogToDecimal)->RangeMultiplier(16)->Range(16, 65536);
+
+// 一行日志的完整格式化 (时间戳、方向、来源 + 数据)
+void BM_LogFormatEntry(benchmark::State &state) {
+    const LogEntry entry { QDateTime(QDate(2024, 6, 1), QTime(12, 0)), LogEntry::In, randomBytes(state.range(0), kSeed), "192.168.1.10:5000" };
+    const auto mode = static_cast<LogModel::DisplayMode>(state.range(1));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LogModel::formatEntry(entry, mode));
+    }
+    state.SetBytesProcessed(state.iterations() * entry.rawData.size());
+}
+BENCHMARK(BM_LogFormatEntry)->ArgsProduct({ { 64, 1024 }, { int(LogModel::DisplayMode::Ascii), int(LogModel::DisplayMode::Hex),
+                                                         int(LogModel::DisplayMode::Decimal) } });
+
+// 大量日志插入：N 条 64 字节记录追加并提交。参数：条数、内存预算 (MB，0 表示不转存)
+void BM_LogModelAppend(benchmark::State &state) {
+    const qsizetype count = state.range(0);
+    const qint64 budget = state.range(1) * 1024 * 1024;
+    const QByteArray payload = randomBytes(64, kSeed);
+    const QDateTime timestamp(QDate(2024, 6, 1), QTime(12, 0));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto model = std::make_unique<LogModel>();
+        model->setMemoryBudget(budget);
+        state.ResumeTiming();
+        for (qsizetype i = 0; i < count; ++i) {
+            model->appendEntry({ timestamp, LogEntry::In, payload, QString() });
+            if ((i & 1023) == 1023) model->flushPending();
+        }
+        model->flushPending();
+        benchmark::DoNotOptimize(model->rowCount());
+        state.PauseTiming(); // 析构 (释放映射段) 不计入
+        model.reset();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_LogModelAppend)->Args({ 1 << 16, 0 })->Args({ 1 << 20, 0 })->Args({ 1 << 20, 16 })->Unit(benchmark::kMillisecond);
+
+// handleIncomingData 的自动模式对每个数据块都先尝试按图像解码。参数：0 文本、1 PNG、2 BMP
+QByteArray sampleImage(const char *format) {
+    QImage image(320, 240, QImage::Format_RGB32);
+    std::mt19937 rng(kSeed);
+    for (int y = 0; y < image.height(); ++y) {
+        quint32 *line = reinterpret_cast<quint32 *>(image.scanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            line[x] = 0xFF000000u | (rng() & 0x00FFFFFFu);
+        }
+    }
+    QByteArray encoded;
+    QBuffer buffer(&encoded);
+    buffer.open(QIODevice::WriteOnly);
+    image.save(&buffer, format);
+    return encoded;
+}
+
+QByteArray incomingSample(int kind) {
+    switch (kind) {
+    case 1: return sampleImage("PNG");
+    case 2: return sampleImage("BMP");
+    default: return QByteArray("$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n").repeated(16);
+    }
+}
+
+void BM_ImageDecode(benchmark::State &state) {
+    const QByteArray data = incomingSample(int(state.range(0)));
+    for (auto _ : state) {
+        QImage image;
+        benchmark::DoNotOptimize(image.loadFromData(data));
+    }
+    state.SetBytesProcessed(state.iterations() * data.size());
+}
+BENCHMARK(BM_ImageDecode)->DenseRange(0, 2);
+
+// 只识别格式不解码
+void BM_ImageSniff(benchmark::State &state) {
+    const QByteArray data = incomingSample(int(state.range(0)));
+    for (auto _ : state) {
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+        benchmark::DoNotOptimize(QImageReader::imageFormat(&buffer));
+    }
+}
+BENCHMARK(BM_ImageSniff)->DenseRange(0, 2);
+
+// 接收分帧：64 字节的消息编码成连续字节流，按 UDP 数据报大小分块送入。参数：StreamFramer::Type
+QByteArray encodeFrames(StreamFramer::Type type, int count, qsizetype messageSize) {
+    QByteArray stream;
+    for (int i = 0; i < count; ++i) {
+        QByteArray message = randomBytes(messageSize, kSeed + i);
+        switch (type) {
+        case StreamFramer::Type::LengthPrefixed:
+            stream.append(char(messageSize >> 8)).append(char(messageSize & 0xFF)).append(message);
+            break;
+        case StreamFramer::Type::Delimiter:
+            message.replace('\n', ' ');
+            stream.append(message).append('\n');
+            break;
+        case StreamFramer::Type::Slip:
+            for (char byte : message) {
+                if (uchar(byte) == 0xC0) stream.append("\xDB\xDC", 2);
+                else if (uchar(byte) == 0xDB) stream.append("\xDB\xDD", 2);
+                else stream.append(byte);
+            }
+            stream.append(char(0xC0));
+            break;
+        case StreamFramer::Type::Cobs: {
+            // 消息短于 254 字节，每个分组的长度都不会达到 0xFF
+            qsizetype codeIndex = stream.size();
+            stream.append(char(1));
+            for (char byte : message) {
+                if (byte == 0) {
+                    codeIndex = stream.size();
+                    stream.append(char(1));
+                } else {
+                    stream.append(byte);
+                    ++stream[codeIndex];
+                }
+            }
+            stream.append(char(0));
+            break;
+        }
+        default:
+            stream.append(message);
+            break;
+        }
+    }
+    return stream;
+}
+
+void BM_StreamFramer(benchmark::State &state) {
+    constexpr int kMessages = 1024;
+    StreamFramer::Config config;
+    config.type = static_cast<StreamFramer::Type>(state.range(0));
+    const QByteArray stream = encodeFrames(config.type, kMessages, 64);
+    std::unique_ptr<StreamFramer> framer = StreamFramer::create(config);
+    QList<QByteArray> frames;
+    for (auto _ : state) {
+        frames.clear();
+        for (qsizetype offset = 0; offset < stream.size(); offset += kDatagramSize) {
+            framer->feed(stream.mid(offset, kDatagramSize), 0, &frames);
+        }
+        benchmark::DoNotOptimize(frames.size());
+    }
+    state.SetBytesProcessed(state.iterations() * stream.size());
+    state.SetItemsProcessed(state.iterations() * kMessages);
+}
+BENCHMARK(BM_StreamFramer)->Arg(int(StreamFramer::Type::LengthPrefixed))->Arg(int(StreamFramer::Type::Delimiter))
+                          ->Arg(int(StreamFramer::Type::Slip))->Arg(int(StreamFramer::Type::Cobs))
+                          ->Arg(int(StreamFramer::Type::FixedSize));
+
+}
+
+int main(int argc, char *argv[])
+{
+    // LogModel 使用 QTimer，图像插件也需要应用对象才能定位
+    QCoreApplication app(argc, argv);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,66 @@
+#include "ByteRingBuffer.h"
+#include <cstring>
+
+namespace {
+qsizetype roundUpToPowerOfTwo(qsizetype value) {
+    qsizetype result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+}
+
+ByteRingBuffer::ByteRingBuffer(qsizetype capacity)
+    : m_buffer(static_cast<size_t>(roundUpToPowerOfTwo(qMax<qsizetype>(capacity, 1))))
+    , m_mask(static_cast<qsizetype>(m_buffer.size()) - 1)
+    , m_head(0)
+    , m_size(0)
+{
+}
+
+qsizetype ByteRingBuffer::write(const char *data, qsizetype len) {
+    len = qMin(len, freeSpace());
+    if (len <= 0) return 0;
+
+    const qsizetype tail = (m_head + m_size) & m_mask;
+    const qsizetype firstPart = qMin(len, capacity() - tail);
+    std::memcpy(m_buffer.data() + tail, data, static_cast<size_t>(firstPart));
+    if (firstPart < len) {
+        std::memcpy(m_buffer.data(), data + firstPart, static_cast<size_t>(len - firstPart));
+    }
+    m_size += len;
+    return len;
+}
+
+qsizetype ByteRingBuffer::peek(char *dst, qsizetype len, qsizetype offset) const {
+    if (offset >= m_size) return 0;
+    len = qMin(len, m_size - offset);
+
+    const qsizetype start = (m_head + offset) & m_mask;
+    const qsizetype firstPart = qMin(len, capacity() - start);
+    std::memcpy(dst, m_buffer.data() + start, static_cast<size_t>(firstPart));
+    if (firstPart < len) {
+        std::memcpy(dst + firstPart, m_buffer.data(), static_cast<size_t>(len - firstPart));
+    }
+    return len;
+}
+
+void ByteRingBuffer::skip(qsizetype n) {
+    n = qMin(n, m_size);
+    m_head = (m_head + n) & m_mask;
+    m_size -= n;
+    if (m_size == 0) {
+        m_head = 0; // 缓冲区为空时回到起点，尽量让后续数据保持连续
+    }
+}
+
+void ByteRingBuffer::clear() {
+    m_head = 0;
+    m_size = 0;
+}
+
+const char *ByteRingBuffer::readPointer(qsizetype *len) const {
+    *len = qMin(m_size, capacity() - m_head);
+    return m_buffer.data() + m_head;
+}
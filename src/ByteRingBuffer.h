@@ -0,0 +1,36 @@
+#ifndef BYTERINGBUFFER_H
+#define BYTERINGBUFFER_H
+
+#include <QtGlobal>
+#include <vector>
+
+// 固定容量的字节环形缓冲区。写入和消费都不会移动已有数据，
+// 容量在构造时向上取整为 2 的幂，以便用掩码代替取模。
+class ByteRingBuffer {
+public:
+    explicit ByteRingBuffer(qsizetype capacity);
+
+    qsizetype capacity() const { return static_cast<qsizetype>(m_buffer.size()); }
+    qsizetype size() const { return m_size; }
+    qsizetype freeSpace() const { return capacity() - m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+    // 写入尽可能多的数据，返回实际写入的字节数
+    qsizetype write(const char *data, qsizetype len);
+    // 从读位置 offset 处复制 len 字节到 dst，不消费数据
+    qsizetype peek(char *dst, qsizetype len, qsizetype offset = 0) const;
+    // 丢弃读位置开始的 n 个字节
+    void skip(qsizetype n);
+    void clear();
+
+    // 返回读位置开始的连续内存块，长度写入 *len（不跨越回绕点）
+    const char *readPointer(qsizetype *len) const;
+
+private:
+    std::vector<char> m_buffer;
+    qsizetype m_mask;
+    qsizetype m_head; // 读位置
+    qsizetype m_size;
+};
+
+#endif // BYTERINGBUFFER_H
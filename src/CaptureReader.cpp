@@ -0,0 +1,280 @@
+#include "CaptureReader.h"
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+namespace {
+constexpr qint64 kNativeFileHeaderSize = 16;
+constexpr qint64 kNativeRecordHeaderSize = 16;
+
+constexpr quint32 kPcapSectionHeader = 0x0A0D0D0A;
+constexpr quint32 kPcapInterfaceDescription = 0x00000001;
+constexpr quint32 kPcapEnhancedPacket = 0x00000006;
+constexpr quint32 kPcapByteOrderMagic = 0x1A2B3C4D;
+constexpr quint16 kPcapOptEnd = 0;
+constexpr quint16 kPcapOptIfName = 2;
+constexpr quint16 kPcapOptIfTsResol = 9;
+constexpr quint16 kPcapOptEpbFlags = 2;
+constexpr quint32 kPcapFlagDirectionMask = 0x3;
+constexpr quint32 kPcapFlagOutbound = 2;
+
+template <typename T>
+T readLE(const uchar *src) {
+    return qFromLittleEndian<T>(src);
+}
+
+qint64 paddedTo4(qint64 length) {
+    return (length + 3) & ~qint64(3);
+}
+}
+
+CaptureReader::CaptureReader()
+    : m_map(nullptr)
+    , m_size(0)
+    , m_pos(0)
+    , m_dataStart(0)
+    , m_format(CaptureWriter::Format::Native)
+{
+}
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open(const QString &filePath) {
+    close();
+    m_error.clear();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        setError(m_file.errorString());
+        return false;
+    }
+    m_size = m_file.size();
+    if (m_size < 12) {
+        setError("文件太小，不是有效的抓包文件");
+        close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        setError(m_file.errorString());
+        close();
+        return false;
+    }
+
+    if (std::memcmp(m_map, "NXCP", 4) == 0) {
+        const quint16 version = readLE<quint16>(m_map + 4);
+        if (version > CaptureWriter::kNativeVersion || m_size < kNativeFileHeaderSize) {
+            setError(QString("不支持的抓包文件版本: %1").arg(version));
+            close();
+            return false;
+        }
+        m_format = CaptureWriter::Format::Native;
+        m_dataStart = kNativeFileHeaderSize;
+    } else if (readLE<quint32>(m_map) == kPcapSectionHeader) {
+        if (readLE<quint32>(m_map + 8) != kPcapByteOrderMagic) {
+            setError("只支持小端字节序的 pcapng 文件");
+            close();
+            return false;
+        }
+        m_format = CaptureWriter::Format::PcapNg;
+        m_dataStart = 0; // 从 SHB 开始按块解析
+    } else {
+        setError("无法识别的抓包文件格式");
+        close();
+        return false;
+    }
+
+    rewind();
+    return true;
+}
+
+void CaptureReader::close() {
+    if (m_map) {
+        m_file.unmap(const_cast<uchar *>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_size = 0;
+    m_pos = 0;
+    m_nativePeers.clear();
+    m_interfaces.clear();
+}
+
+void CaptureReader::rewind() {
+    m_pos = m_dataStart;
+    m_nativePeers.clear();
+    m_interfaces.clear();
+}
+
+void CaptureReader::setError(const QString &error) {
+    m_error = error;
+    qWarning() << "[Capture]" << error;
+}
+
+void CaptureReader::splitPeerDescription(const QString &description, CaptureWriter::Transport *transport, QString *peer) {
+    // 描述格式为 "<传输方式> <对端>"，与 CaptureWriter 写入时一致
+    const int space = description.indexOf(QLatin1Char(' '));
+    const QString name = space >= 0 ? description.left(space) : description;
+    *peer = space >= 0 ? description.mid(space + 1) : QString();
+    for (auto candidate : { CaptureWriter::Transport::Serial, CaptureWriter::Transport::TcpClient,
+                            CaptureWriter::Transport::TcpServer, CaptureWriter::Transport::Udp }) {
+        if (CaptureWriter::transportName(candidate) == name) {
+            *transport = candidate;
+            return;
+        }
+    }
+    *peer = description; // 其他工具生成的 pcapng，保留完整接口名
+}
+
+bool CaptureReader::readNext(CaptureRecord *record) {
+    if (!m_map) return false;
+    return m_format == CaptureWriter::Format::Native ? readNextNative(record) : readNextPcapNg(record);
+}
+
+bool CaptureReader::readNextNative(CaptureRecord *record) {
+    while (m_pos + kNativeRecordHeaderSize <= m_size) {
+        const uchar *header = m_map + m_pos;
+        const quint64 timestamp = readLE<quint64>(header);
+        const quint32 length = readLE<quint32>(header + 8);
+        const auto type = static_cast<CaptureWriter::RecordType>(header[12]);
+        const auto transport = static_cast<CaptureWriter::Transport>(header[13]);
+        const quint16 peerId = readLE<quint16>(header + 14);
+
+        if (m_pos + kNativeRecordHeaderSize + length > m_size) {
+            // 录制中途断电等情况下最后一条记录可能不完整，丢弃即可
+            qWarning() << "[Capture] 文件末尾的记录不完整，已忽略";
+            m_pos = m_size;
+            return false;
+        }
+        const char *payload = reinterpret_cast<const char *>(header + kNativeRecordHeaderSize);
+        m_pos += kNativeRecordHeaderSize + length;
+
+        if (type == CaptureWriter::RecordType::PeerInfo) {
+            m_nativePeers.insert(peerId, QString::fromUtf8(payload, length));
+            continue;
+        }
+        if (type != CaptureWriter::RecordType::Rx && type != CaptureWriter::RecordType::Tx) {
+            continue; // 未知类型，留给以后的版本
+        }
+
+        record->timestampNs = static_cast<qint64>(timestamp);
+        record->type = type;
+        record->transport = transport;
+        CaptureWriter::Transport ignored = transport;
+        splitPeerDescription(m_nativePeers.value(peerId), &ignored, &record->peer);
+        record->data = QByteArray(payload, length);
+        return true;
+    }
+    return false;
+}
+
+bool CaptureReader::parseInterfaceBlock(const uchar *body, qint64 length) {
+    Interface iface;
+    if (length < 8) {
+        m_interfaces.append(iface); // 保持接口编号连续
+        return false;
+    }
+    qint64 pos = 8; // linktype(2) reserved(2) snaplen(4)
+    QString description;
+    while (pos + 4 <= length) {
+        const quint16 code = readLE<quint16>(body + pos);
+        const quint16 optionLength = readLE<quint16>(body + pos + 2);
+        pos += 4;
+        if (code == kPcapOptEnd || pos + optionLength > length) break;
+        if (code == kPcapOptIfName) {
+            description = QString::fromUtf8(reinterpret_cast<const char *>(body + pos), optionLength);
+        } else if (code == kPcapOptIfTsResol && optionLength >= 1) {
+            const quint8 resolution = body[pos];
+            const int exponent = resolution & 0x7F;
+            if (resolution & 0x80) {
+                // 2^-n 秒
+                iface.multiplier = 1000000000;
+                iface.divisor = exponent < 62 ? (qint64(1) << exponent) : (qint64(1) << 62);
+            } else if (exponent <= 9) {
+                iface.multiplier = 1;
+                for (int i = exponent; i < 9; ++i) iface.multiplier *= 10;
+                iface.divisor = 1;
+            } else {
+                iface.multiplier = 1;
+                iface.divisor = 1;
+                for (int i = 9; i < exponent && i < 27; ++i) iface.divisor *= 10;
+            }
+        }
+        pos += paddedTo4(optionLength);
+    }
+    splitPeerDescription(description, &iface.transport, &iface.peer);
+    m_interfaces.append(iface);
+    return true;
+}
+
+bool CaptureReader::readNextPcapNg(CaptureRecord *record) {
+    while (m_pos + 12 <= m_size) {
+        const uchar *block = m_map + m_pos;
+        const quint32 type = readLE<quint32>(block);
+        const quint32 totalLength = readLE<quint32>(block + 4);
+        if (totalLength < 12 || (totalLength & 3) != 0) {
+            setError(QString("pcapng 块长度无效 (偏移 %1)").arg(m_pos));
+            m_pos = m_size;
+            return false;
+        }
+        if (m_pos + totalLength > m_size) {
+            qWarning() << "[Capture] 文件末尾的块不完整，已忽略";
+            m_pos = m_size;
+            return false;
+        }
+        const uchar *body = block + 8;
+        const qint64 bodyLength = qint64(totalLength) - 12;
+        m_pos += totalLength;
+
+        if (type == kPcapSectionHeader) {
+            // 新的 section 重新编号接口
+            m_interfaces.clear();
+            continue;
+        }
+        if (type == kPcapInterfaceDescription) {
+            parseInterfaceBlock(body, bodyLength);
+            continue;
+        }
+        if (type != kPcapEnhancedPacket || bodyLength < 20) {
+            continue; // 统计、名称解析等其他块
+        }
+
+        const quint32 interfaceId = readLE<quint32>(body);
+        const quint64 ticks = (quint64(readLE<quint32>(body + 4)) << 32) | readLE<quint32>(body + 8);
+        const quint32 capturedLength = readLE<quint32>(body + 12);
+        if (interfaceId >= quint32(m_interfaces.size()) || 20 + qint64(capturedLength) > bodyLength) {
+            setError(QString("pcapng 数据包块无效 (偏移 %1)").arg(m_pos - totalLength));
+            return false;
+        }
+        const Interface &iface = m_interfaces.at(static_cast<int>(interfaceId));
+
+        // 默认视为接收；epb_flags 标记为发送时改为 Tx
+        CaptureWriter::RecordType direction = CaptureWriter::RecordType::Rx;
+        qint64 pos = 20 + paddedTo4(capturedLength);
+        while (pos + 4 <= bodyLength) {
+            const quint16 code = readLE<quint16>(body + pos);
+            const quint16 optionLength = readLE<quint16>(body + pos + 2);
+            pos += 4;
+            if (code == kPcapOptEnd || pos + optionLength > bodyLength) break;
+            if (code == kPcapOptEpbFlags && optionLength >= 4) {
+                if ((readLE<quint32>(body + pos) & kPcapFlagDirectionMask) == kPcapFlagOutbound) {
+                    direction = CaptureWriter::RecordType::Tx;
+                }
+            }
+            pos += paddedTo4(optionLength);
+        }
+
+        const qint64 wholeTicks = static_cast<qint64>(ticks / quint64(iface.divisor));
+        const qint64 remainder = static_cast<qint64>(ticks % quint64(iface.divisor));
+        record->timestampNs = wholeTicks * iface.multiplier
+                + static_cast<qint64>(static_cast<long double>(remainder) * iface.multiplier / iface.divisor);
+        record->type = direction;
+        record->transport = iface.transport;
+        record->peer = iface.peer;
+        record->data = QByteArray(reinterpret_cast<const char *>(body + 20), capturedLength);
+        return true;
+    }
+    return false;
+}
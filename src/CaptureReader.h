@@ -0,0 +1,71 @@
+#ifndef CAPTUREREADER_H
+#define CAPTUREREADER_H
+
+#include "CaptureWriter.h"
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+// 抓包文件中的一条收发记录
+struct CaptureRecord {
+    qint64 timestampNs = 0;  // 只有记录之间的差值有意义
+    CaptureWriter::RecordType type = CaptureWriter::RecordType::Rx;
+    CaptureWriter::Transport transport = CaptureWriter::Transport::Serial;
+    QString peer;
+    QByteArray data;
+};
+
+// 顺序读取 CaptureWriter 生成的抓包文件 (原生 .nxcap 或 pcapng)。
+// 文件整体映射到内存，对端定义 / 接口描述块在读到时解析，readNext() 只返回收发记录。
+class CaptureReader {
+public:
+    CaptureReader();
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader &) = delete;
+    CaptureReader &operator=(const CaptureReader &) = delete;
+
+    bool open(const QString &filePath);
+    void close();
+    // 回到第一条记录
+    void rewind();
+
+    // 读取下一条收发记录；到达文件末尾或文件损坏时返回 false，后者可通过 errorString() 查看
+    bool readNext(CaptureRecord *record);
+
+    CaptureWriter::Format format() const { return m_format; }
+    QString errorString() const { return m_error; }
+    qint64 fileSize() const { return m_size; }
+    qint64 position() const { return m_pos; }
+
+private:
+    // pcapng 接口：对端描述和时间戳精度 (纳秒 = 刻度 * multiplier / divisor)
+    struct Interface {
+        CaptureWriter::Transport transport = CaptureWriter::Transport::Serial;
+        QString peer;
+        qint64 multiplier = 1000; // 默认精度为微秒
+        qint64 divisor = 1;
+    };
+
+    bool readNextNative(CaptureRecord *record);
+    bool readNextPcapNg(CaptureRecord *record);
+    bool parseInterfaceBlock(const uchar *body, qint64 length);
+    void setError(const QString &error);
+    static void splitPeerDescription(const QString &description, CaptureWriter::Transport *transport, QString *peer);
+
+private:
+    QFile m_file;
+    const uchar *m_map;
+    qint64 m_size;
+    qint64 m_pos;
+    qint64 m_dataStart;
+    CaptureWriter::Format m_format;
+    QString m_error;
+
+    QHash<quint16, QString> m_nativePeers;  // 原生格式：对端编号 -> 描述
+    QVector<Interface> m_interfaces;        // pcapng：接口编号 -> 接口
+};
+
+#endif // CAPTUREREADER_H
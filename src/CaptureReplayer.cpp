@@ -0,0 +1,93 @@
+#include "CaptureReplayer.h"
+#include "CaptureReader.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <QDebug>
+
+namespace {
+constexpr int kProgressIntervalMs = 100;
+constexpr int kStopPollMs = 50;            // 等待期间检查停止请求的间隔
+constexpr qint64 kSpinThresholdNs = 2000000; // 剩余不足 2 ms 时改为让出时间片，避免 sleep 过头
+}
+
+CaptureReplayer::CaptureReplayer(QObject *parent)
+    : QObject(parent)
+    , m_stopRequested(false)
+{
+}
+
+CaptureReplayer::~CaptureReplayer() {
+}
+
+void CaptureReplayer::requestStop() {
+    m_stopRequested.store(true, std::memory_order_release);
+}
+
+void CaptureReplayer::packetConsumed() {
+    m_credits.release();
+}
+
+void CaptureReplayer::startReplay(const QString &filePath, CaptureReplayer::Timing timing, double speed,
+                                  const CaptureReplayer::Filter &filter) {
+    m_stopRequested.store(false, std::memory_order_release);
+    m_credits.tryAcquire(m_credits.available());
+    m_credits.release(kMaxInFlight);
+
+    CaptureReader reader;
+    if (!reader.open(filePath)) {
+        emit replayFinished(0, 0, 0, reader.errorString());
+        return;
+    }
+    if (timing == Timing::Original || speed <= 0.0) {
+        speed = 1.0;
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    qint64 firstTimestamp = -1;
+    qint64 records = 0;
+    qint64 bytes = 0;
+    qint64 lastProgressMs = 0;
+    CaptureRecord record;
+
+    while (!m_stopRequested.load(std::memory_order_acquire) && reader.readNext(&record)) {
+        if (record.type != filter.type) continue;
+        if (!filter.anyTransport && record.transport != filter.transport) continue;
+        if (!filter.peer.isEmpty() && record.peer != filter.peer) continue;
+
+        if (timing != Timing::MaxSpeed) {
+            if (firstTimestamp < 0) firstTimestamp = record.timestampNs;
+            const qint64 dueNs = static_cast<qint64>((record.timestampNs - firstTimestamp) / speed);
+            // 先粗粒度休眠，最后 2 ms 让出时间片，兼顾精度和 CPU 占用
+            forever {
+                const qint64 remainingNs = dueNs - clock.nsecsElapsed();
+                if (remainingNs <= 0 || m_stopRequested.load(std::memory_order_acquire)) break;
+                if (remainingNs > kSpinThresholdNs) {
+                    const qint64 sleepUs = qMin<qint64>((remainingNs - kSpinThresholdNs / 2) / 1000, kStopPollMs * 1000);
+                    QThread::usleep(static_cast<unsigned long>(sleepUs));
+                } else {
+                    QThread::yieldCurrentThread();
+                }
+            }
+        }
+
+        // 接收方处理不过来时在此等待
+        bool acquired = false;
+        while (!(acquired = m_credits.tryAcquire(1, kStopPollMs))) {
+            if (m_stopRequested.load(std::memory_order_acquire)) break;
+        }
+        if (!acquired) break;
+
+        emit packetReady(record.data, record.peer);
+        ++records;
+        bytes += record.data.size();
+
+        const qint64 nowMs = clock.elapsed();
+        if (nowMs - lastProgressMs >= kProgressIntervalMs) {
+            lastProgressMs = nowMs;
+            emit progress(records, bytes, static_cast<int>(reader.position() * 100 / qMax<qint64>(reader.fileSize(), 1)));
+        }
+    }
+
+    emit replayFinished(records, bytes, clock.nsecsElapsed(), reader.errorString());
+}
@@ -0,0 +1,54 @@
+#ifndef CAPTUREREPLAYER_H
+#define CAPTUREREPLAYER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QSemaphore>
+#include <QString>
+#include <atomic>
+#include "CaptureWriter.h"
+
+// 抓包回放工作者，运行在独立线程中。按原始时间间隔、缩放后的间隔或最快速度
+// 逐条发出 packetReady()，由接收方决定注入到哪个传输通道或本地处理流程。
+//
+// 接收方处理完一个数据包后必须调用 packetConsumed()。未确认的数据包最多 kMaxInFlight 个，
+// 最快速度回放时以此形成背压，回放速度等于接收方的实际处理能力。
+class CaptureReplayer : public QObject {
+    Q_OBJECT
+
+public:
+    enum class Timing { Original, Scaled, MaxSpeed };
+
+    static constexpr int kMaxInFlight = 256;
+
+    // 只回放符合条件的记录。混合抓包 (串口、UDP、多个服务器客户端) 中通常只需要其中一条流
+    struct Filter {
+        CaptureWriter::RecordType type = CaptureWriter::RecordType::Rx;
+        bool anyTransport = false;
+        CaptureWriter::Transport transport = CaptureWriter::Transport::Serial; // anyTransport 为 false 时有效
+        QString peer;                                                         // 为空表示所有对端
+    };
+
+    explicit CaptureReplayer(QObject *parent = nullptr);
+    ~CaptureReplayer() override;
+
+    // 以下两个函数可在任意线程调用
+    void requestStop();
+    void packetConsumed();
+
+public slots:
+    // speed 只对 Timing::Scaled 有效，例如 2.0 表示两倍速；只回放符合 filter 的记录
+    void startReplay(const QString &filePath, CaptureReplayer::Timing timing, double speed,
+                     const CaptureReplayer::Filter &filter);
+
+signals:
+    void packetReady(const QByteArray &data, const QString &peer);
+    void progress(qint64 records, qint64 bytes, int percent);
+    void replayFinished(qint64 records, qint64 bytes, qint64 elapsedNs, const QString &errorText);
+
+private:
+    std::atomic<bool> m_stopRequested;
+    QSemaphore m_credits;
+};
+
+#endif // CAPTUREREPLAYER_H
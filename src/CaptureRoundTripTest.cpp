@@ -0,0 +1,248 @@
+// CaptureWriter 写出、CaptureReader 读回的往返测试 (.nxcap 和 pcapng 两种格式)：
+// 传输方式、对端、方向、数据逐条一致，时间戳单调且落在录制期间；
+// 手工构造的 pcapng 检查 if_tsresol 的 10^-n 和 2^-n 精度换算；文件末尾被截断时忽略残缺的记录而不报错。
+#include "CaptureReader.h"
+#include "CaptureWriter.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QTemporaryDir>
+#include <QTest>
+#include <QtEndian>
+
+namespace {
+constexpr qint64 kNsPerMs = 1000000;
+constexpr int kSleepMs = 5;
+
+struct Sample {
+    CaptureWriter::Transport transport;
+    CaptureWriter::RecordType type;
+    QString peer;
+    QByteArray data;
+};
+
+QList<Sample> samples() {
+    using T = CaptureWriter::Transport;
+    using R = CaptureWriter::RecordType;
+    return {
+        { T::Serial, R::Rx, "/dev/ttyUSB0", "hello" },
+        { T::Serial, R::Tx, "/dev/ttyUSB0", QByteArray("\0\x01\x02", 3) },
+        { T::TcpClient, R::Tx, "192.168.1.10:502", QByteArray(1000, 'x') },
+        { T::TcpServer, R::Rx, "127.0.0.1:40000", QByteArray() },
+        { T::Udp, R::Rx, "10.0.0.2:6000", "datagram" },
+        { T::TcpServer, R::Tx, "127.0.0.1:40001", "ack" },
+        { T::Serial, R::Rx, "/dev/ttyUSB0", "tail-rec" }, // 最后一条留给截断测试
+    };
+}
+
+void addFormatRows() {
+    QTest::addColumn<bool>("pcapng");
+    QTest::newRow("nxcap") << false;
+    QTest::newRow("pcapng") << true;
+}
+
+// 写入全部样本，第一条之后停顿 kSleepMs，用来检查时间戳间隔
+bool writeSamples(const QString &path, bool pcapng) {
+    CaptureWriter writer;
+    if (!writer.start(path, pcapng ? CaptureWriter::Format::PcapNg : CaptureWriter::Format::Native)) return false;
+    const QList<Sample> all = samples();
+    for (int i = 0; i < all.size(); ++i) {
+        writer.record(all[i].transport, all[i].type, all[i].peer, all[i].data);
+        if (i == 0) QTest::qSleep(kSleepMs);
+    }
+    writer.stop();
+    return writer.droppedRecords() == 0 && writer.errorString().isEmpty();
+}
+
+QList<CaptureRecord> readAll(CaptureReader *reader) {
+    QList<CaptureRecord> records;
+    CaptureRecord record;
+    while (reader->readNext(&record)) {
+        records.append(record);
+    }
+    return records;
+}
+
+void verifyRecord(const CaptureRecord &record, const Sample &sample, int index) {
+    QVERIFY2(record.transport == sample.transport, qPrintable(QString("record %1 transport").arg(index)));
+    QVERIFY2(record.type == sample.type, qPrintable(QString("record %1 direction").arg(index)));
+    QCOMPARE(record.peer, sample.peer);
+    QCOMPARE(record.data, sample.data);
+}
+
+// 手工构造 pcapng (小端)
+template <typename T>
+void appendLE(QByteArray &buffer, T value) {
+    value = qToLittleEndian(value);
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void appendOption(QByteArray &body, quint16 code, const QByteArray &value) {
+    appendLE<quint16>(body, code);
+    appendLE<quint16>(body, static_cast<quint16>(value.size()));
+    body.append(value);
+    body.append((4 - value.size() % 4) % 4, '\0');
+}
+
+void appendBlock(QByteArray &file, quint32 type, const QByteArray &body) {
+    appendLE<quint32>(file, type);
+    appendLE<quint32>(file, static_cast<quint32>(12 + body.size()));
+    file.append(body);
+    appendLE<quint32>(file, static_cast<quint32>(12 + body.size()));
+}
+
+// tsresol < 0 表示不写 if_tsresol 选项 (默认微秒)
+void appendInterface(QByteArray &file, const QByteArray &name, int tsresol) {
+    QByteArray body;
+    appendLE<quint16>(body, 147); // LINKTYPE_USER0
+    appendLE<quint16>(body, 0);
+    appendLE<quint32>(body, 0);
+    appendOption(body, 2, name);
+    if (tsresol >= 0) appendOption(body, 9, QByteArray(1, static_cast<char>(tsresol)));
+    appendOption(body, 0, QByteArray());
+    appendBlock(file, 1, body);
+}
+
+void appendPacket(QByteArray &file, quint32 interfaceId, quint64 ticks, const QByteArray &data) {
+    QByteArray body;
+    appendLE<quint32>(body, interfaceId);
+    appendLE<quint32>(body, static_cast<quint32>(ticks >> 32));
+    appendLE<quint32>(body, static_cast<quint32>(ticks & 0xFFFFFFFFu));
+    appendLE<quint32>(body, static_cast<quint32>(data.size()));
+    appendLE<quint32>(body, static_cast<quint32>(data.size()));
+    body.append(data);
+    body.append((4 - data.size() % 4) % 4, '\0');
+    appendBlock(file, 6, body);
+}
+}
+
+class CaptureRoundTripTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data() { addFormatRows(); }
+    void roundTrip();
+    void truncatedTail_data() { addFormatRows(); }
+    void truncatedTail();
+    void pcapNgTimestampResolution();
+};
+
+void CaptureRoundTripTest::roundTrip() {
+    QFETCH(bool, pcapng);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(pcapng ? "capture.pcapng" : "capture.nxcap");
+
+    // 原生格式的时间戳相对于开始录制，pcapng 是 UTC 纳秒
+    QElapsedTimer elapsed;
+    elapsed.start();
+    const qint64 beforeUtcNs = QDateTime::currentMSecsSinceEpoch() * kNsPerMs;
+    QVERIFY(writeSamples(path, pcapng));
+    const qint64 afterUtcNs = (QDateTime::currentMSecsSinceEpoch() + 1) * kNsPerMs;
+    const qint64 elapsedNs = elapsed.nsecsElapsed();
+
+    CaptureReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.errorString()));
+    QVERIFY(reader.format() == (pcapng ? CaptureWriter::Format::PcapNg : CaptureWriter::Format::Native));
+    const QList<CaptureRecord> records = readAll(&reader);
+    QVERIFY(reader.errorString().isEmpty());
+    const QList<Sample> expected = samples();
+    QCOMPARE(records.size(), expected.size());
+
+    for (int i = 0; i < records.size(); ++i) {
+        verifyRecord(records[i], expected[i], i);
+        if (pcapng) {
+            QVERIFY(records[i].timestampNs >= beforeUtcNs && records[i].timestampNs <= afterUtcNs);
+        } else {
+            QVERIFY(records[i].timestampNs >= 0 && records[i].timestampNs <= elapsedNs);
+        }
+        if (i > 0) QVERIFY(records[i].timestampNs >= records[i - 1].timestampNs);
+    }
+    QVERIFY(records[1].timestampNs - records[0].timestampNs >= kSleepMs * kNsPerMs);
+
+    // rewind 后重新解析对端定义，结果相同
+    reader.rewind();
+    const QList<CaptureRecord> again = readAll(&reader);
+    QCOMPARE(again.size(), records.size());
+    for (int i = 0; i < again.size(); ++i) {
+        verifyRecord(again[i], expected[i], i);
+        QCOMPARE(again[i].timestampNs, records[i].timestampNs);
+    }
+}
+
+void CaptureRoundTripTest::truncatedTail() {
+    QFETCH(bool, pcapng);
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(pcapng ? "capture.pcapng" : "capture.nxcap");
+    QVERIFY(writeSamples(path, pcapng));
+
+    // 截掉最后一条记录的末尾几个字节 (pcapng 是块尾长度，原生格式是数据)
+    const qint64 size = QFileInfo(path).size();
+    QVERIFY(QFile::resize(path, size - 3));
+
+    CaptureReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.errorString()));
+    const QList<CaptureRecord> records = readAll(&reader);
+    QVERIFY2(reader.errorString().isEmpty(), qPrintable(reader.errorString()));
+    const QList<Sample> expected = samples();
+    QCOMPARE(records.size(), expected.size() - 1);
+    for (int i = 0; i < records.size(); ++i) {
+        verifyRecord(records[i], expected[i], i);
+    }
+    CaptureRecord record;
+    QVERIFY(!reader.readNext(&record));
+}
+
+void CaptureRoundTripTest::pcapNgTimestampResolution() {
+    QByteArray file;
+    QByteArray shb;
+    appendLE<quint32>(shb, 0x1A2B3C4D);
+    appendLE<quint16>(shb, 1);
+    appendLE<quint16>(shb, 0);
+    appendLE<qint64>(shb, -1);
+    appendBlock(file, 0x0A0D0D0A, shb);
+
+    appendInterface(file, "udp 10.0.0.1:5000", 0x80 | 10);  // 2^-10 秒
+    appendInterface(file, "serial COM3", 3);                // 10^-3 秒
+    appendInterface(file, "tcp 192.168.0.5:80", -1);        // 默认 10^-6 秒
+    appendInterface(file, "tcp-server 0.0.0.0:9000", 0x80 | 30);
+    appendPacket(file, 0, 3 * 1024 + 512, "a");              // 3.5 秒
+    appendPacket(file, 1, 1234, "bc");                       // 1.234 秒
+    appendPacket(file, 2, 5000001, "def");                   // 5.000001 秒
+    appendPacket(file, 3, (quint64(7) << 30) + (quint64(1) << 28), "ghij"); // 7.25 秒
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath("resolution.pcapng");
+    QFile out(path);
+    QVERIFY(out.open(QIODevice::WriteOnly));
+    QCOMPARE(out.write(file), qint64(file.size()));
+    out.close();
+
+    CaptureReader reader;
+    QVERIFY2(reader.open(path), qPrintable(reader.errorString()));
+    const QList<CaptureRecord> records = readAll(&reader);
+    QVERIFY(reader.errorString().isEmpty());
+    QCOMPARE(records.size(), qsizetype(4));
+
+    QCOMPARE(records[0].timestampNs, qint64(3500000000));
+    QVERIFY(records[0].transport == CaptureWriter::Transport::Udp);
+    QCOMPARE(records[0].peer, QString("10.0.0.1:5000"));
+    QCOMPARE(records[1].timestampNs, qint64(1234000000));
+    QVERIFY(records[1].transport == CaptureWriter::Transport::Serial);
+    QCOMPARE(records[1].peer, QString("COM3"));
+    QCOMPARE(records[2].timestampNs, qint64(5000001000));
+    QVERIFY(records[2].transport == CaptureWriter::Transport::TcpClient);
+    QCOMPARE(records[3].timestampNs, qint64(7250000000));
+    QVERIFY(records[3].transport == CaptureWriter::Transport::TcpServer);
+    QCOMPARE(records[3].peer, QString("0.0.0.0:9000"));
+    // 没有 epb_flags 时视为接收
+    for (const CaptureRecord &record : records) {
+        QVERIFY(record.type == CaptureWriter::RecordType::Rx);
+    }
+    QCOMPARE(records[3].data, QByteArray("ghij"));
+}
+
+QTEST_APPLESS_MAIN(CaptureRoundTripTest)
+#include "CaptureRoundTripTest.moc"
@@ -0,0 +1,284 @@
+#include "CaptureWriter.h"
+#include <QDateTime>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtEndian>
+#include <QDebug>
+
+namespace {
+constexpr qsizetype kInitialBufferBytes = 4 * 1024 * 1024;
+constexpr qsizetype kMaxPendingBytes = 512 * 1024 * 1024; // 磁盘跟不上时最多积压的数据量，超出后丢弃并计数
+constexpr quint16 kUnknownPeerId = 0xFFFF;
+
+// pcapng 常量
+constexpr quint32 kPcapSectionHeader = 0x0A0D0D0A;
+constexpr quint32 kPcapInterfaceDescription = 0x00000001;
+constexpr quint32 kPcapEnhancedPacket = 0x00000006;
+constexpr quint32 kPcapByteOrderMagic = 0x1A2B3C4D;
+constexpr quint16 kPcapLinkTypeUser0 = 147;
+constexpr quint16 kPcapOptEnd = 0;
+constexpr quint16 kPcapOptIfName = 2;
+constexpr quint16 kPcapOptIfTsResol = 9;
+constexpr quint16 kPcapOptShbUserAppl = 4;
+constexpr quint16 kPcapOptEpbFlags = 2;
+constexpr quint32 kPcapFlagInbound = 1;
+constexpr quint32 kPcapFlagOutbound = 2;
+
+template <typename T>
+void appendLE(QByteArray &buffer, T value) {
+    value = qToLittleEndian(value);
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+qsizetype paddedTo4(qsizetype length) {
+    return (length + 3) & ~qsizetype(3);
+}
+
+void appendPadding(QByteArray &buffer, qsizetype length) {
+    buffer.append(paddedTo4(length) - length, '\0');
+}
+
+void appendPcapOption(QByteArray &buffer, quint16 code, const QByteArray &value) {
+    appendLE<quint16>(buffer, code);
+    appendLE<quint16>(buffer, static_cast<quint16>(value.size()));
+    buffer.append(value);
+    appendPadding(buffer, value.size());
+}
+
+// 先写入块内容，再回填首尾的块长度
+void appendPcapBlock(QByteArray &buffer, quint32 type, const QByteArray &body) {
+    const quint32 totalLength = static_cast<quint32>(12 + body.size());
+    appendLE<quint32>(buffer, type);
+    appendLE<quint32>(buffer, totalLength);
+    buffer.append(body);
+    appendLE<quint32>(buffer, totalLength);
+}
+}
+
+CaptureWriter::CaptureWriter()
+    : m_format(Format::Native)
+    , m_thread(nullptr)
+    , m_startUtcNs(0)
+    , m_lastTransport(Transport::Serial)
+    , m_lastPeerId(kUnknownPeerId)
+    , m_stopRequested(false)
+    , m_active(false)
+    , m_bytesWritten(0)
+    , m_droppedRecords(0)
+{
+}
+
+CaptureWriter::~CaptureWriter() {
+    stop();
+}
+
+QString CaptureWriter::transportName(Transport transport) {
+    switch (transport) {
+    case Transport::Serial: return QStringLiteral("serial");
+    case Transport::TcpClient: return QStringLiteral("tcp");
+    case Transport::TcpServer: return QStringLiteral("tcp-server");
+    case Transport::Udp: return QStringLiteral("udp");
+    }
+    return QStringLiteral("unknown");
+}
+
+bool CaptureWriter::start(const QString &filePath, Format format) {
+    stop();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMutexLocker locker(&m_mutex);
+        m_error = m_file.errorString();
+        qWarning() << "[Capture] 无法创建抓包文件:" << m_error;
+        return false;
+    }
+
+    m_format = format;
+    m_peerIds.clear();
+    m_lastPeer.clear();
+    m_lastPeerId = kUnknownPeerId;
+    m_pending.clear();
+    m_pending.reserve(kInitialBufferBytes);
+    m_stopRequested = false;
+    m_error.clear();
+    m_bytesWritten.store(0, std::memory_order_relaxed);
+    m_droppedRecords.store(0, std::memory_order_relaxed);
+
+    m_startUtcNs = QDateTime::currentMSecsSinceEpoch() * 1000000;
+    m_clock.start();
+
+    if (m_format == Format::Native) {
+        m_pending.append("NXCP", 4);
+        appendLE<quint16>(m_pending, kNativeVersion);
+        appendLE<quint16>(m_pending, 0);
+        appendLE<qint64>(m_pending, m_startUtcNs);
+    } else {
+        QByteArray body;
+        appendLE<quint32>(body, kPcapByteOrderMagic);
+        appendLE<quint16>(body, 1); // major
+        appendLE<quint16>(body, 0); // minor
+        appendLE<qint64>(body, -1); // section length 未知
+        appendPcapOption(body, kPcapOptShbUserAppl, QByteArrayLiteral("NexusTerm"));
+        appendPcapOption(body, kPcapOptEnd, QByteArray());
+        appendPcapBlock(m_pending, kPcapSectionHeader, body);
+    }
+
+    m_thread = QThread::create([this]() { writerLoop(); });
+    m_thread->start();
+    m_active.store(true, std::memory_order_release);
+    return true;
+}
+
+void CaptureWriter::stop() {
+    if (!m_thread) return;
+
+    m_active.store(false, std::memory_order_release);
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_dataAvailable.wakeOne();
+    }
+    // 后台线程写完积压的数据后退出
+    m_thread->wait();
+    delete m_thread;
+    m_thread = nullptr;
+    m_file.close();
+
+    const quint64 dropped = m_droppedRecords.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        qWarning() << "[Capture] 磁盘写入跟不上，丢弃了" << dropped << "条记录";
+    }
+}
+
+QString CaptureWriter::errorString() const {
+    QMutexLocker locker(&m_mutex);
+    return m_error;
+}
+
+void CaptureWriter::record(Transport transport, RecordType type, const QString &peer, const QByteArray &data) {
+    if (!isActive()) return;
+    const qint64 timestampNs = m_clock.nsecsElapsed();
+
+    QMutexLocker locker(&m_mutex);
+    if (m_stopRequested) return;
+    // 记录头、对端定义和 pcapng 填充的开销远小于 256 字节
+    if (m_pending.size() + data.size() + 256 > kMaxPendingBytes) {
+        m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const quint16 peerId = peerIdLocked(transport, peer, timestampNs);
+    appendRecordLocked(transport, type, peerId, timestampNs, data.constData(), data.size());
+    m_dataAvailable.wakeOne();
+}
+
+quint16 CaptureWriter::peerIdLocked(Transport transport, const QString &peer, qint64 timestampNs) {
+    // 连续的记录通常来自同一个对端，命中时省去拼接键和查表
+    if (m_lastPeerId != kUnknownPeerId && transport == m_lastTransport && peer == m_lastPeer) {
+        return m_lastPeerId;
+    }
+    const quint16 peerId = lookupPeerLocked(transport, peer, timestampNs);
+    m_lastTransport = transport;
+    m_lastPeer = peer;
+    m_lastPeerId = peerId;
+    return peerId;
+}
+
+quint16 CaptureWriter::lookupPeerLocked(Transport transport, const QString &peer, qint64 timestampNs) {
+    const QString key = QString::number(static_cast<int>(transport)) + QLatin1Char('|') + peer;
+    auto it = m_peerIds.constFind(key);
+    if (it != m_peerIds.constEnd()) {
+        return it.value();
+    }
+    if (m_peerIds.size() >= kUnknownPeerId) {
+        return kUnknownPeerId;
+    }
+
+    const quint16 peerId = static_cast<quint16>(m_peerIds.size());
+    m_peerIds.insert(key, peerId);
+
+    const QByteArray description = (transportName(transport) + QLatin1Char(' ') + peer).toUtf8();
+    if (m_format == Format::Native) {
+        appendRecordLocked(transport, RecordType::PeerInfo, peerId, timestampNs,
+                           description.constData(), description.size());
+    } else {
+        // pcapng 的接口编号按 IDB 出现顺序分配，与 peerId 一致
+        QByteArray body;
+        appendLE<quint16>(body, kPcapLinkTypeUser0);
+        appendLE<quint16>(body, 0);
+        appendLE<quint32>(body, 0); // snaplen 不限
+        appendPcapOption(body, kPcapOptIfName, description);
+        appendPcapOption(body, kPcapOptIfTsResol, QByteArray(1, char(9))); // 10^-9 秒
+        appendPcapOption(body, kPcapOptEnd, QByteArray());
+        appendPcapBlock(m_pending, kPcapInterfaceDescription, body);
+    }
+    return peerId;
+}
+
+void CaptureWriter::appendRecordLocked(Transport transport, RecordType type, quint16 peerId,
+                                       qint64 timestampNs, const char *data, qsizetype size) {
+    if (m_format == Format::Native) {
+        appendLE<quint64>(m_pending, static_cast<quint64>(timestampNs));
+        appendLE<quint32>(m_pending, static_cast<quint32>(size));
+        m_pending.append(static_cast<char>(type));
+        m_pending.append(static_cast<char>(transport));
+        appendLE<quint16>(m_pending, peerId);
+        m_pending.append(data, size);
+        return;
+    }
+
+    if (peerId == kUnknownPeerId) {
+        m_droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    const quint64 absoluteNs = static_cast<quint64>(m_startUtcNs + timestampNs);
+    const quint32 totalLength = static_cast<quint32>(28 + paddedTo4(size) + 12 + 4);
+    appendLE<quint32>(m_pending, kPcapEnhancedPacket);
+    appendLE<quint32>(m_pending, totalLength);
+    appendLE<quint32>(m_pending, peerId);
+    appendLE<quint32>(m_pending, static_cast<quint32>(absoluteNs >> 32));
+    appendLE<quint32>(m_pending, static_cast<quint32>(absoluteNs & 0xFFFFFFFFu));
+    appendLE<quint32>(m_pending, static_cast<quint32>(size)); // captured length
+    appendLE<quint32>(m_pending, static_cast<quint32>(size)); // original length
+    m_pending.append(data, size);
+    appendPadding(m_pending, size);
+    appendLE<quint16>(m_pending, kPcapOptEpbFlags);
+    appendLE<quint16>(m_pending, 4);
+    appendLE<quint32>(m_pending, type == RecordType::Rx ? kPcapFlagInbound : kPcapFlagOutbound);
+    appendLE<quint16>(m_pending, kPcapOptEnd);
+    appendLE<quint16>(m_pending, 0);
+    appendLE<quint32>(m_pending, totalLength);
+}
+
+void CaptureWriter::writerLoop() {
+    // 双缓冲：持锁时只交换缓冲区，写盘时不持锁
+    QByteArray writing;
+    writing.reserve(kInitialBufferBytes);
+    bool failed = false;
+
+    forever {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (m_pending.isEmpty() && !m_stopRequested) {
+                m_dataAvailable.wait(&m_mutex);
+            }
+            if (m_pending.isEmpty()) {
+                break; // 已请求停止且没有剩余数据
+            }
+            writing.swap(m_pending);
+        }
+
+        if (!failed) {
+            if (m_file.write(writing) != writing.size()) {
+                failed = true;
+                m_active.store(false, std::memory_order_release);
+                QMutexLocker locker(&m_mutex);
+                m_error = m_file.errorString();
+                qWarning() << "[Capture] 写入抓包文件失败:" << m_error;
+            } else {
+                m_bytesWritten.fetch_add(writing.size(), std::memory_order_relaxed);
+            }
+        }
+        writing.resize(0); // 保留容量，下次交换后继续复用
+    }
+    m_file.flush();
+}
@@ -0,0 +1,82 @@
+#ifndef CAPTUREWRITER_H
+#define CAPTUREWRITER_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <atomic>
+
+class QThread;
+
+// 收发数据抓包。record() 只在调用线程里把记录追加到内存缓冲区，
+// 磁盘写入由后台线程完成，因此抓包不会阻塞接收路径。
+//
+// 原生格式 (.nxcap，小端)：
+//   文件头 16 字节: "NXCP" 版本(u16) 保留(u16) 开始时间(i64, UTC 纳秒)
+//   记录头 16 字节: 时间戳(u64, 相对开始时间的单调纳秒) 长度(u32) 类型(u8) 传输方式(u8) 对端编号(u16)
+//   记录头后紧跟 长度 字节的数据。类型为 PeerInfo 的记录在某个对端首次出现时写入，
+//   数据是对端描述 (UTF-8)，之后的收发记录只引用对端编号。
+// pcapng 格式：每个 (传输方式, 对端) 对应一个接口 (LINKTYPE_USER0，纳秒精度)，
+//   方向写在 EPB 的 epb_flags 选项中，可以直接用 Wireshark 打开。
+class CaptureWriter {
+public:
+    enum class Format { Native, PcapNg };
+    enum class Transport : quint8 { Serial = 0, TcpClient = 1, TcpServer = 2, Udp = 3 };
+    enum class RecordType : quint8 { Rx = 0, Tx = 1, PeerInfo = 2 };
+
+    static constexpr quint16 kNativeVersion = 1;
+
+    CaptureWriter();
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter &) = delete;
+    CaptureWriter &operator=(const CaptureWriter &) = delete;
+
+    bool start(const QString &filePath, Format format);
+    void stop();
+    bool isActive() const { return m_active.load(std::memory_order_acquire); }
+
+    // 线程安全。type 只能是 Rx 或 Tx
+    void record(Transport transport, RecordType type, const QString &peer, const QByteArray &data);
+
+    QString filePath() const { return m_file.fileName(); }
+    QString errorString() const;
+    qint64 bytesWritten() const { return m_bytesWritten.load(std::memory_order_relaxed); }
+    quint64 droppedRecords() const { return m_droppedRecords.load(std::memory_order_relaxed); }
+
+    static QString transportName(Transport transport);
+
+private:
+    void writerLoop();
+    quint16 peerIdLocked(Transport transport, const QString &peer, qint64 timestampNs);
+    quint16 lookupPeerLocked(Transport transport, const QString &peer, qint64 timestampNs);
+    void appendRecordLocked(Transport transport, RecordType type, quint16 peerId,
+                            qint64 timestampNs, const char *data, qsizetype size);
+
+private:
+    QFile m_file;
+    Format m_format;
+    QThread *m_thread;
+    QElapsedTimer m_clock;       // 单调时钟，记录时间戳相对于开始时刻
+    qint64 m_startUtcNs;
+
+    mutable QMutex m_mutex;      // 保护以下成员
+    QWaitCondition m_dataAvailable;
+    QByteArray m_pending;        // 等待后台线程写入的数据
+    QHash<QString, quint16> m_peerIds; // 键: 传输方式 + 对端描述
+    Transport m_lastTransport;
+    QString m_lastPeer;
+    quint16 m_lastPeerId;
+    bool m_stopRequested;
+    QString m_error;
+
+    std::atomic<bool> m_active;
+    std::atomic<qint64> m_bytesWritten;
+    std::atomic<quint64> m_droppedRecords;
+};
+
+#endif // CAPTUREWRITER_H
@@ -0,0 +1,299 @@
+#include "CliEndpoint.h"
+#include "SerialManager.h"
+#include "TcpManager.h"
+#include "TcpServerManager.h"
+#include "QtUdpManager.h"
+#ifdef Q_OS_WIN
+#include "WinSockUdpManager.h"
+#endif
+#ifdef Q_OS_LINUX
+#include "LinuxUdpManager.h"
+#include "LinuxTcpServerManager.h"
+#endif
+#include <QStringList>
+#include <QTimer>
+
+namespace {
+constexpr qint32 kDefaultBaudRate = 115200;
+
+bool parsePort(const QString &text, quint16 *port) {
+    bool ok = false;
+    const uint value = text.toUInt(&ok);
+    if (!ok || value == 0 || value > 65535) return false;
+    *port = static_cast<quint16>(value);
+    return true;
+}
+}
+
+CliEndpoint::CliEndpoint(CaptureWriter::Transport transport, const QString &spec, QObject *parent)
+    : QObject(parent)
+    , m_transport(transport)
+    , m_spec(spec)
+    , m_udpBackend(UdpBackend::Qt)
+    , m_tcpServerBackend(TcpServerBackend::Qt)
+    , m_trafficStats(nullptr)
+    , m_port(0)
+    , m_bindPort(0)
+    , m_baudRate(kDefaultBaudRate)
+    , m_serialBatched(false)
+    , m_serialLowLatency(false)
+    , m_lastUdpPort(0)
+    , m_framerTimer(new QTimer(this))
+    , m_framerDeadlineNs(0)
+{
+    m_framerClock.start();
+    m_framerTimer->setSingleShot(true);
+    m_framerTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_framerTimer, &QTimer::timeout, this, &CliEndpoint::onFramerTimeout);
+}
+
+CliEndpoint::~CliEndpoint() {
+    close();
+}
+
+CliEndpoint *CliEndpoint::fromSpec(const QString &spec, UdpBackend udpBackend, QString *error, QObject *parent) {
+    const int colon = spec.indexOf(QLatin1Char(':'));
+    const QString scheme = colon >= 0 ? spec.left(colon) : spec;
+    const QString rest = colon >= 0 ? spec.mid(colon + 1) : QString();
+
+    if (scheme == "serial") {
+        const QStringList parts = rest.split(QLatin1Char(':'));
+        if (parts.isEmpty() || parts.first().isEmpty() || parts.size() > 2) {
+            *error = QString("串口端点格式应为 serial:<端口>[:<波特率>]，实际为 %1").arg(spec);
+            return nullptr;
+        }
+        std::unique_ptr<CliEndpoint> endpoint(new CliEndpoint(CaptureWriter::Transport::Serial, spec, parent));
+        endpoint->m_host = parts.at(0);
+        if (parts.size() == 2) {
+            bool ok = false;
+            endpoint->m_baudRate = parts.at(1).toInt(&ok);
+            if (!ok || endpoint->m_baudRate <= 0) {
+                *error = QString("无效的波特率: %1").arg(parts.at(1));
+                return nullptr;
+            }
+        }
+        return endpoint.release();
+    }
+
+    if (scheme == "tcp") {
+        const int portSep = rest.lastIndexOf(QLatin1Char(':'));
+        std::unique_ptr<CliEndpoint> endpoint(new CliEndpoint(CaptureWriter::Transport::TcpClient, spec, parent));
+        if (portSep <= 0 || !parsePort(rest.mid(portSep + 1), &endpoint->m_port)) {
+            *error = QString("TCP 端点格式应为 tcp:<主机>:<端口>，实际为 %1").arg(spec);
+            return nullptr;
+        }
+        endpoint->m_host = rest.left(portSep);
+        return endpoint.release();
+    }
+
+    if (scheme == "tcp-server") {
+        std::unique_ptr<CliEndpoint> endpoint(new CliEndpoint(CaptureWriter::Transport::TcpServer, spec, parent));
+        if (!parsePort(rest, &endpoint->m_port)) {
+            *error = QString("TCP 服务器端点格式应为 tcp-server:<端口>，实际为 %1").arg(spec);
+            return nullptr;
+        }
+        return endpoint.release();
+    }
+
+    if (scheme == "udp") {
+        const QStringList parts = rest.split(QLatin1Char(':'));
+        std::unique_ptr<CliEndpoint> endpoint(new CliEndpoint(CaptureWriter::Transport::Udp, spec, parent));
+        endpoint->m_udpBackend = udpBackend;
+        const bool validShape = (parts.size() == 1 || parts.size() == 3);
+        if (!validShape || !parsePort(parts.at(0), &endpoint->m_bindPort)
+                || (parts.size() == 3 && (parts.at(1).isEmpty() || !parsePort(parts.at(2), &endpoint->m_port)))) {
+            *error = QString("UDP 端点格式应为 udp:<本地端口>[:<主机>:<端口>]，实际为 %1").arg(spec);
+            return nullptr;
+        }
+        if (parts.size() == 3) {
+            endpoint->m_host = parts.at(1);
+        }
+        return endpoint.release();
+    }
+
+    *error = QString("未知的端点类型: %1 (支持 serial / tcp / tcp-server / udp)").arg(scheme);
+    return nullptr;
+}
+
+bool CliEndpoint::open() {
+    switch (m_transport) {
+    case CaptureWriter::Transport::Serial:
+        m_serial = std::make_unique<SerialManager>();
+        m_serial->setTrafficStats(m_trafficStats);
+        m_serial->setReadMode(m_serialBatched ? SerialManager::ReadMode::Batched : SerialManager::ReadMode::LowLatency);
+        m_serial->setLowLatency(m_serialLowLatency);
+        connect(m_serial.get(), &SerialManager::portOpened, this, &CliEndpoint::opened);
+        connect(m_serial.get(), &SerialManager::portClosed, this, [this]() {
+            flushAllFramers();
+            emit closed();
+        });
+        connect(m_serial.get(), &SerialManager::errorOccurred, this, [this](const QString &errorText) {
+            if (!errorText.isEmpty()) emit errorOccurred(errorText);
+        });
+        connect(m_serial.get(), &SerialManager::dataReceived, this, [this](const QByteArray &data) {
+            onStreamData(data, m_host);
+        });
+        m_serial->openPort(m_host, m_baudRate, QSerialPort::Data8, QSerialPort::NoParity, QSerialPort::OneStop);
+        return m_serial->isOpen();
+
+    case CaptureWriter::Transport::TcpClient:
+        m_tcp = std::make_unique<TcpManager>();
+        m_tcp->setTrafficStats(m_trafficStats);
+        connect(m_tcp.get(), &TcpManager::connected, this, &CliEndpoint::opened);
+        connect(m_tcp.get(), &TcpManager::disconnected, this, [this]() {
+            flushAllFramers();
+            emit closed();
+        });
+        connect(m_tcp.get(), &TcpManager::errorOccurred, this, [this](const QString &errorText) {
+            if (!errorText.isEmpty()) emit errorOccurred(errorText);
+        });
+        connect(m_tcp.get(), &TcpManager::dataReceived, this, [this](const QByteArray &data) {
+            onStreamData(data, QString("%1:%2").arg(m_host).arg(m_port));
+        });
+        // 连接是异步的，结果通过 opened() / errorOccurred() 通知
+        m_tcp->connectToServer(m_host, m_port);
+        return true;
+
+    case CaptureWriter::Transport::TcpServer:
+#if defined(Q_OS_LINUX)
+        if (m_tcpServerBackend == TcpServerBackend::Epoll) {
+            m_tcpServer = std::make_unique<LinuxTcpServerManager>();
+        } else {
+            m_tcpServer = std::make_unique<TcpServerManager>();
+        }
+#else
+        m_tcpServer = std::make_unique<TcpServerManager>();
+#endif
+        m_tcpServer->setTrafficStats(m_trafficStats);
+        connect(m_tcpServer.get(), &ITcpServerManager::dataReceived, this, [this](const QByteArray &data, quint64 clientId) {
+            onStreamData(data, m_tcpServer->clientInfo(clientId));
+        });
+        // 断开信号先于移除发出，此时仍能查到客户端地址
+        connect(m_tcpServer.get(), &ITcpServerManager::clientDisconnected, this, [this](quint64 clientId) {
+            flushFramer(m_tcpServer->clientInfo(clientId));
+        });
+        if (!m_tcpServer->startListening(m_port)) {
+            emit errorOccurred(QString("无法监听端口 %1").arg(m_port));
+            return false;
+        }
+        emit opened();
+        return true;
+
+    case CaptureWriter::Transport::Udp:
+#if defined(Q_OS_LINUX)
+        if (m_udpBackend == UdpBackend::RecvMmsg) {
+            m_udp = std::make_unique<LinuxUdpManager>();
+        } else {
+            m_udp = std::make_unique<QtUdpManager>();
+        }
+#else
+        m_udp = std::make_unique<QtUdpManager>();
+#endif
+        m_udp->setTrafficStats(m_trafficStats);
+        connect(m_udp.get(), &IUdpManager::portUnbound, this, &CliEndpoint::closed);
+        connect(m_udp.get(), &IUdpManager::dataReceived, this, &CliEndpoint::onUdpData);
+        if (!m_udp->bindPort(m_bindPort)) {
+            emit errorOccurred(QString("无法绑定 UDP 端口 %1").arg(m_bindPort));
+            return false;
+        }
+        emit opened();
+        return true;
+    }
+    return false;
+}
+
+void CliEndpoint::close() {
+    if (m_serial && m_serial->isOpen()) m_serial->closePort();
+    if (m_tcp) m_tcp->disconnectFromServer(); // 连接尚未建立时也要中止
+    if (m_tcpServer && m_tcpServer->isListening()) m_tcpServer->stopListening();
+    if (m_udp && m_udp->isBound()) m_udp->unbindPort();
+}
+
+void CliEndpoint::onUdpData(const QByteArray &data, const QString &senderHost, quint16 senderPort) {
+    m_lastUdpHost = senderHost;
+    m_lastUdpPort = senderPort;
+    const QString peer = QString("%1:%2").arg(senderHost).arg(senderPort);
+    emit dataReceived(data, peer);
+    emit messageReceived(data, peer);
+}
+
+void CliEndpoint::onStreamData(const QByteArray &data, const QString &peer) {
+    emit dataReceived(data, peer);
+    std::shared_ptr<StreamFramer> &framer = m_framers[peer];
+    if (!framer) framer = StreamFramer::create(m_framerConfig);
+    QList<QByteArray> frames;
+    framer->feed(data, m_framerClock.nsecsElapsed(), &frames);
+    scheduleFramerTimer(framer->deadlineNs());
+    for (const QByteArray &frame : frames) {
+        emit messageReceived(frame, peer);
+    }
+}
+
+void CliEndpoint::flushFramer(const QString &peer) {
+    const std::shared_ptr<StreamFramer> framer = m_framers.take(peer);
+    if (!framer) return;
+    QList<QByteArray> frames;
+    framer->flush(&frames);
+    for (const QByteArray &frame : frames) {
+        emit messageReceived(frame, peer);
+    }
+}
+
+void CliEndpoint::flushAllFramers() {
+    const QList<QString> peers = m_framers.keys();
+    for (const QString &peer : peers) {
+        flushFramer(peer);
+    }
+}
+
+// 定时器只跟踪最早的到期时刻，到期后检查所有对端并重新安排
+void CliEndpoint::scheduleFramerTimer(qint64 deadlineNs) {
+    if (deadlineNs < 0) return;
+    if (m_framerTimer->isActive() && m_framerDeadlineNs <= deadlineNs) return;
+    m_framerDeadlineNs = deadlineNs;
+    const qint64 remainingNs = deadlineNs - m_framerClock.nsecsElapsed();
+    m_framerTimer->start(static_cast<int>(qBound<qint64>(0, (remainingNs + 999999) / 1000000, 60 * 60 * 1000)));
+}
+
+void CliEndpoint::onFramerTimeout() {
+    const qint64 nowNs = m_framerClock.nsecsElapsed();
+    qint64 nextDeadlineNs = -1;
+    QList<QPair<QString, QByteArray>> messages;
+    for (auto it = m_framers.cbegin(); it != m_framers.cend(); ++it) {
+        QList<QByteArray> frames;
+        it.value()->poll(nowNs, &frames);
+        for (const QByteArray &frame : frames) {
+            messages.append({ it.key(), frame });
+        }
+        const qint64 deadlineNs = it.value()->deadlineNs();
+        if (deadlineNs >= 0 && (nextDeadlineNs < 0 || deadlineNs < nextDeadlineNs)) nextDeadlineNs = deadlineNs;
+    }
+    scheduleFramerTimer(nextDeadlineNs);
+    // 槽函数里可能关闭端点，遍历结束后再发出
+    for (const auto &message : messages) {
+        emit messageReceived(message.second, message.first);
+    }
+}
+
+void CliEndpoint::write(const QByteArray &data) {
+    switch (m_transport) {
+    case CaptureWriter::Transport::Serial:
+        if (m_serial && m_serial->isOpen()) m_serial->writeData(data);
+        break;
+    case CaptureWriter::Transport::TcpClient:
+        if (m_tcp && m_tcp->isConnected()) m_tcp->writeData(data);
+        break;
+    case CaptureWriter::Transport::TcpServer:
+        // 所有客户端共享同一份数据
+        if (m_tcpServer) m_tcpServer->broadcast(data);
+        break;
+    case CaptureWriter::Transport::Udp:
+        if (!m_udp || !m_udp->isBound()) break;
+        if (!m_host.isEmpty()) {
+            m_udp->writeData(data, m_host, m_port);
+        } else if (m_lastUdpPort != 0) {
+            m_udp->writeData(data, m_lastUdpHost, m_lastUdpPort);
+        }
+        break;
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef CLIENDPOINT_H
+#define CLIENDPOINT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QString>
+#include <QSerialPort>
+#include <memory>
+#include "CaptureWriter.h"
+#include "StreamFramer.h"
+
+class SerialManager;
+class TcpManager;
+class ITcpServerManager;
+class IUdpManager;
+class TrafficStats;
+class QTimer;
+
+// 一个连接端点，把各通信管理器统一成相同的打开/收发接口。命令行模式和多会话 (SessionManager) 共用。
+// 端点描述格式：
+//   serial:<端口>[:<波特率>]        例如 serial:/dev/ttyUSB0:115200、serial:COM3
+//   tcp:<主机>:<端口>
+//   tcp-server:<端口>               发送时广播给所有已连接的客户端
+//   udp:<本地端口>[:<主机>:<端口>]  未指定目标时发往最近一次收到数据的对端
+class CliEndpoint : public QObject {
+    Q_OBJECT
+
+public:
+    enum class UdpBackend { Qt, RecvMmsg };
+    enum class TcpServerBackend { Qt, Epoll };
+
+    ~CliEndpoint() override;
+
+    // 解析端点描述，格式错误时返回 nullptr 并填写 error
+    static CliEndpoint *fromSpec(const QString &spec, UdpBackend udpBackend, QString *error, QObject *parent = nullptr);
+
+    // 需在 open() 之前设置，为空时不统计
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; }
+    // 需在 open() 之前设置，只对 tcp-server 端点有效
+    void setTcpServerBackend(TcpServerBackend backend) { m_tcpServerBackend = backend; }
+    // 需在 open() 之前设置。串口和 TCP 的接收数据按对端各自分帧后由 messageReceived 交出，UDP 每个数据报就是一条消息
+    void setFramer(const StreamFramer::Config &config) { m_framerConfig = config; }
+    // 需在 open() 之前设置，只对 serial 端点有效：batched 为批量读取 (否则最低延迟)，lowLatency 仅 Linux 有效
+    void setSerialOptions(bool batched, bool lowLatency) { m_serialBatched = batched; m_serialLowLatency = lowLatency; }
+
+    bool open();
+    void close();
+    void write(const QByteArray &data);
+
+    CaptureWriter::Transport transport() const { return m_transport; }
+    QString spec() const { return m_spec; }
+
+signals:
+    void opened();
+    void closed();
+    // 传输层收到的原始数据，用于抓包和桥接转发
+    void dataReceived(const QByteArray &data, const QString &peer);
+    // 按 setFramer 切分后的完整消息
+    void messageReceived(const QByteArray &message, const QString &peer);
+    void errorOccurred(const QString &errorText);
+
+private:
+    CliEndpoint(CaptureWriter::Transport transport, const QString &spec, QObject *parent);
+    void onUdpData(const QByteArray &data, const QString &senderHost, quint16 senderPort);
+    void onStreamData(const QByteArray &data, const QString &peer);
+    void flushFramer(const QString &peer);
+    void flushAllFramers();
+    void onFramerTimeout();
+    void scheduleFramerTimer(qint64 deadlineNs);
+
+private:
+    CaptureWriter::Transport m_transport;
+    QString m_spec;
+    UdpBackend m_udpBackend;
+    TcpServerBackend m_tcpServerBackend;
+    TrafficStats *m_trafficStats;
+
+    // 按传输方式使用其中一个
+    std::unique_ptr<SerialManager> m_serial;
+    std::unique_ptr<TcpManager> m_tcp;
+    std::unique_ptr<ITcpServerManager> m_tcpServer;
+    std::unique_ptr<IUdpManager> m_udp;
+
+    QString m_host;               // serial: 端口名；tcp / udp: 目标主机
+    quint16 m_port;               // tcp / tcp-server / udp: 目标或监听端口
+    quint16 m_bindPort;           // udp: 本地端口
+    qint32 m_baudRate;            // serial
+    bool m_serialBatched;         // serial
+    bool m_serialLowLatency;      // serial
+    QString m_lastUdpHost;
+    quint16 m_lastUdpPort;
+
+    StreamFramer::Config m_framerConfig;
+    QHash<QString, std::shared_ptr<StreamFramer>> m_framers; // 键为对端
+    QTimer *m_framerTimer;        // 只有空闲间隔分帧使用
+    qint64 m_framerDeadlineNs;
+    QElapsedTimer m_framerClock;
+};
+
+#endif // CLIENDPOINT_H
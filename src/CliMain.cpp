@@ -0,0 +1,279 @@
+// nexusterm-cli：无界面的命令行模式，只依赖 QtCore / Network / SerialPort。
+// 打开一个连接，把接收数据输出到标准输出和/或抓包文件；指定 --bridge 时在两个端点之间双向转发。
+#include "CliEndpoint.h"
+#include "CaptureWriter.h"
+#include "LogFormatter.h"
+#include "TrafficStats.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+#include <QTimer>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#ifdef Q_OS_WIN
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace {
+
+std::atomic<bool> g_interrupted(false);
+
+void handleInterrupt(int) {
+    g_interrupted.store(true);
+}
+
+enum class OutputMode { Raw, Hex, None };
+
+// 标准输出：raw 原样输出字节；hex 每个数据块一行，带时间戳、方向和对端
+class StdoutSink {
+public:
+    explicit StdoutSink(OutputMode mode) : m_mode(mode) {
+#ifdef Q_OS_WIN
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        if (m_mode != OutputMode::None) {
+            m_out.open(stdout, QIODevice::WriteOnly);
+        }
+    }
+
+    void write(const char *direction, const QString &peer, const QByteArray &data) {
+        if (m_mode == OutputMode::Raw) {
+            m_out.write(data);
+        } else if (m_mode == OutputMode::Hex) {
+            const QString line = QString("[%1] %2 %3 %4\n")
+                    .arg(QDateTime::currentDateTime().toString("HH:mm:ss.zzz"))
+                    .arg(QLatin1String(direction))
+                    .arg(peer)
+                    .arg(LogFormatter::toHex(data));
+            m_out.write(line.toUtf8());
+        } else {
+            return;
+        }
+        m_out.flush();
+    }
+
+private:
+    OutputMode m_mode;
+    QFile m_out;
+};
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("nexusterm-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("NexusTerm 命令行模式：打开一个连接，把接收数据输出到标准输出或抓包文件。");
+    parser.addHelpOption();
+    parser.addPositionalArgument("endpoint",
+                                 "serial:<端口>[:<波特率>] | tcp:<主机>:<端口> | tcp-server:<端口> | udp:<本地端口>[:<主机>:<端口>]");
+    QCommandLineOption outputOption({"o", "output"}, "标准输出格式: raw (默认)、hex 或 none。", "format", "raw");
+    QCommandLineOption captureOption({"c", "capture"}, "把所有收发数据写入抓包文件，扩展名为 .pcapng 时使用 pcapng 格式。", "file");
+    QCommandLineOption bridgeOption({"b", "bridge"}, "第二个端点，两个端点之间双向转发数据。", "endpoint");
+    QCommandLineOption udpBackendOption("udp-backend", "UDP 接收实现: qt (默认) 或 recvmmsg (仅 Linux)。", "backend", "qt");
+    QCommandLineOption tcpServerBackendOption("tcp-server-backend", "TCP 服务器实现: qt (默认) 或 epoll (仅 Linux，多线程，适合大量客户端)。", "backend", "qt");
+    QCommandLineOption statsOption("stats", "定时把流量统计快照追加到文件，扩展名为 .csv 时写 CSV，否则写 JSON Lines。", "file");
+    QCommandLineOption framerOption("framer", "接收数据的分帧方式，影响标准输出的分块：none (默认)、idle[:<微秒>]、length[:<1|2|4>[be|le][+hdr]]、"
+                                              "delim[:<分隔符>]、line、slip、cobs 或 fixed[:<字节数>]。抓包和桥接始终使用原始数据。", "spec", "none");
+    QCommandLineOption serialReadModeOption("serial-read-mode", "串口读取方式: latency (默认，收到即处理) 或 batched (每 10ms 合并一次，适合高波特率)。", "mode", "latency");
+    QCommandLineOption serialLowLatencyOption("serial-low-latency", "串口启用 ASYNC_LOW_LATENCY (仅 Linux，FTDI 延迟定时器降到 1ms)。");
+    QCommandLineOption statsIntervalOption("stats-interval", "流量统计导出间隔 (毫秒)，默认 1000。", "ms", "1000");
+    parser.addOption(outputOption);
+    parser.addOption(captureOption);
+    parser.addOption(bridgeOption);
+    parser.addOption(udpBackendOption);
+    parser.addOption(tcpServerBackendOption);
+    parser.addOption(statsOption);
+    parser.addOption(statsIntervalOption);
+    parser.addOption(framerOption);
+    parser.addOption(serialReadModeOption);
+    parser.addOption(serialLowLatencyOption);
+    parser.process(app);
+
+    const QStringList positional = parser.positionalArguments();
+    if (positional.size() != 1) {
+        std::fprintf(stderr, "需要且只能指定一个端点\n\n");
+        parser.showHelp(1);
+    }
+
+    OutputMode outputMode = OutputMode::Raw;
+    const QString outputText = parser.value(outputOption);
+    if (outputText == "hex") {
+        outputMode = OutputMode::Hex;
+    } else if (outputText == "none") {
+        outputMode = OutputMode::None;
+    } else if (outputText != "raw") {
+        std::fprintf(stderr, "未知的输出格式: %s\n", qPrintable(outputText));
+        return 1;
+    }
+    // 桥接时两个方向的数据混在一起，原样输出没有意义
+    if (parser.isSet(bridgeOption) && outputMode == OutputMode::Raw && !parser.isSet(outputOption)) {
+        outputMode = OutputMode::None;
+    }
+
+    CliEndpoint::UdpBackend udpBackend = CliEndpoint::UdpBackend::Qt;
+    if (parser.value(udpBackendOption) == "recvmmsg") {
+#ifdef Q_OS_LINUX
+        udpBackend = CliEndpoint::UdpBackend::RecvMmsg;
+#else
+        std::fprintf(stderr, "recvmmsg 接收只在 Linux 上可用，改用 Qt 实现\n");
+#endif
+    }
+
+    CliEndpoint::TcpServerBackend tcpServerBackend = CliEndpoint::TcpServerBackend::Qt;
+    if (parser.value(tcpServerBackendOption) == "epoll") {
+#ifdef Q_OS_LINUX
+        tcpServerBackend = CliEndpoint::TcpServerBackend::Epoll;
+#else
+        std::fprintf(stderr, "epoll 服务器只在 Linux 上可用，改用 Qt 实现\n");
+#endif
+    }
+
+    const QString serialReadMode = parser.value(serialReadModeOption);
+    if (serialReadMode != "latency" && serialReadMode != "batched") {
+        std::fprintf(stderr, "未知的串口读取方式: %s\n", qPrintable(serialReadMode));
+        return 1;
+    }
+    const bool serialBatched = serialReadMode == "batched";
+    const bool serialLowLatency = parser.isSet(serialLowLatencyOption);
+#ifndef Q_OS_LINUX
+    if (serialLowLatency) {
+        std::fprintf(stderr, "ASYNC_LOW_LATENCY 只在 Linux 上可用，已忽略\n");
+    }
+#endif
+
+    QString error;
+    StreamFramer::Config framerConfig;
+    if (!StreamFramer::parseSpec(parser.value(framerOption), &framerConfig, &error)) {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return 1;
+    }
+
+    CliEndpoint *primary = CliEndpoint::fromSpec(positional.first(), udpBackend, &error, &app);
+    if (!primary) {
+        std::fprintf(stderr, "%s\n", qPrintable(error));
+        return 1;
+    }
+    primary->setTcpServerBackend(tcpServerBackend);
+    primary->setFramer(framerConfig);
+    primary->setSerialOptions(serialBatched, serialLowLatency);
+    CliEndpoint *bridge = nullptr;
+    if (parser.isSet(bridgeOption)) {
+        bridge = CliEndpoint::fromSpec(parser.value(bridgeOption), udpBackend, &error, &app);
+        if (!bridge) {
+            std::fprintf(stderr, "%s\n", qPrintable(error));
+            return 1;
+        }
+        bridge->setTcpServerBackend(tcpServerBackend);
+        bridge->setFramer(framerConfig);
+        bridge->setSerialOptions(serialBatched, serialLowLatency);
+    }
+
+    CaptureWriter capture;
+    if (parser.isSet(captureOption)) {
+        const QString capturePath = parser.value(captureOption);
+        const CaptureWriter::Format format = capturePath.endsWith(".pcapng", Qt::CaseInsensitive)
+                ? CaptureWriter::Format::PcapNg : CaptureWriter::Format::Native;
+        if (!capture.start(capturePath, format)) {
+            std::fprintf(stderr, "无法创建抓包文件: %s\n", qPrintable(capture.errorString()));
+            return 1;
+        }
+    }
+
+    // 流量统计：定时追加快照，速率按相邻两次快照计算
+    TrafficStats trafficStats;
+    QFile statsFile;
+    bool statsCsv = false;
+    TrafficStats::Snapshot lastStatsSnapshot;
+    bool hasLastStatsSnapshot = false;
+    QTimer statsTimer;
+    if (parser.isSet(statsOption)) {
+        bool ok = false;
+        const int intervalMs = parser.value(statsIntervalOption).toInt(&ok);
+        if (!ok || intervalMs <= 0) {
+            std::fprintf(stderr, "无效的统计间隔: %s\n", qPrintable(parser.value(statsIntervalOption)));
+            return 1;
+        }
+        statsFile.setFileName(parser.value(statsOption));
+        if (!statsFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            std::fprintf(stderr, "无法创建统计文件: %s\n", qPrintable(statsFile.errorString()));
+            return 1;
+        }
+        statsCsv = statsFile.fileName().endsWith(".csv", Qt::CaseInsensitive);
+        if (statsCsv) statsFile.write(TrafficStats::csvHeader());
+        QObject::connect(&statsTimer, &QTimer::timeout, &app, [&]() {
+            const TrafficStats::Snapshot snapshot = trafficStats.snapshot();
+            const TrafficStats::Snapshot *previous = hasLastStatsSnapshot ? &lastStatsSnapshot : nullptr;
+            statsFile.write(statsCsv ? TrafficStats::toCsvRow(snapshot, previous) : TrafficStats::toJsonLine(snapshot, previous));
+            statsFile.flush();
+            lastStatsSnapshot = snapshot;
+            hasLastStatsSnapshot = true;
+        });
+        statsTimer.start(intervalMs);
+        primary->setTrafficStats(&trafficStats);
+        if (bridge) bridge->setTrafficStats(&trafficStats);
+    }
+
+    StdoutSink sink(outputMode);
+    const QList<CliEndpoint *> endpoints = bridge ? QList<CliEndpoint *>{primary, bridge} : QList<CliEndpoint *>{primary};
+    for (CliEndpoint *endpoint : endpoints) {
+        CliEndpoint *peerEndpoint = (endpoint == primary) ? bridge : primary;
+        QObject::connect(endpoint, &CliEndpoint::dataReceived, &app,
+                         [&capture, endpoint, peerEndpoint](const QByteArray &data, const QString &peer) {
+            capture.record(endpoint->transport(), CaptureWriter::RecordType::Rx, peer, data);
+            if (peerEndpoint) {
+                peerEndpoint->write(data);
+                capture.record(peerEndpoint->transport(), CaptureWriter::RecordType::Tx, peerEndpoint->spec(), data);
+            }
+        });
+        QObject::connect(endpoint, &CliEndpoint::messageReceived, &app, [&sink](const QByteArray &message, const QString &peer) {
+            sink.write("RX", peer, message);
+        });
+        QObject::connect(endpoint, &CliEndpoint::opened, &app, [endpoint]() {
+            std::fprintf(stderr, "已打开 %s\n", qPrintable(endpoint->spec()));
+        });
+        QObject::connect(endpoint, &CliEndpoint::errorOccurred, &app, [endpoint](const QString &errorText) {
+            std::fprintf(stderr, "%s: %s\n", qPrintable(endpoint->spec()), qPrintable(errorText));
+            QCoreApplication::exit(1);
+        });
+        QObject::connect(endpoint, &CliEndpoint::closed, &app, [endpoint]() {
+            std::fprintf(stderr, "%s 已关闭\n", qPrintable(endpoint->spec()));
+            QCoreApplication::quit();
+        });
+        if (!endpoint->open()) {
+            return 1;
+        }
+    }
+
+    // Ctrl+C 时正常退出事件循环，保证抓包文件写完整
+    std::signal(SIGINT, handleInterrupt);
+    std::signal(SIGTERM, handleInterrupt);
+    QTimer interruptTimer;
+    QObject::connect(&interruptTimer, &QTimer::timeout, &app, []() {
+        if (g_interrupted.load()) QCoreApplication::quit();
+    });
+    interruptTimer.start(100);
+
+    const int exitCode = app.exec();
+    for (CliEndpoint *endpoint : endpoints) {
+        endpoint->close();
+    }
+    if (statsFile.isOpen()) {
+        // 退出前补一条最终快照
+        statsTimer.stop();
+        const TrafficStats::Snapshot snapshot = trafficStats.snapshot();
+        const TrafficStats::Snapshot *previous = hasLastStatsSnapshot ? &lastStatsSnapshot : nullptr;
+        statsFile.write(statsCsv ? TrafficStats::toCsvRow(snapshot, previous) : TrafficStats::toJsonLine(snapshot, previous));
+        statsFile.close();
+    }
+    capture.stop();
+    if (capture.droppedRecords() > 0) {
+        std::fprintf(stderr, "抓包丢弃了 %llu 条记录\n", static_cast<unsigned long long>(capture.droppedRecords()));
+    }
+    return exitCode;
+}
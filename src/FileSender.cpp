@@ -0,0 +1,199 @@
+#include "FileSender.h"
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+constexpr qint64 kMapWindowBytes = 64 * 1024 * 1024; // 每次映射的文件窗口
+constexpr qint64 kDefaultHighWaterMark = 1024 * 1024;
+constexpr int kSliceMs = 10;             // 尽快发送时每轮最多占用事件循环的时间
+constexpr int kDrainPollMs = 100;        // 等待写缓冲排空时的兜底轮询，防止漏掉 bytesWritten
+constexpr int kProgressIntervalMs = 100;
+}
+
+FileSender::FileSender(QObject *parent)
+    : QObject(parent)
+    , m_active(false)
+    , m_useMap(true)
+    , m_window(nullptr)
+    , m_windowOffset(0)
+    , m_windowSize(0)
+    , m_chunkSize(0)
+    , m_delayMs(0)
+    , m_highWaterMark(kDefaultHighWaterMark)
+    , m_total(0)
+    , m_sent(0)
+    , m_lastProgressMs(0)
+    , m_lastProgressBytes(0)
+    , m_waitingForDrain(false)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &FileSender::pump);
+}
+
+FileSender::~FileSender() {
+    unmapWindow();
+}
+
+bool FileSender::start(const QString &filePath, int chunkSize, int delayMs,
+                       WriteFunction write, PendingFunction pending) {
+    if (m_active) {
+        m_error = "已有文件正在发送";
+        return false;
+    }
+    if (chunkSize <= 0 || !write) {
+        m_error = "无效的发送参数";
+        return false;
+    }
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_error = m_file.errorString();
+        return false;
+    }
+    m_total = m_file.size();
+    if (m_total <= 0) {
+        m_file.close();
+        m_error = "文件为空，无需发送。";
+        return false;
+    }
+
+    m_write = std::move(write);
+    m_pending = std::move(pending);
+    m_chunkSize = chunkSize;
+    m_delayMs = delayMs;
+    m_sent = 0;
+    m_useMap = true;
+    m_waitingForDrain = false;
+    m_error.clear();
+    m_lastProgressMs = 0;
+    m_lastProgressBytes = 0;
+    m_clock.start();
+    m_active = true;
+
+    emitProgress(true);
+    // 第一轮也放到事件循环中执行，调用方可以先完成界面更新
+    m_timer->start(0);
+    return true;
+}
+
+void FileSender::cancel() {
+    if (m_active) {
+        finish(false, "发送已取消");
+    }
+}
+
+void FileSender::onBytesWritten() {
+    if (m_active && m_waitingForDrain) {
+        m_timer->stop();
+        pump();
+    }
+}
+
+void FileSender::pump() {
+    if (!m_active) return;
+    m_waitingForDrain = false;
+
+    QElapsedTimer slice;
+    slice.start();
+    while (m_sent < m_total) {
+        if (m_pending && m_pending() >= m_highWaterMark) {
+            // 传输层积压过多，等 bytesWritten 再继续
+            m_waitingForDrain = true;
+            m_timer->start(kDrainPollMs);
+            emitProgress(false);
+            return;
+        }
+
+        const qint64 length = qMin<qint64>(m_chunkSize, m_total - m_sent);
+        QByteArray chunk;
+        if (!nextChunk(length, &chunk)) {
+            finish(false, "读取文件失败: " + m_file.errorString());
+            return;
+        }
+        if (!m_write(chunk)) {
+            finish(false, "连接已断开，发送中止");
+            return;
+        }
+        m_sent += length;
+        emit chunkSent(chunk);
+
+        if (m_delayMs > 0 && m_sent < m_total) {
+            m_timer->start(m_delayMs);
+            emitProgress(false);
+            return;
+        }
+        if (slice.elapsed() >= kSliceMs) {
+            m_timer->start(0);
+            emitProgress(false);
+            return;
+        }
+    }
+
+    // 全部提交后等传输层写空再报告完成
+    if (m_pending && m_pending() > 0) {
+        m_waitingForDrain = true;
+        m_timer->start(kDrainPollMs);
+        emitProgress(false);
+        return;
+    }
+    emitProgress(true);
+    finish(true, QString());
+}
+
+bool FileSender::nextChunk(qint64 length, QByteArray *chunk) {
+    if (m_useMap) {
+        if (!m_window || m_sent < m_windowOffset || m_sent + length > m_windowOffset + m_windowSize) {
+            unmapWindow();
+            m_windowOffset = m_sent;
+            m_windowSize = qMin(m_total - m_sent, qMax(kMapWindowBytes, length));
+            m_window = m_file.map(m_windowOffset, m_windowSize);
+            if (!m_window) {
+                qDebug() << "[FileSender] 无法映射文件，改为分块读取:" << m_file.errorString();
+                m_useMap = false;
+            }
+        }
+        if (m_window) {
+            *chunk = QByteArray::fromRawData(reinterpret_cast<const char *>(m_window + (m_sent - m_windowOffset)),
+                                             static_cast<qsizetype>(length));
+            return true;
+        }
+    }
+
+    if (m_file.pos() != m_sent && !m_file.seek(m_sent)) {
+        return false;
+    }
+    *chunk = m_file.read(length);
+    return chunk->size() == length;
+}
+
+void FileSender::unmapWindow() {
+    if (m_window) {
+        m_file.unmap(m_window);
+        m_window = nullptr;
+    }
+    m_windowSize = 0;
+}
+
+void FileSender::emitProgress(bool force) {
+    const qint64 nowMs = m_clock.elapsed();
+    const qint64 intervalMs = nowMs - m_lastProgressMs;
+    if (!force && intervalMs < kProgressIntervalMs) return;
+
+    const double bytesPerSecond = intervalMs > 0 ? (m_sent - m_lastProgressBytes) * 1000.0 / intervalMs : 0.0;
+    m_lastProgressMs = nowMs;
+    m_lastProgressBytes = m_sent;
+    emit progress(m_sent, m_total, bytesPerSecond);
+}
+
+void FileSender::finish(bool success, const QString &errorText) {
+    m_active = false;
+    m_waitingForDrain = false;
+    m_timer->stop();
+    unmapWindow();
+    m_file.close();
+    m_write = WriteFunction();
+    m_pending = PendingFunction();
+    m_error = errorText;
+    emit finished(success, errorText);
+}
@@ -0,0 +1,85 @@
+#ifndef FILESENDER_H
+#define FILESENDER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+#include <functional>
+
+class QTimer;
+
+// 流式大文件发送。文件按窗口映射到内存 (映射失败时退回分块读取)，每次只取一个分包，
+// 不会把整个文件读进内存。发送在事件循环中分片进行，界面不会卡顿：
+//   - 有写缓冲的传输 (串口 / TCP) 提供 pending 函数，积压超过高水位后暂停，
+//     等传输层的 bytesWritten 信号 (连接到 onBytesWritten) 再继续；
+//   - 没有背压的传输 (UDP) 只按分包延时或时间片让出事件循环。
+class FileSender : public QObject {
+    Q_OBJECT
+
+public:
+    // 写入一个分包，传输已断开等无法发送时返回 false
+    typedef std::function<bool(const QByteArray &)> WriteFunction;
+    // 传输层尚未写出的字节数
+    typedef std::function<qint64()> PendingFunction;
+
+    explicit FileSender(QObject *parent = nullptr);
+    ~FileSender() override;
+
+    // delayMs > 0 时每个分包之间固定等待，否则尽快发送
+    bool start(const QString &filePath, int chunkSize, int delayMs,
+               WriteFunction write, PendingFunction pending = PendingFunction());
+    void cancel();
+    bool isActive() const { return m_active; }
+
+    void setHighWaterMark(qint64 bytes) { m_highWaterMark = bytes; }
+    qint64 totalBytes() const { return m_total; }
+    qint64 sentBytes() const { return m_sent; }
+    qint64 elapsedMs() const { return m_clock.elapsed(); }
+    QString errorString() const { return m_error; }
+
+public slots:
+    void onBytesWritten();
+
+signals:
+    // chunk 可能直接引用映射的文件内存，只在信号处理期间有效，需要保留时请复制
+    void chunkSent(const QByteArray &chunk);
+    void progress(qint64 sentBytes, qint64 totalBytes, double bytesPerSecond);
+    void finished(bool success, const QString &errorText);
+
+private slots:
+    void pump();
+
+private:
+    bool nextChunk(qint64 length, QByteArray *chunk);
+    void unmapWindow();
+    void emitProgress(bool force);
+    void finish(bool success, const QString &errorText);
+
+private:
+    QFile m_file;
+    QTimer *m_timer;
+    WriteFunction m_write;
+    PendingFunction m_pending;
+
+    bool m_active;
+    bool m_useMap;
+    uchar *m_window;           // 当前映射窗口
+    qint64 m_windowOffset;
+    qint64 m_windowSize;
+
+    int m_chunkSize;
+    int m_delayMs;
+    qint64 m_highWaterMark;
+    qint64 m_total;
+    qint64 m_sent;
+    QString m_error;
+
+    QElapsedTimer m_clock;
+    qint64 m_lastProgressMs;
+    qint64 m_lastProgressBytes;
+    bool m_waitingForDrain;    // 因背压暂停，等待 bytesWritten
+};
+
+#endif // FILESENDER_H
@@ -0,0 +1,207 @@
+// nexusterm-fpgasim：模拟 FPGA 板卡的视频流发生器，用于在没有硬件时压测 UDP 视频通路。
+// 在本地端口等待上位机的 0x01 启动命令 (on_playPauseButton_clicked 发出)，
+// 然后向命令的来源地址按设定的分辨率、帧率、包长和速率发送 RGB565 视频流，
+// 可以注入丢包、乱序和数据损坏。再次收到 0x01 时从第 0 帧重新开始。
+//
+//   ./nexusterm-fpgasim --port 8080 --width 1280 --height 720 --fps 60 --loss 0.001
+#include "VideoStreamGenerator.h"
+#include "VideoPacketHeader.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QHostAddress>
+#include <QThread>
+#include <QTimer>
+#include <QUdpSocket>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+std::atomic<bool> g_interrupted(false);
+
+void handleInterrupt(int) {
+    g_interrupted.store(true);
+}
+
+bool parseProbability(const QString &text, double *value) {
+    bool ok = false;
+    *value = text.toDouble(&ok);
+    return ok && *value >= 0.0 && *value <= 1.0;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("nexusterm-fpgasim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("模拟 FPGA 视频流：收到 0x01 启动命令后向发送方回传 RGB565 视频。");
+    parser.addHelpOption();
+    QCommandLineOption portOption({"p", "port"}, "监听启动命令的本地 UDP 端口，默认 8080。", "port", "8080");
+    QCommandLineOption targetOption("target", "不等待启动命令，立即向 <主机>:<端口> 发送。", "host:port");
+    QCommandLineOption widthOption("width", "图像宽度，默认 640。", "pixels", "640");
+    QCommandLineOption heightOption("height", "图像高度，默认 480。", "pixels", "480");
+    QCommandLineOption fpsOption("fps", "帧率，默认 30；0 表示不限帧率。", "fps", "30");
+    QCommandLineOption packetSizeOption("packet-size", "数据报长度 (分包模式下为像素负载长度)，默认 1400。", "bytes", "1400");
+    QCommandLineOption packetizedOption("packetized", "使用分包协议 (每个数据报带帧号/包序号/偏移)。");
+    QCommandLineOption rateOption("rate", "发送速率上限 (Mbit/s)，默认 0 表示每帧开始时突发发送。", "mbps", "0");
+    QCommandLineOption burstOption("burst", "限速时允许连续发出的最大包数，默认 16。", "packets", "16");
+    QCommandLineOption lossOption("loss", "每个数据报的丢弃概率 (0~1)。", "probability", "0");
+    QCommandLineOption reorderOption("reorder", "每个数据报被推迟发送的概率 (0~1)。", "probability", "0");
+    QCommandLineOption reorderDepthOption("reorder-depth", "被推迟的包在其后第几个包之后补发，默认 8。", "packets", "8");
+    QCommandLineOption corruptOption("corrupt", "每个数据报被翻转一个比特的概率 (0~1)。", "probability", "0");
+    QCommandLineOption seedOption("seed", "损伤注入的随机种子，默认 1。", "seed", "1");
+    QCommandLineOption framesOption("frames", "发送的帧数，默认 0 表示一直发送。", "count", "0");
+    QCommandLineOption statusOption("status", "状态头中间的 3 个字节 (十六进制)，默认 000001。", "hex", "000001");
+    for (const QCommandLineOption &option : { portOption, targetOption, widthOption, heightOption, fpsOption, packetSizeOption,
+                                              packetizedOption, rateOption, burstOption, lossOption, reorderOption,
+                                              reorderDepthOption, corruptOption, seedOption, framesOption, statusOption }) {
+        parser.addOption(option);
+    }
+    parser.process(app);
+
+    VideoStreamGenerator::Config config;
+    bool ok = true;
+    bool valueOk = false;
+    config.width = parser.value(widthOption).toInt(&valueOk);
+    ok = ok && valueOk && config.width > 0 && config.width <= 4096;
+    config.height = parser.value(heightOption).toInt(&valueOk);
+    ok = ok && valueOk && config.height > 0 && config.height <= 4096;
+    if (!ok) {
+        std::fprintf(stderr, "分辨率必须在 1~4096 之间\n");
+        return 1;
+    }
+    config.fps = parser.value(fpsOption).toDouble(&valueOk);
+    if (!valueOk || config.fps < 0) {
+        std::fprintf(stderr, "无效的帧率: %s\n", qPrintable(parser.value(fpsOption)));
+        return 1;
+    }
+    config.packetized = parser.isSet(packetizedOption);
+    config.packetSize = parser.value(packetSizeOption).toInt(&valueOk);
+    const int maxPacketSize = 65507 - (config.packetized ? int(VideoPacketHeader::kSize) : 0);
+    if (!valueOk || config.packetSize <= 0 || config.packetSize > maxPacketSize) {
+        std::fprintf(stderr, "包长必须在 1~%d 之间\n", maxPacketSize);
+        return 1;
+    }
+    const qsizetype frameBytes = qsizetype(config.width) * config.height * 2;
+    if (config.packetized && (frameBytes + config.packetSize - 1) / config.packetSize > 65535) {
+        std::fprintf(stderr, "分包模式下每帧最多 65535 个包，请增大 --packet-size\n");
+        return 1;
+    }
+    config.rateMbps = parser.value(rateOption).toDouble();
+    config.burstPackets = qMax(parser.value(burstOption).toInt(), 1);
+    if (!parseProbability(parser.value(lossOption), &config.lossRate)
+            || !parseProbability(parser.value(reorderOption), &config.reorderRate)
+            || !parseProbability(parser.value(corruptOption), &config.corruptRate)) {
+        std::fprintf(stderr, "丢包、乱序和损坏概率必须在 0~1 之间\n");
+        return 1;
+    }
+    config.reorderDepth = qMax(parser.value(reorderDepthOption).toInt(), 1);
+    config.seed = parser.value(seedOption).toUInt();
+    config.frameLimit = parser.value(framesOption).toLongLong();
+    const QByteArray status = QByteArray::fromHex(parser.value(statusOption).toLatin1());
+    if (status.size() != 3) {
+        std::fprintf(stderr, "--status 需要 3 个字节的十六进制，例如 010001\n");
+        return 1;
+    }
+    std::memcpy(config.status, status.constData(), 3);
+
+    const quint16 port = static_cast<quint16>(parser.value(portOption).toUInt());
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::Any, port)) {
+        std::fprintf(stderr, "无法绑定 UDP 端口 %u: %s\n", port, qPrintable(socket.errorString()));
+        return 1;
+    }
+    socket.setSocketOption(QAbstractSocket::SendBufferSizeSocketOption, 8 * 1024 * 1024);
+
+    QThread generatorThread;
+    VideoStreamGenerator *generator = new VideoStreamGenerator(config);
+    generator->moveToThread(&generatorThread);
+    QObject::connect(&generatorThread, &QThread::finished, generator, &QObject::deleteLater);
+    generatorThread.start();
+
+    const bool oneShot = parser.isSet(targetOption);
+    QObject::connect(generator, &VideoStreamGenerator::finished, &app, [oneShot](const QString &errorText) {
+        if (!errorText.isEmpty()) {
+            std::fprintf(stderr, "%s\n", qPrintable(errorText));
+        } else {
+            std::fprintf(stderr, "发送结束\n");
+        }
+        if (oneShot) QCoreApplication::exit(errorText.isEmpty() ? 0 : 1);
+    });
+
+    auto startStream = [&socket, generator](const QString &host, quint16 targetPort) {
+        const quint64 token = generator->prepareRun();
+        std::fprintf(stderr, "开始向 %s:%u 发送\n", qPrintable(host), targetPort);
+        const qintptr descriptor = socket.socketDescriptor();
+        QMetaObject::invokeMethod(generator, [generator, token, descriptor, host, targetPort]() {
+            generator->run(token, descriptor, host, targetPort);
+        }, Qt::QueuedConnection);
+    };
+
+    if (oneShot) {
+        const QString target = parser.value(targetOption);
+        const int colon = target.lastIndexOf(QLatin1Char(':'));
+        const quint16 targetPort = colon > 0 ? static_cast<quint16>(target.mid(colon + 1).toUInt()) : 0;
+        if (targetPort == 0) {
+            std::fprintf(stderr, "--target 格式应为 <主机>:<端口>\n");
+            return 1;
+        }
+        startStream(target.left(colon), targetPort);
+    } else {
+        std::fprintf(stderr, "等待端口 %u 上的 0x01 启动命令...\n", port);
+    }
+
+    // 启动命令是单字节 0x01，其他数据忽略
+    QObject::connect(&socket, &QUdpSocket::readyRead, &app, [&socket, &startStream]() {
+        while (socket.hasPendingDatagrams()) {
+            QByteArray datagram(static_cast<int>(qMax<qint64>(socket.pendingDatagramSize(), 0)), Qt::Uninitialized);
+            QHostAddress sender;
+            quint16 senderPort = 0;
+            socket.readDatagram(datagram.data(), datagram.size(), &sender, &senderPort);
+            if (datagram.size() == 1 && datagram.at(0) == 0x01) {
+                bool isIpv4 = false;
+                const QHostAddress ipv4(sender.toIPv4Address(&isIpv4));
+                startStream(isIpv4 ? ipv4.toString() : sender.toString(), senderPort);
+            }
+        }
+    });
+
+    // 每秒在标准错误输出一行发送统计
+    VideoStreamGenerator::Stats lastStats;
+    QTimer statsTimer;
+    QObject::connect(&statsTimer, &QTimer::timeout, &app, [generator, &lastStats]() {
+        const VideoStreamGenerator::Stats stats = generator->stats();
+        if (stats.packets == lastStats.packets && stats.droppedPackets == lastStats.droppedPackets) return;
+        std::fprintf(stderr, "帧 %llu (+%llu)  包 %llu  %.1f Mbit/s  丢弃 %llu  乱序 %llu  损坏 %llu  超时帧 %llu\n",
+                     static_cast<unsigned long long>(stats.frames),
+                     static_cast<unsigned long long>(stats.frames - lastStats.frames),
+                     static_cast<unsigned long long>(stats.packets),
+                     (stats.bytes - lastStats.bytes) * 8 / 1e6,
+                     static_cast<unsigned long long>(stats.droppedPackets),
+                     static_cast<unsigned long long>(stats.reorderedPackets),
+                     static_cast<unsigned long long>(stats.corruptedPackets),
+                     static_cast<unsigned long long>(stats.lateFrames));
+        lastStats = stats;
+    });
+    statsTimer.start(1000);
+
+    std::signal(SIGINT, handleInterrupt);
+    std::signal(SIGTERM, handleInterrupt);
+    QTimer interruptTimer;
+    QObject::connect(&interruptTimer, &QTimer::timeout, &app, []() {
+        if (g_interrupted.load()) QCoreApplication::quit();
+    });
+    interruptTimer.start(100);
+
+    const int exitCode = app.exec();
+    // 发送线程直接使用套接字，必须在套接字关闭前停下
+    generator->stopAndWait();
+    generatorThread.quit();
+    generatorThread.wait();
+    return exitCode;
+}
@@ -0,0 +1,94 @@
+#include "ITcpServerManager.h"
+#include <algorithm>
+
+ITcpServerManager::ITcpServerManager(QObject *parent)
+    : QObject(parent)
+    , m_trafficStats(nullptr)
+    , m_nextSendId(1)
+    , m_queueingSend(false)
+{
+    connect(this, &ITcpServerManager::clientDisconnected, this, &ITcpServerManager::removeFromAllGroups);
+}
+
+quint64 ITcpServerManager::writeToClients(const QByteArray &data, const QList<quint64> &clientIds) {
+    QList<quint64> targets = clientIds;
+    std::sort(targets.begin(), targets.end());
+    targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+    if (targets.isEmpty()) return 0;
+
+    const quint64 sendId = m_nextSendId++;
+    m_pendingSends.insert(sendId, { static_cast<int>(targets.size()), 0, 0 });
+    m_queueingSend = true;
+    queueMulticast(sendId, data, targets);
+    m_queueingSend = false;
+    return sendId;
+}
+
+void ITcpServerManager::reportCompletion(quint64 sendId, quint64 clientId, bool success) {
+    if (m_queueingSend) {
+        // 调用方此时还没拿到发送编号
+        QMetaObject::invokeMethod(this, [this, sendId, clientId, success]() {
+            reportCompletion(sendId, clientId, success);
+        }, Qt::QueuedConnection);
+        return;
+    }
+
+    auto it = m_pendingSends.find(sendId);
+    if (it == m_pendingSends.end()) return;
+    if (success) {
+        ++it->succeeded;
+    } else {
+        ++it->failed;
+    }
+    const bool finished = --it->remaining == 0;
+    const PendingSend totals = *it;
+    if (finished) m_pendingSends.erase(it);
+
+    emit sendCompleted(sendId, clientId, success);
+    if (finished) emit sendFinished(sendId, totals.succeeded, totals.failed);
+}
+
+void ITcpServerManager::addToGroup(const QString &group, quint64 clientId) {
+    if (group.isEmpty() || clientInfo(clientId).isEmpty()) return;
+    QSet<quint64> &members = m_groups[group];
+    if (members.contains(clientId)) return;
+    members.insert(clientId);
+    emit groupsChanged();
+}
+
+void ITcpServerManager::removeFromGroup(const QString &group, quint64 clientId) {
+    auto it = m_groups.find(group);
+    if (it == m_groups.end() || !it->remove(clientId)) return;
+    if (it->isEmpty()) m_groups.erase(it);
+    emit groupsChanged();
+}
+
+void ITcpServerManager::removeGroup(const QString &group) {
+    if (m_groups.remove(group)) emit groupsChanged();
+}
+
+QStringList ITcpServerManager::groupNames() const {
+    QStringList names = m_groups.keys();
+    names.sort();
+    return names;
+}
+
+QList<quint64> ITcpServerManager::groupMembers(const QString &group) const {
+    const QSet<quint64> members = m_groups.value(group);
+    return QList<quint64>(members.cbegin(), members.cend());
+}
+
+void ITcpServerManager::removeFromAllGroups(quint64 clientId) {
+    bool changed = false;
+    for (auto it = m_groups.begin(); it != m_groups.end();) {
+        if (it->remove(clientId)) {
+            changed = true;
+            if (it->isEmpty()) {
+                it = m_groups.erase(it);
+                continue;
+            }
+        }
+        ++it;
+    }
+    if (changed) emit groupsChanged();
+}
@@ -0,0 +1,92 @@
+#ifndef ITCPSERVERMANAGER_H
+#define ITCPSERVERMANAGER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class TrafficStats;
+
+// TCP 服务器的抽象接口，与 IUdpManager 一样按平台提供不同实现：
+// TcpServerManager 基于 QTcpServer，所有客户端都在所属线程的事件循环中处理；
+// LinuxTcpServerManager 用 epoll 把连接分散到多个 I/O 线程，接收数据聚合后再交给界面线程。
+// 客户端用整数句柄 (clientId) 标识：从 1 开始递增，在管理器的生命周期内不会重复使用，
+// 收发路径上的查找都是哈希表 O(1)，与连接数无关。"地址:端口" 字符串只在连接时生成一次。
+// 所有信号都在管理器所属的线程中发出
+class ITcpServerManager : public QObject {
+    Q_OBJECT
+
+public:
+    explicit ITcpServerManager(QObject *parent = nullptr);
+    virtual ~ITcpServerManager() = default;
+
+    virtual bool startListening(quint16 port) = 0;
+    virtual void stopListening() = 0;
+    // 多线程实现会在 I/O 线程中延后写出，fromRawData 构造的 data 由实现自行复制
+    virtual void writeData(const QByteArray &data, quint64 clientId) = 0;
+    virtual void disconnectClient(quint64 clientId) = 0;
+    virtual bool isListening() const = 0;
+    // 指定客户端已提交但尚未写入套接字的字节数，客户端不存在时返回 0
+    virtual qint64 bytesToWrite(quint64 clientId) const = 0;
+    // 客户端的 "地址:端口"，客户端不存在时返回空字符串
+    virtual QString clientInfo(quint64 clientId) const = 0;
+    virtual QList<quint64> clientIds() const = 0;
+
+    // 把同一份数据发给多个客户端：数据只有一份 (隐式共享)，各客户端的写队列只持有引用。
+    // 返回发送编号，每个客户端写完或失败时发出 sendCompleted，全部结束后发出 sendFinished；
+    // 没有目标时返回 0。对 data 的要求同 writeData
+    quint64 writeToClients(const QByteArray &data, const QList<quint64> &clientIds);
+    quint64 broadcast(const QByteArray &data) { return writeToClients(data, clientIds()); }
+    quint64 writeToGroup(const QByteArray &data, const QString &group) { return writeToClients(data, groupMembers(group)); }
+
+    // 命名分组，客户端断开后自动移出，分组变空时删除
+    void addToGroup(const QString &group, quint64 clientId);
+    void removeFromGroup(const QString &group, quint64 clientId);
+    void removeGroup(const QString &group);
+    QStringList groupNames() const;
+    QList<quint64> groupMembers(const QString &group) const;
+
+    // 为空时不统计。多线程实现在 I/O 线程中直接记录，需在 startListening 之前设置
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; }
+
+signals:
+    void clientConnected(quint64 clientId, const QString &clientInfo);
+    void clientDisconnected(quint64 clientId);
+    void dataReceived(const QByteArray &data, quint64 clientId);
+    void bytesWritten(qint64 bytes, quint64 clientId);
+    void serverMessage(const QString &message); // 用于向状态栏或日志发送信息
+    // success 为 false 表示客户端在写完之前断开或不存在
+    void sendCompleted(quint64 sendId, quint64 clientId, bool success);
+    void sendFinished(quint64 sendId, int succeeded, int failed);
+    void groupsChanged();
+
+protected:
+    // 把 data 排进每个客户端的写队列。实现必须为每个 clientId 恰好调用一次 reportCompletion
+    // (不存在的客户端可以立即报告失败)
+    virtual void queueMulticast(quint64 sendId, const QByteArray &data, const QList<quint64> &clientIds) = 0;
+    void reportCompletion(quint64 sendId, quint64 clientId, bool success);
+
+protected:
+    TrafficStats *m_trafficStats;
+
+private:
+    void removeFromAllGroups(quint64 clientId);
+
+private:
+    struct PendingSend {
+        int remaining;
+        int succeeded;
+        int failed;
+    };
+
+    QHash<quint64, PendingSend> m_pendingSends;
+    quint64 m_nextSendId;
+    bool m_queueingSend;                    // writeToClients 返回之前的完成报告推迟到事件循环
+    QHash<QString, QSet<quint64>> m_groups;
+};
+
+#endif // ITCPSERVERMANAGER_H
@@ -4,25 +4,44 @@
 #include <QObject>
 #include <QByteArray>
 
+class TrafficStats;
+
 // 抽象基类，定义UDP管理器的接口
 class IUdpManager : public QObject {
     Q_OBJECT
 
 public:
-    explicit IUdpManager(QObject *parent = nullptr) : QObject(parent) {}
+    explicit IUdpManager(QObject *parent = nullptr) : QObject(parent), m_trafficStats(nullptr) {}
     virtual ~IUdpManager() = default; // 虚析构函数是必须的
 
     // 纯虚函数，定义接口
     virtual bool bindPort(quint16 port) = 0;
     virtual void unbindPort() = 0;
     virtual void writeData(const QByteArray &data, const QString &host, quint16 port) = 0;
+    // 批量发送：把 data 按 segmentSize 切成多个数据报发往同一目标 (最后一个可以较短)。
+    // 默认逐个调用 writeData；原生实现用 sendmmsg / UDP GSO，系统调用次数降低一个数量级
+    virtual void writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) {
+        for (qsizetype offset = 0; segmentSize > 0 && offset < data.size(); offset += segmentSize) {
+            const qsizetype length = qMin<qsizetype>(segmentSize, data.size() - offset);
+            writeData(QByteArray::fromRawData(data.constData() + offset, length), host, port);
+        }
+    }
     virtual bool isBound() const = 0;
+    // 底层套接字描述符，未绑定时返回 -1。供独立的发送线程 (PacedUdpSender) 直接发送，
+    // 调用方必须在解绑前停止使用
+    virtual qintptr socketDescriptor() const = 0;
+
+    // 为空时不统计。原生实现在接收线程中直接记录，需在 bindPort 之前设置
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; }
 
 signals:
     // 所有实现都必须提供这些信号
     void portBound();
     void portUnbound();
     void dataReceived(const QByteArray &data, const QString &senderHost, quint16 senderPort);
+
+protected:
+    TrafficStats *m_trafficStats;
 };
 
 #endif // IUDPMANAGER_H
\ No newline at end of file
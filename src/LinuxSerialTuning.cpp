@@ -0,0 +1,73 @@
+#include "LinuxSerialTuning.h"
+
+#ifdef Q_OS_LINUX
+
+#include <asm/ioctls.h>
+#include <asm/termbits.h>
+#include <linux/serial.h>
+#include <cerrno>
+#include <cstring>
+
+// <sys/ioctl.h> 会间接包含 glibc 的 termios 定义，与 <asm/termbits.h> 冲突，这里直接声明
+extern "C" int ioctl(int fd, unsigned long request, ...) noexcept;
+
+namespace {
+
+QString errnoText(const char *what)
+{
+    return QString("%1 失败: %2").arg(what, QString::fromLocal8Bit(std::strerror(errno)));
+}
+
+} // namespace
+
+namespace LinuxSerialTuning {
+
+bool setCustomBaudRate(int fd, qint32 baudRate, qint32 *actualBaudRate, QString *error)
+{
+    struct termios2 tio;
+    if (ioctl(fd, TCGETS2, &tio) < 0) {
+        if (error) *error = errnoText("TCGETS2");
+        return false;
+    }
+
+    // 输入、输出速率都改为 BOTHER，由 c_ispeed / c_ospeed 直接给出数值
+    tio.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+    tio.c_cflag |= BOTHER | (BOTHER << IBSHIFT);
+    tio.c_ispeed = static_cast<speed_t>(baudRate);
+    tio.c_ospeed = static_cast<speed_t>(baudRate);
+    if (ioctl(fd, TCSETS2, &tio) < 0) {
+        if (error) *error = errnoText("TCSETS2");
+        return false;
+    }
+
+    // 驱动会把速率取整到分频器能达到的值，读回来交给调用方判断误差
+    if (ioctl(fd, TCGETS2, &tio) < 0) {
+        if (error) *error = errnoText("TCGETS2");
+        return false;
+    }
+    if (actualBaudRate) *actualBaudRate = static_cast<qint32>(tio.c_ospeed);
+    return true;
+}
+
+bool setLowLatency(int fd, bool enable, QString *error)
+{
+    struct serial_struct serial;
+    if (ioctl(fd, TIOCGSERIAL, &serial) < 0) {
+        if (error) *error = errnoText("TIOCGSERIAL");
+        return false;
+    }
+    if (enable) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+    } else {
+        serial.flags &= ~ASYNC_LOW_LATENCY;
+    }
+    if (ioctl(fd, TIOCSSERIAL, &serial) < 0) {
+        if (error) *error = errnoText("TIOCSSERIAL");
+        return false;
+    }
+    return true;
+}
+
+} // namespace LinuxSerialTuning
+
+#endif // Q_OS_LINUX
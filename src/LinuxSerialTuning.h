@@ -0,0 +1,24 @@
+#ifndef LINUXSERIALTUNING_H
+#define LINUXSERIALTUNING_H
+
+#include <QtGlobal>
+#include <QString>
+
+#ifdef Q_OS_LINUX
+
+// Linux 串口的底层设置，直接作用于已打开串口的文件描述符 (QSerialPort::handle())。
+// 单独放在一个编译单元里：<asm/termbits.h> 与 glibc 的 <termios.h> 不能同时包含
+namespace LinuxSerialTuning {
+
+// 用 termios2 + BOTHER 设置任意波特率 (例如 FTDI 的 6M、12M)，
+// 设置后读回驱动实际采用的值写入 actualBaudRate
+bool setCustomBaudRate(int fd, qint32 baudRate, qint32 *actualBaudRate, QString *error);
+
+// 设置或清除 ASYNC_LOW_LATENCY。ftdi_sio 等 USB 转串口驱动据此把延迟定时器从 16ms 降到 1ms
+bool setLowLatency(int fd, bool enable, QString *error);
+
+} // namespace LinuxSerialTuning
+
+#endif // Q_OS_LINUX
+
+#endif // LINUXSERIALTUNING_H
@@ -0,0 +1,675 @@
+// 必须先包含 LinuxTcpServerManager.h (它又包含了 ITcpServerManager.h)
+// 这样 Q_OS_LINUX 宏才会被定义
+#include "LinuxTcpServerManager.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QDebug>
+#include "TrafficStats.h"
+#include <deque>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+constexpr quint64 kWakeupId = ~quint64(0);            // epoll_event.data.u64 的保留值，客户端句柄从 1 开始递增
+constexpr quint64 kListenId = ~quint64(0) - 1;
+constexpr int kMaxEvents = 256;
+constexpr int kListenBacklog = 4096;
+constexpr int kAcceptBatch = 32;                       // 每次唤醒最多接受的连接数，其余留给其他线程
+constexpr qsizetype kReadChunkSize = 64 * 1024;
+constexpr qsizetype kReadBudget = 256 * 1024;          // 每个客户端每轮最多读取的字节数，保证公平
+constexpr qsizetype kFlushBytes = 256 * 1024;          // 单个客户端积累到这么多时立即上报
+constexpr qint64 kFlushIntervalNs = 20 * 1000 * 1000;  // 接收数据最多聚合 20ms
+constexpr qint64 kMaxInFlightBytes = 64 * 1024 * 1024; // 界面线程积压超过此值时暂停读取，交给 TCP 流控
+constexpr int kThrottlePollMs = 5;
+constexpr qint64 kAcceptRetryNs = 100 * 1000 * 1000;
+constexpr qint64 kFdWarningIntervalNs = 1000LL * 1000 * 1000;
+
+QString formatPeer(const sockaddr_storage &address) {
+    char host[INET6_ADDRSTRLEN] = {};
+    quint16 port = 0;
+    if (address.ss_family == AF_INET6) {
+        const sockaddr_in6 &v6 = reinterpret_cast<const sockaddr_in6 &>(address);
+        port = ntohs(v6.sin6_port);
+        if (IN6_IS_ADDR_V4MAPPED(&v6.sin6_addr)) {
+            // 双栈监听时 IPv4 客户端显示为普通的点分地址
+            inet_ntop(AF_INET, &v6.sin6_addr.s6_addr[12], host, sizeof(host));
+        } else {
+            inet_ntop(AF_INET6, &v6.sin6_addr, host, sizeof(host));
+        }
+    } else {
+        const sockaddr_in &v4 = reinterpret_cast<const sockaddr_in &>(address);
+        port = ntohs(v4.sin_port);
+        inet_ntop(AF_INET, &v4.sin_addr, host, sizeof(host));
+    }
+    return QString("%1:%2").arg(QString::fromLatin1(host)).arg(port);
+}
+
+// 写命令在 I/O 线程中才执行，fromRawData 构造的数组 (没有自己的存储，capacity 为 0) 可能在那之前就失效，
+// 此时复制一份；普通数组照常隐式共享
+QByteArray ownedData(const QByteArray &data) {
+    if (data.isEmpty() || data.capacity() > 0) return data;
+    return QByteArray(data.constData(), data.size());
+}
+
+// 每个客户端占用一个文件描述符，默认的软限制 (通常 1024) 远不够用
+void raiseFileLimit() {
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) return;
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+        getrlimit(RLIMIT_NOFILE, &limit);
+    }
+    if (limit.rlim_cur < 8192) {
+        qWarning() << "File descriptor limit is" << limit.rlim_cur << ", raise ulimit -n to serve thousands of TCP clients";
+    }
+}
+}
+
+// 写队列中的一项。群发时各客户端的队列引用同一个隐式共享的 QByteArray，不复制数据
+struct TxItem {
+    QByteArray data;
+    quint64 sendId;                    // 0 表示普通的 writeData
+};
+
+struct TcpEpollWorker::Connection {
+    int fd = -1;
+    quint64 id = 0;
+    QString clientInfo;
+    TrafficStats::PeerHandle statsPeer; // 接受连接时查找一次，收发时只更新原子计数
+    QByteArray rx;                     // 尚未上报的接收数据
+    std::deque<TxItem> tx;
+    qsizetype txOffset = 0;            // tx.front() 中已写出的字节数
+    QList<quint64> completedSends;     // 尚未上报的已完成群发
+    std::shared_ptr<std::atomic<qint64>> pendingBytes;
+    qint64 written = 0;                // 尚未上报的写出字节数
+    bool readable = false;             // 边沿触发：在读到 EAGAIN 之前一直可读
+    bool dirty = false;
+    bool closing = false;              // 写完队列后关闭
+};
+
+TcpEpollWorker::TcpEpollWorker(int index, int listenFd, TcpClientRegistry *registry, TrafficStats *trafficStats, QObject *parent)
+    : QObject(parent)
+    , m_index(index)
+    , m_listenFd(listenFd)
+    , m_epollFd(-1)
+    , m_wakeupFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK))
+    , m_stop(false)
+    , m_registry(registry)
+    , m_trafficStats(trafficStats)
+    , m_flushDeadlineNs(0)
+    , m_flushNow(false)
+    , m_acceptResumeNs(0)
+    , m_lastFdWarningNs(-kFdWarningIntervalNs)
+{
+    if (m_wakeupFd < 0) {
+        qWarning() << "Failed to create eventfd:" << strerror(errno);
+    }
+}
+
+TcpEpollWorker::~TcpEpollWorker() {
+    if (m_wakeupFd >= 0) close(m_wakeupFd);
+}
+
+void TcpEpollWorker::wakeUp() {
+    const quint64 one = 1;
+    ssize_t written = ::write(m_wakeupFd, &one, sizeof(one));
+    Q_UNUSED(written);
+}
+
+void TcpEpollWorker::post(Command command) {
+    {
+        QMutexLocker locker(&m_commandMutex);
+        m_commands.push_back(std::move(command));
+    }
+    wakeUp();
+}
+
+void TcpEpollWorker::stop() {
+    m_stop = true;
+    wakeUp();
+}
+
+TcpEpollWorker::Connection *TcpEpollWorker::connectionById(quint64 id) const {
+    return m_connections.value(id, nullptr);
+}
+
+void TcpEpollWorker::run() {
+    if (m_wakeupFd < 0) return;
+    m_epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epollFd < 0) {
+        qWarning() << "epoll_create1 failed:" << strerror(errno);
+        return;
+    }
+    m_clock.start();
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kWakeupId;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_wakeupFd, &ev);
+    // EPOLLEXCLUSIVE：一个新连接只唤醒一个 I/O 线程，避免惊群
+    ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+    ev.data.u64 = kListenId;
+    epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &ev);
+
+    epoll_event events[kMaxEvents];
+    while (!m_stop) {
+        qint64 nowNs = m_clock.nsecsElapsed();
+        const bool throttled = m_registry->inFlightBytes.load(std::memory_order_relaxed) > kMaxInFlightBytes;
+
+        // 根据待办事项决定 epoll_wait 的超时
+        int timeoutMs = -1;
+        auto limitTimeout = [&timeoutMs](qint64 remainingNs) {
+            const int ms = static_cast<int>(qBound<qint64>(0, (remainingNs + 999999) / 1000000, 1000));
+            timeoutMs = timeoutMs < 0 ? ms : qMin(timeoutMs, ms);
+        };
+        if (!m_batch.isEmpty() || m_flushNow) limitTimeout(0);
+        if (!m_dirty.empty()) limitTimeout(m_flushDeadlineNs - nowNs);
+        if (!m_readable.empty()) limitTimeout(throttled ? kThrottlePollMs * 1000000LL : 0);
+        if (m_acceptResumeNs > 0) limitTimeout(m_acceptResumeNs - nowNs);
+
+        const int n = epoll_wait(m_epollFd, events, kMaxEvents, timeoutMs);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            qWarning() << "epoll_wait failed:" << strerror(errno);
+            break;
+        }
+        if (m_stop) break;
+        nowNs = m_clock.nsecsElapsed();
+
+        for (int i = 0; i < n; ++i) {
+            const quint64 id = events[i].data.u64;
+            if (id == kWakeupId) {
+                quint64 counter = 0;
+                ssize_t bytes = ::read(m_wakeupFd, &counter, sizeof(counter));
+                Q_UNUSED(bytes);
+                continue;
+            }
+            if (id == kListenId) {
+                acceptClients(nowNs);
+                continue;
+            }
+            Connection *connection = connectionById(id);
+            if (!connection) continue;
+            if (events[i].events & (EPOLLOUT | EPOLLERR)) {
+                writeClient(connection, nowNs);
+                connection = connectionById(id);
+                if (!connection) continue;
+            }
+            if ((events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) && !connection->readable) {
+                // 先记下，统一在下面按读取额度处理；挂断也要先把剩余数据读完
+                connection->readable = true;
+                m_readable.push_back(id);
+            }
+        }
+
+        processCommands(nowNs);
+
+        if (m_acceptResumeNs > 0 && nowNs >= m_acceptResumeNs) {
+            m_acceptResumeNs = 0;
+            epoll_event listenEvent{};
+            listenEvent.events = EPOLLIN | EPOLLEXCLUSIVE;
+            listenEvent.data.u64 = kListenId;
+            epoll_ctl(m_epollFd, EPOLL_CTL_ADD, m_listenFd, &listenEvent);
+        }
+
+        // 界面线程积压过多时不读，数据留在内核缓冲里由 TCP 流控让客户端放慢
+        if (m_registry->inFlightBytes.load(std::memory_order_relaxed) <= kMaxInFlightBytes && !m_readable.empty()) {
+            std::vector<quint64> readable;
+            readable.swap(m_readable);
+            for (quint64 id : readable) {
+                Connection *connection = connectionById(id);
+                if (!connection) continue;
+                readClient(connection, nowNs);
+                connection = connectionById(id);
+                if (connection && connection->readable) m_readable.push_back(id); // 额度用完，下一轮继续
+            }
+        }
+
+        if (!m_batch.isEmpty() || m_flushNow || (!m_dirty.empty() && nowNs >= m_flushDeadlineNs)) {
+            flush();
+        }
+    }
+
+    // 退出前关闭本线程的所有连接，并把最后的数据和断开事件交出去；
+    // 之后再处理一次命令，还没执行的群发按失败上报
+    const QList<Connection *> connections = m_connections.values();
+    for (Connection *connection : connections) {
+        closeClient(connection);
+    }
+    processCommands(m_clock.nsecsElapsed());
+    flush();
+    close(m_epollFd);
+    m_epollFd = -1;
+}
+
+void TcpEpollWorker::acceptClients(qint64 nowNs) {
+    for (int accepted = 0; accepted < kAcceptBatch; ++accepted) {
+        sockaddr_storage address{};
+        socklen_t length = sizeof(address);
+        const int fd = accept4(m_listenFd, reinterpret_cast<sockaddr *>(&address), &length, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            if (errno == EMFILE || errno == ENFILE) {
+                // 监听套接字是水平触发的，不暂停的话会一直空转
+                if (nowNs - m_lastFdWarningNs >= kFdWarningIntervalNs) {
+                    qWarning() << "TCP server out of file descriptors, pausing accept:" << strerror(errno);
+                    m_lastFdWarningNs = nowNs;
+                }
+                epoll_ctl(m_epollFd, EPOLL_CTL_DEL, m_listenFd, nullptr);
+                m_acceptResumeNs = nowNs + kAcceptRetryNs;
+            } else if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                qWarning() << "accept4 failed:" << strerror(errno);
+            }
+            return;
+        }
+
+        // 交互式的小包不应被 Nagle 算法攒着
+        int enable = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+
+        Connection *connection = new Connection;
+        connection->fd = fd;
+        connection->id = m_registry->nextClientId.fetch_add(1, std::memory_order_relaxed);
+        connection->clientInfo = formatPeer(address);
+        if (m_trafficStats) {
+            connection->statsPeer = m_trafficStats->peer(CaptureWriter::Transport::TcpServer, connection->clientInfo, 0);
+        }
+        connection->pendingBytes = std::make_shared<std::atomic<qint64>>(0);
+
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = connection->id;
+        if (epoll_ctl(m_epollFd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            qWarning() << "epoll_ctl failed:" << strerror(errno);
+            close(fd);
+            delete connection;
+            continue;
+        }
+        m_connections.insert(connection->id, connection);
+        {
+            QMutexLocker locker(&m_registry->mutex);
+            m_registry->clients.insert(connection->id, { m_index, connection->pendingBytes });
+        }
+
+        TcpClientActivity activity;
+        activity.clientId = connection->id;
+        activity.clientInfo = connection->clientInfo;
+        activity.connected = true;
+        m_batch.append(activity);
+    }
+}
+
+void TcpEpollWorker::readClient(Connection *connection, qint64 nowNs) {
+    qsizetype budget = kReadBudget;
+    char buffer[kReadChunkSize];
+    while (budget > 0) {
+        const ssize_t received = recv(connection->fd, buffer, sizeof(buffer), 0);
+        if (received > 0) {
+            connection->rx.append(buffer, received);
+            budget -= received;
+            if (m_trafficStats) {
+                m_trafficStats->record(TrafficStats::Rx, connection->statsPeer, received);
+            }
+            markDirty(connection, nowNs);
+            if (connection->rx.size() >= kFlushBytes) m_flushNow = true;
+            continue;
+        }
+        if (received < 0 && errno == EINTR) continue;
+        if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            connection->readable = false;
+            return;
+        }
+        // 对端关闭 (0) 或出错
+        closeClient(connection);
+        return;
+    }
+}
+
+void TcpEpollWorker::writeClient(Connection *connection, qint64 nowNs) {
+    bool wroteSomething = false;
+    while (!connection->tx.empty()) {
+        const QByteArray &front = connection->tx.front().data;
+        const ssize_t sent = send(connection->fd, front.constData() + connection->txOffset,
+                                  front.size() - connection->txOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break; // 等待 EPOLLOUT
+            closeClient(connection);
+            return;
+        }
+        wroteSomething = true;
+        connection->txOffset += sent;
+        connection->written += sent;
+        connection->pendingBytes->fetch_sub(sent, std::memory_order_relaxed);
+        if (m_trafficStats) {
+            m_trafficStats->record(TrafficStats::Tx, connection->statsPeer, sent);
+        }
+        if (connection->txOffset == front.size()) {
+            if (connection->tx.front().sendId != 0) connection->completedSends.append(connection->tx.front().sendId);
+            connection->tx.pop_front();
+            connection->txOffset = 0;
+        }
+    }
+
+    if (wroteSomething) {
+        markDirty(connection, nowNs);
+        // 写队列清空时立即上报 bytesWritten，让 FileSender 之类的发送方尽快补充数据
+        if (connection->tx.empty()) m_flushNow = true;
+    }
+    if (connection->closing && connection->tx.empty()) {
+        closeClient(connection);
+    }
+}
+
+void TcpEpollWorker::processCommands(qint64 nowNs) {
+    std::vector<Command> commands;
+    {
+        QMutexLocker locker(&m_commandMutex);
+        commands.swap(m_commands);
+    }
+
+    for (Command &command : commands) {
+        if (command.type == Command::WriteMany) {
+            for (quint64 id : command.ids) {
+                Connection *connection = connectionById(id);
+                if (!connection || connection->closing) {
+                    if (connection) connection->pendingBytes->fetch_sub(command.data.size(), std::memory_order_relaxed);
+                    failSend(id, command.sendId);
+                    continue;
+                }
+                const bool idle = connection->tx.empty();
+                connection->tx.push_back({ command.data, command.sendId });
+                if (idle) writeClient(connection, nowNs);
+            }
+            continue;
+        }
+        Connection *connection = connectionById(command.id);
+        if (!connection) continue; // 客户端已断开，提交时计入的待写字节随登记表项一起丢弃
+        if (command.type == Command::Close) {
+            connection->closing = true;
+            if (connection->tx.empty()) closeClient(connection);
+            continue;
+        }
+        if (connection->closing) {
+            connection->pendingBytes->fetch_sub(command.data.size(), std::memory_order_relaxed);
+            continue;
+        }
+        const bool idle = connection->tx.empty();
+        connection->tx.push_back({ std::move(command.data), 0 });
+        // 队列原来不空说明正在等 EPOLLOUT，追加即可
+        if (idle) writeClient(connection, nowNs);
+    }
+}
+
+void TcpEpollWorker::closeClient(Connection *connection) {
+    epoll_ctl(m_epollFd, EPOLL_CTL_DEL, connection->fd, nullptr);
+    close(connection->fd);
+    {
+        QMutexLocker locker(&m_registry->mutex);
+        m_registry->clients.remove(connection->id);
+    }
+    connection->pendingBytes->store(0, std::memory_order_relaxed);
+
+    TcpClientActivity activity;
+    activity.clientId = connection->id;
+    activity.data = std::move(connection->rx);
+    activity.bytesWritten = connection->written;
+    activity.closed = true;
+    activity.completedSends = std::move(connection->completedSends);
+    for (const TxItem &item : connection->tx) {
+        if (item.sendId != 0) activity.failedSends.append(item.sendId);
+    }
+    m_registry->inFlightBytes.fetch_add(activity.data.size(), std::memory_order_relaxed);
+    m_batch.append(activity);
+
+    m_connections.remove(connection->id);
+    delete connection;
+}
+
+void TcpEpollWorker::markDirty(Connection *connection, qint64 nowNs) {
+    if (connection->dirty) return;
+    connection->dirty = true;
+    if (m_dirty.empty()) m_flushDeadlineNs = nowNs + kFlushIntervalNs;
+    m_dirty.push_back(connection->id);
+}
+
+void TcpEpollWorker::flush() {
+    for (quint64 id : m_dirty) {
+        Connection *connection = connectionById(id);
+        if (!connection) continue; // 已关闭，数据随断开事件一起交出
+        connection->dirty = false;
+        if (connection->rx.isEmpty() && connection->written == 0 && connection->completedSends.isEmpty()) continue;
+        TcpClientActivity activity;
+        activity.clientId = connection->id;
+        activity.data = std::move(connection->rx);
+        activity.bytesWritten = connection->written;
+        activity.completedSends = std::move(connection->completedSends);
+        connection->rx = QByteArray();
+        connection->written = 0;
+        connection->completedSends.clear();
+        m_registry->inFlightBytes.fetch_add(activity.data.size(), std::memory_order_relaxed);
+        m_batch.append(activity);
+    }
+    m_dirty.clear();
+    m_flushNow = false;
+
+    if (!m_batch.isEmpty()) {
+        emit activity(m_batch);
+        m_batch.clear();
+    }
+}
+
+void TcpEpollWorker::failSend(quint64 clientId, quint64 sendId) {
+    TcpClientActivity activity;
+    activity.clientId = clientId;
+    activity.failedSends.append(sendId);
+    m_batch.append(activity);
+}
+
+
+// ===================================================================
+//  LinuxTcpServerManager Implementation
+// ===================================================================
+LinuxTcpServerManager::LinuxTcpServerManager(QObject *parent)
+    : ITcpServerManager(parent), m_ioThreadCount(0), m_listenFd(-1) {
+}
+
+LinuxTcpServerManager::~LinuxTcpServerManager() {
+    stopListening();
+}
+
+bool LinuxTcpServerManager::startListening(quint16 port) {
+    if (isListening()) return true;
+    raiseFileLimit();
+
+    // 优先双栈监听，与 QTcpServer 的 QHostAddress::Any 一致
+    int fd = socket(AF_INET6, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd >= 0) {
+        int v6Only = 0;
+        setsockopt(fd, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only));
+        int enable = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+        sockaddr_in6 addr{};
+        addr.sin6_family = AF_INET6;
+        addr.sin6_addr = in6addr_any;
+        addr.sin6_port = htons(port);
+        if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    if (fd < 0) {
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd >= 0) {
+            int enable = 1;
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_ANY);
+            addr.sin_port = htons(port);
+            if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+                close(fd);
+                fd = -1;
+            }
+        }
+    }
+    if (fd < 0 || listen(fd, kListenBacklog) != 0) {
+        qWarning() << "Failed to listen on TCP port" << port << ":" << strerror(errno);
+        if (fd >= 0) close(fd);
+        emit serverMessage("错误: 无法监听端口 " + QString::number(port));
+        return false;
+    }
+    m_listenFd = fd;
+    m_registry.inFlightBytes = 0;
+
+    const int threadCount = m_ioThreadCount > 0 ? m_ioThreadCount : qBound(1, QThread::idealThreadCount() / 2, 8);
+    for (int i = 0; i < threadCount; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("tcp-io-%1").arg(i));
+        TcpEpollWorker *worker = new TcpEpollWorker(i, m_listenFd, &m_registry, m_trafficStats);
+        worker->moveToThread(thread);
+        connect(thread, &QThread::started, worker, &TcpEpollWorker::run);
+        connect(worker, &TcpEpollWorker::activity, this, &LinuxTcpServerManager::onActivity);
+        m_threads.push_back(thread);
+        m_workers.push_back(worker);
+        thread->start();
+    }
+
+    emit serverMessage(QString("服务器开始监听端口: %1 (epoll, %2 个 I/O 线程)").arg(port).arg(threadCount));
+    return true;
+}
+
+void LinuxTcpServerManager::stopListening() {
+    if (!isListening()) return;
+
+    for (TcpEpollWorker *worker : m_workers) {
+        worker->stop();
+    }
+    for (QThread *thread : m_threads) {
+        thread->quit();
+        thread->wait();
+    }
+    {
+        // 先清空登记表，之后的 writeData 不会再碰到已删除的工作对象
+        QMutexLocker locker(&m_registry.mutex);
+        m_registry.clients.clear();
+        for (TcpEpollWorker *worker : m_workers) delete worker;
+        m_workers.clear();
+    }
+    for (QThread *thread : m_threads) delete thread;
+    m_threads.clear();
+
+    close(m_listenFd);
+    m_listenFd = -1;
+
+    // 工作线程退出时交出的断开事件还在队列中，直接在这里通知，之后到达的批次会因客户端未登记而忽略
+    const QList<quint64> clients = m_clientInfos.keys();
+    m_clientInfos.clear();
+    for (quint64 clientId : clients) {
+        emit clientDisconnected(clientId);
+    }
+    emit serverMessage("服务器已停止监听");
+}
+
+bool LinuxTcpServerManager::postCommand(quint64 clientId, TcpEpollWorker::Command::Type type, const QByteArray &data) {
+    QMutexLocker locker(&m_registry.mutex);
+    auto it = m_registry.clients.constFind(clientId);
+    if (it == m_registry.clients.constEnd()) return false;
+    if (type == TcpEpollWorker::Command::Write) {
+        it->pendingBytes->fetch_add(data.size(), std::memory_order_relaxed);
+    }
+    m_workers[it->worker]->post({ type, clientId, data });
+    return true;
+}
+
+void LinuxTcpServerManager::writeData(const QByteArray &data, quint64 clientId) {
+    if (data.isEmpty()) return;
+    postCommand(clientId, TcpEpollWorker::Command::Write, ownedData(data));
+}
+
+void LinuxTcpServerManager::queueMulticast(quint64 sendId, const QByteArray &rawData, const QList<quint64> &clientIds) {
+    // 按所在 I/O 线程分组，每个线程只收到一条命令，所有客户端的写队列共享同一份 data
+    const QByteArray data = ownedData(rawData);
+    std::vector<std::vector<quint64>> perWorker(m_workers.size());
+    QList<quint64> finished;
+    {
+        QMutexLocker locker(&m_registry.mutex);
+        for (quint64 clientId : clientIds) {
+            auto it = m_registry.clients.constFind(clientId);
+            if (it == m_registry.clients.constEnd() || data.isEmpty()) {
+                finished.append(clientId);
+                continue;
+            }
+            it->pendingBytes->fetch_add(data.size(), std::memory_order_relaxed);
+            perWorker[it->worker].push_back(clientId);
+        }
+        for (size_t i = 0; i < perWorker.size(); ++i) {
+            if (perWorker[i].empty()) continue;
+            m_workers[i]->post({ TcpEpollWorker::Command::WriteMany, 0, data, sendId, std::move(perWorker[i]) });
+        }
+    }
+    // 空数据对在线的客户端直接算完成
+    for (quint64 clientId : finished) {
+        reportCompletion(sendId, clientId, data.isEmpty() && m_clientInfos.contains(clientId));
+    }
+}
+
+void LinuxTcpServerManager::disconnectClient(quint64 clientId) {
+    postCommand(clientId, TcpEpollWorker::Command::Close, QByteArray());
+}
+
+bool LinuxTcpServerManager::isListening() const {
+    return m_listenFd >= 0;
+}
+
+qint64 LinuxTcpServerManager::bytesToWrite(quint64 clientId) const {
+    QMutexLocker locker(&m_registry.mutex);
+    auto it = m_registry.clients.constFind(clientId);
+    return it == m_registry.clients.constEnd() ? 0 : it->pendingBytes->load(std::memory_order_relaxed);
+}
+
+QString LinuxTcpServerManager::clientInfo(quint64 clientId) const {
+    return m_clientInfos.value(clientId);
+}
+
+void LinuxTcpServerManager::onActivity(const QList<TcpClientActivity> &batch) {
+    for (const TcpClientActivity &activity : batch) {
+        m_registry.inFlightBytes.fetch_sub(activity.data.size(), std::memory_order_relaxed);
+        // 群发完成情况与客户端是否仍登记无关，停止监听后到达的也要上报
+        for (quint64 sendId : activity.completedSends) {
+            reportCompletion(sendId, activity.clientId, true);
+        }
+        for (quint64 sendId : activity.failedSends) {
+            reportCompletion(sendId, activity.clientId, false);
+        }
+        if (activity.connected && isListening()) {
+            m_clientInfos.insert(activity.clientId, activity.clientInfo);
+            emit clientConnected(activity.clientId, activity.clientInfo);
+        }
+        if (!m_clientInfos.contains(activity.clientId)) continue;
+        if (!activity.data.isEmpty()) {
+            emit dataReceived(activity.data, activity.clientId);
+        }
+        if (activity.bytesWritten > 0) {
+            emit bytesWritten(activity.bytesWritten, activity.clientId);
+        }
+        if (activity.closed) {
+            // 先发信号再删除，槽函数里仍能查到 clientInfo
+            emit clientDisconnected(activity.clientId);
+            m_clientInfos.remove(activity.clientId);
+        }
+    }
+}
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,153 @@
+#ifndef LINUXTCPSERVERMANAGER_H
+#define LINUXTCPSERVERMANAGER_H
+
+// 与 LinuxUdpManager.h 相同：先包含 ITcpServerManager.h，Q_OS_LINUX 宏才会被定义
+#include "ITcpServerManager.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMetaType>
+#include <QMutex>
+#include <QThread>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+// 一个客户端在一个聚合周期内的活动，I/O 线程按发生顺序批量交给管理器
+struct TcpClientActivity {
+    quint64 clientId = 0;
+    QString clientInfo;          // 只在新连接时填写
+    bool connected = false;      // 新连接，先于本条的数据处理
+    QByteArray data;             // 聚合后的接收数据，可为空
+    qint64 bytesWritten = 0;     // 本周期写入内核的字节数
+    bool closed = false;         // 连接已关闭，在本条的数据之后处理
+    QList<quint64> completedSends; // 已全部写入内核的群发编号
+    QList<quint64> failedSends;    // 因断开未能写完的群发编号
+};
+Q_DECLARE_METATYPE(TcpClientActivity)
+
+// I/O 线程与管理器共享的客户端登记表，writeData / bytesToWrite 据此找到客户端所在的线程
+struct TcpClientRegistry {
+    struct Entry {
+        int worker;
+        std::shared_ptr<std::atomic<qint64>> pendingBytes; // 已提交但尚未写入内核的字节数
+    };
+
+    mutable QMutex mutex;
+    QHash<quint64, Entry> clients;        // 键为客户端句柄
+    std::atomic<quint64> nextClientId{1}; // 各 I/O 线程共用，句柄在管理器生命周期内不重复
+    std::atomic<qint64> inFlightBytes{0}; // 已交给界面线程但尚未分发的接收字节数，超过上限时暂停读取
+};
+
+// 工作类：在独立线程中用 epoll (边沿触发) 处理一部分客户端。
+// 监听套接字以 EPOLLEXCLUSIVE 加入每个线程，新连接由被唤醒的线程接受并一直归它处理。
+// 接收数据按客户端聚合，每个周期 (或单个客户端积累较多时) 以一个批次交给管理器
+class TcpEpollWorker : public QObject
+{
+    Q_OBJECT
+public:
+    struct Command {
+        enum Type { Write, Close, WriteMany };
+        Type type;
+        quint64 id;
+        QByteArray data;
+        quint64 sendId = 0;          // 以下两项只用于 WriteMany
+        std::vector<quint64> ids;    // 本线程负责的目标客户端，共享同一份 data
+    };
+
+    TcpEpollWorker(int index, int listenFd, TcpClientRegistry *registry, TrafficStats *trafficStats, QObject *parent = nullptr);
+    ~TcpEpollWorker();
+
+    // 可在任意线程调用
+    void post(Command command);
+    void stop();
+
+public slots:
+    void run();
+
+signals:
+    void activity(const QList<TcpClientActivity> &batch);
+
+private:
+    struct Connection;
+
+    void wakeUp();
+    void acceptClients(qint64 nowNs);
+    void readClient(Connection *connection, qint64 nowNs);
+    void writeClient(Connection *connection, qint64 nowNs);
+    void processCommands(qint64 nowNs);
+    void closeClient(Connection *connection);
+    void markDirty(Connection *connection, qint64 nowNs);
+    void flush();
+    void failSend(quint64 clientId, quint64 sendId);
+    Connection *connectionById(quint64 id) const;
+
+private:
+    int m_index;
+    int m_listenFd;
+    int m_epollFd;
+    int m_wakeupFd;               // eventfd，用于唤醒阻塞中的 epoll_wait
+    std::atomic<bool> m_stop;
+    TcpClientRegistry *m_registry;
+    TrafficStats *m_trafficStats; // 可为空
+
+    QMutex m_commandMutex;
+    std::vector<Command> m_commands;
+
+    // 以下只在 I/O 线程中访问
+    QHash<quint64, Connection *> m_connections; // 键为客户端句柄
+    std::vector<quint64> m_readable;  // 读取额度用完或因背压暂停、仍有数据可读的客户端
+    std::vector<quint64> m_dirty;     // 有待上报的接收数据或写出字节数的客户端
+    QList<TcpClientActivity> m_batch;
+    qint64 m_flushDeadlineNs;
+    bool m_flushNow;
+    qint64 m_acceptResumeNs;          // 文件描述符耗尽时暂停接受新连接，到时再恢复
+    qint64 m_lastFdWarningNs;
+    QElapsedTimer m_clock;
+};
+
+
+// 基于 epoll 的多线程 TCP 服务器，面向成千上万个并发客户端。
+// 界面线程只处理聚合后的批次，不再为每个 readyRead 排队，信号约定与 TcpServerManager 相同
+class LinuxTcpServerManager : public ITcpServerManager {
+    Q_OBJECT
+public:
+    explicit LinuxTcpServerManager(QObject *parent = nullptr);
+    ~LinuxTcpServerManager() override;
+
+    // I/O 线程数，0 表示按 CPU 核数自动选择；需在 startListening 之前设置
+    void setIoThreadCount(int count) { m_ioThreadCount = count; }
+
+    bool startListening(quint16 port) override;
+    void stopListening() override;
+    void writeData(const QByteArray &data, quint64 clientId) override;
+    void disconnectClient(quint64 clientId) override;
+    bool isListening() const override;
+    qint64 bytesToWrite(quint64 clientId) const override;
+    // 只能在本对象所在线程调用
+    QString clientInfo(quint64 clientId) const override;
+    QList<quint64> clientIds() const override { return m_clientInfos.keys(); }
+
+protected:
+    void queueMulticast(quint64 sendId, const QByteArray &data, const QList<quint64> &clientIds) override;
+
+private slots:
+    void onActivity(const QList<TcpClientActivity> &batch);
+
+private:
+    bool postCommand(quint64 clientId, TcpEpollWorker::Command::Type type, const QByteArray &data);
+
+private:
+    int m_ioThreadCount;
+    int m_listenFd;
+    TcpClientRegistry m_registry;
+    std::vector<QThread *> m_threads;
+    std::vector<TcpEpollWorker *> m_workers;
+    QHash<quint64, QString> m_clientInfos; // 已发出 clientConnected 的客户端，只在本对象线程中访问
+};
+
+#endif // Q_OS_LINUX
+#endif // LINUXTCPSERVERMANAGER_H
@@ -0,0 +1,307 @@
+// 必须先包含 LinuxUdpManager.h (它又包含了 IUdpManager.h)
+// 这样 Q_OS_LINUX 宏才会被定义
+#include "LinuxUdpManager.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QDebug>
+#include "TrafficStats.h"
+#include <vector>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+
+namespace {
+constexpr int kBatchSize = 64;                       // 每次 recvmmsg 最多取出的数据报数量
+constexpr int kMaxDatagramSize = 65535;              // Max UDP packet size
+constexpr int kReceiveBufferSize = 32 * 1024 * 1024; // 32MB 内核接收缓冲
+}
+
+UdpMmsgReceiverWorker::UdpMmsgReceiverWorker(int socketFd, int wakeupFd, TrafficStats *trafficStats, QObject* parent)
+    : QObject(parent), m_socket(socketFd), m_wakeupFd(wakeupFd), m_stop(false), m_lastDropCount(0)
+    , m_trafficStats(trafficStats) {}
+
+UdpMmsgReceiverWorker::~UdpMmsgReceiverWorker() {}
+
+void UdpMmsgReceiverWorker::stopReceiving() {
+    m_stop = true;
+    // 写 eventfd 使 epoll_wait 立即返回，无需等待超时
+    const quint64 one = 1;
+    ssize_t written = ::write(m_wakeupFd, &one, sizeof(one));
+    Q_UNUSED(written);
+}
+
+void UdpMmsgReceiverWorker::startReceiving() {
+    int epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        qWarning() << "epoll_create1 failed:" << strerror(errno);
+        return;
+    }
+
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = m_socket;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, m_socket, &ev);
+    ev.data.fd = m_wakeupFd;
+    epoll_ctl(epollFd, EPOLL_CTL_ADD, m_wakeupFd, &ev);
+
+    // 一次性分配整批接收缓冲，循环中不再有任何堆分配（QByteArray 除外）
+    std::vector<char> buffers(static_cast<size_t>(kBatchSize) * kMaxDatagramSize);
+    std::vector<char> controls(static_cast<size_t>(kBatchSize) * CMSG_SPACE(sizeof(quint32)));
+    mmsghdr msgs[kBatchSize];
+    iovec iovecs[kBatchSize];
+    sockaddr_in senderAddrs[kBatchSize];
+
+    // 缓存上一个发送方的地址字符串，FPGA 场景下发送方几乎不变
+    in_addr_t lastAddr = INADDR_NONE;
+    QString lastHost;
+    // 同样缓存上一个发送方 (地址 + 端口) 的统计句柄，每个数据报只更新原子计数
+    in_addr_t statsAddr = INADDR_NONE;
+    in_port_t statsPort = 0;
+    TrafficStats::PeerHandle statsPeer;
+    QList<UdpDatagram> batch;
+
+    while (!m_stop) {
+        epoll_event events[2];
+        int n = epoll_wait(epollFd, events, 2, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            qWarning() << "epoll_wait failed:" << strerror(errno);
+            break;
+        }
+        if (m_stop) break;
+
+        // 非阻塞地把内核队列一次性读空
+        while (!m_stop) {
+            for (int i = 0; i < kBatchSize; ++i) {
+                iovecs[i].iov_base = buffers.data() + static_cast<size_t>(i) * kMaxDatagramSize;
+                iovecs[i].iov_len = kMaxDatagramSize;
+                std::memset(&msgs[i].msg_hdr, 0, sizeof(msghdr));
+                msgs[i].msg_hdr.msg_iov = &iovecs[i];
+                msgs[i].msg_hdr.msg_iovlen = 1;
+                msgs[i].msg_hdr.msg_name = &senderAddrs[i];
+                msgs[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+                msgs[i].msg_hdr.msg_control = controls.data() + static_cast<size_t>(i) * CMSG_SPACE(sizeof(quint32));
+                msgs[i].msg_hdr.msg_controllen = CMSG_SPACE(sizeof(quint32));
+            }
+
+            int received = recvmmsg(m_socket, msgs, kBatchSize, MSG_DONTWAIT, nullptr);
+            if (received < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                    qWarning() << "recvmmsg failed:" << strerror(errno);
+                    m_stop = true;
+                }
+                break;
+            }
+
+            batch.clear();
+            batch.reserve(received);
+            for (int i = 0; i < received; ++i) {
+                const sockaddr_in &senderAddr = senderAddrs[i];
+                if (senderAddr.sin_addr.s_addr != lastAddr) {
+                    char senderIp[INET_ADDRSTRLEN];
+                    inet_ntop(AF_INET, &senderAddr.sin_addr, senderIp, INET_ADDRSTRLEN);
+                    lastAddr = senderAddr.sin_addr.s_addr;
+                    lastHost = QString(senderIp);
+                }
+
+                // 检查内核报告的丢包计数
+                for (cmsghdr *cmsg = CMSG_FIRSTHDR(&msgs[i].msg_hdr); cmsg; cmsg = CMSG_NXTHDR(&msgs[i].msg_hdr, cmsg)) {
+                    if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SO_RXQ_OVFL) {
+                        quint32 dropCount;
+                        std::memcpy(&dropCount, CMSG_DATA(cmsg), sizeof(dropCount));
+                        if (dropCount != m_lastDropCount) {
+                            qWarning() << "[UDP recvmmsg] Kernel dropped" << (dropCount - m_lastDropCount) << "datagrams";
+                            m_lastDropCount = dropCount;
+                        }
+                    }
+                }
+
+                UdpDatagram datagram;
+                datagram.data = QByteArray(static_cast<const char*>(iovecs[i].iov_base), static_cast<int>(msgs[i].msg_len));
+                datagram.senderHost = lastHost;
+                datagram.senderPort = ntohs(senderAddr.sin_port);
+                if (m_trafficStats) {
+                    if (!statsPeer || senderAddr.sin_addr.s_addr != statsAddr || senderAddr.sin_port != statsPort) {
+                        statsAddr = senderAddr.sin_addr.s_addr;
+                        statsPort = senderAddr.sin_port;
+                        statsPeer = m_trafficStats->peer(CaptureWriter::Transport::Udp, lastHost, datagram.senderPort);
+                    }
+                    m_trafficStats->record(TrafficStats::Rx, statsPeer, msgs[i].msg_len);
+                }
+                batch.append(datagram);
+            }
+            if (!batch.isEmpty()) {
+                emit datagramsReady(batch);
+            }
+
+            if (received < kBatchSize) {
+                break; // 队列已读空，回到 epoll_wait
+            }
+        }
+    }
+
+    close(epollFd);
+}
+
+
+// ===================================================================
+//  LinuxUdpManager Implementation
+// ===================================================================
+LinuxUdpManager::LinuxUdpManager(QObject *parent)
+    : IUdpManager(parent), m_isBound(false), m_socket(-1), m_wakeupFd(-1), m_receiverThread(nullptr), m_worker(nullptr)
+    , m_destinationPort(0) {
+}
+
+LinuxUdpManager::~LinuxUdpManager() {
+    unbindPort();
+}
+
+bool LinuxUdpManager::bindPort(quint16 port) {
+    if (isBound()) return true;
+
+    m_socket = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+    if (m_socket < 0) {
+        qWarning() << "Failed to create UDP socket:" << strerror(errno);
+        return false;
+    }
+
+    // 设置接收缓冲区大小：优先使用 SO_RCVBUFFORCE 突破 rmem_max (需要 CAP_NET_ADMIN)
+    int bufferSize = kReceiveBufferSize;
+    if (setsockopt(m_socket, SOL_SOCKET, SO_RCVBUFFORCE, &bufferSize, sizeof(bufferSize)) != 0) {
+        setsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &bufferSize, sizeof(bufferSize));
+    }
+    int actualSize = 0;
+    socklen_t optLen = sizeof(actualSize);
+    getsockopt(m_socket, SOL_SOCKET, SO_RCVBUF, &actualSize, &optLen);
+    if (actualSize < bufferSize) {
+        qWarning() << "UDP receive buffer limited to" << actualSize << "bytes, consider raising net.core.rmem_max";
+    }
+
+    // 让内核在控制消息中附带丢包计数
+    int enable = 1;
+    setsockopt(m_socket, SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+
+    if (bind(m_socket, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        qWarning() << "Failed to bind UDP socket:" << strerror(errno);
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+
+    m_wakeupFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeupFd < 0) {
+        qWarning() << "Failed to create eventfd:" << strerror(errno);
+        close(m_socket);
+        m_socket = -1;
+        return false;
+    }
+
+    m_isBound = true;
+
+    // 创建并启动接收线程
+    m_receiverThread = new QThread(this);
+    m_worker = new UdpMmsgReceiverWorker(m_socket, m_wakeupFd, m_trafficStats);
+    m_worker->moveToThread(m_receiverThread);
+
+    connect(m_receiverThread, &QThread::started, m_worker, &UdpMmsgReceiverWorker::startReceiving);
+    connect(m_worker, &UdpMmsgReceiverWorker::datagramsReady, this, &LinuxUdpManager::onDatagramsReady);
+
+    m_receiverThread->start();
+
+    emit portBound();
+    return true;
+}
+
+void LinuxUdpManager::unbindPort() {
+    if (!isBound()) return;
+
+    if (m_receiverThread && m_receiverThread->isRunning()) {
+        m_worker->stopReceiving();
+        m_receiverThread->quit();
+        m_receiverThread->wait();
+    }
+
+    delete m_worker;
+    delete m_receiverThread;
+    m_worker = nullptr;
+    m_receiverThread = nullptr;
+
+    close(m_wakeupFd);
+    close(m_socket);
+    m_wakeupFd = -1;
+    m_socket = -1;
+    m_destination = UdpDestination();
+    m_isBound = false;
+    emit portUnbound();
+}
+
+// 在管理器线程中把一批数据报逐个交出，接收方看到的仍是每个数据报一次 dataReceived
+void LinuxUdpManager::onDatagramsReady(const QList<UdpDatagram> &datagrams) {
+    for (const UdpDatagram &datagram : datagrams) {
+        if (!m_isBound) break; // 接收方在处理中解除了绑定
+        emit dataReceived(datagram.data, datagram.senderHost, datagram.senderPort);
+    }
+}
+
+bool LinuxUdpManager::updateDestination(const QString &host, quint16 port) {
+    if (m_destination.isValid() && port == m_destinationPort && host == m_destinationHost) return true;
+    m_destinationHost = host;
+    m_destinationPort = port;
+    m_destinationStats = m_trafficStats ? m_trafficStats->peer(CaptureWriter::Transport::Udp, host, port) : TrafficStats::PeerHandle();
+    if (!m_destination.resolve(m_socket, host, port)) {
+        qWarning() << "Invalid UDP destination:" << host << port;
+        return false;
+    }
+    return true;
+}
+
+void LinuxUdpManager::writeData(const QByteArray &data, const QString &host, quint16 port) {
+    if (!isBound() || !updateDestination(host, port)) return;
+    if (m_destination.send(m_socket, data.constData(), data.size()) == UdpDestination::SendResult::Sent && m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, m_destinationStats, data.size());
+    }
+}
+
+void LinuxUdpManager::writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) {
+    if (!isBound() || segmentSize <= 0 || !updateDestination(host, port)) return;
+
+    // 套接字是阻塞的，发送缓冲满时内核会等待；只有 ENOBUFS (网卡队列满) 会返回部分结果
+    qsizetype offset = 0;
+    while (offset < data.size()) {
+        const qsizetype sent = m_destination.sendBatch(m_socket, data.constData() + offset, data.size() - offset, segmentSize);
+        if (sent < 0) {
+            qWarning() << "UDP batch send failed:" << UdpDestination::lastErrorString();
+            return;
+        }
+        if (sent == 0) {
+            QThread::usleep(50);
+        }
+        if (sent > 0 && m_trafficStats) {
+            m_trafficStats->record(TrafficStats::Tx, m_destinationStats, sent,
+                                   (sent + segmentSize - 1) / segmentSize);
+        }
+        offset += sent;
+    }
+}
+
+bool LinuxUdpManager::isBound() const {
+    return m_isBound;
+}
+
+qintptr LinuxUdpManager::socketDescriptor() const {
+    return m_isBound ? m_socket : -1;
+}
+
+#endif // Q_OS_LINUX
@@ -0,0 +1,79 @@
+#ifndef LINUXUDPMANAGER_H
+#define LINUXUDPMANAGER_H
+
+// 与 WinSockUdpManager.h 相同：先包含 IUdpManager.h，Q_OS_LINUX 宏才会被定义
+#include "IUdpManager.h"
+
+#ifdef Q_OS_LINUX
+
+#include <QList>
+#include <QMetaType>
+#include <QThread>
+#include "TrafficStats.h"
+#include "UdpDestination.h"
+#include <atomic>
+
+// 一次 recvmmsg 取出的一个数据报
+struct UdpDatagram {
+    QByteArray data;
+    QString senderHost;
+    quint16 senderPort = 0;
+};
+Q_DECLARE_METATYPE(UdpDatagram)
+
+// 工作类：在独立线程中通过 epoll 等待，并用 recvmmsg 批量读取数据报
+class UdpMmsgReceiverWorker : public QObject
+{
+    Q_OBJECT
+public:
+    UdpMmsgReceiverWorker(int socketFd, int wakeupFd, TrafficStats *trafficStats, QObject* parent = nullptr);
+    ~UdpMmsgReceiverWorker();
+public slots:
+    void startReceiving();
+    void stopReceiving();
+signals:
+    // 每次 recvmmsg 发出一次，整批数据报只产生一个跨线程事件
+    void datagramsReady(const QList<UdpDatagram> &datagrams);
+private:
+    int m_socket;
+    int m_wakeupFd;               // eventfd，用于唤醒阻塞中的 epoll_wait
+    std::atomic<bool> m_stop;
+    quint32 m_lastDropCount;      // SO_RXQ_OVFL 报告的内核累计丢包数
+    TrafficStats *m_trafficStats; // 可为空
+};
+
+
+class LinuxUdpManager : public IUdpManager {
+    Q_OBJECT
+public:
+    explicit LinuxUdpManager(QObject *parent = nullptr);
+    ~LinuxUdpManager() override;
+
+    bool bindPort(quint16 port) override;
+    void unbindPort() override;
+    void writeData(const QByteArray &data, const QString &host, quint16 port) override;
+    void writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) override;
+    bool isBound() const override;
+    qintptr socketDescriptor() const override;
+
+private slots:
+    void onDatagramsReady(const QList<UdpDatagram> &datagrams);
+
+private:
+    bool m_isBound;
+    int m_socket;
+    int m_wakeupFd;
+    QThread* m_receiverThread;
+    UdpMmsgReceiverWorker* m_worker;
+
+    // 目标地址缓存，绑定后首次发送时解析，目标不变时不再重复解析
+    UdpDestination m_destination;
+    QString m_destinationHost;
+    quint16 m_destinationPort;
+    TrafficStats::PeerHandle m_destinationStats; // 目标变化时重新查找
+
+    bool updateDestination(const QString &host, quint16 port);
+};
+
+#endif // Q_OS_LINUX
+#endif // LINUXUDPMANAGER_H
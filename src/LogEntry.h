@@ -0,0 +1,17 @@
+#ifndef LOGENTRY_H
+#define LOGENTRY_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+struct LogEntry {
+    enum Direction { In, Out };
+
+    QDateTime timestamp;
+    Direction direction;
+    QByteArray rawData;
+    QString sourceInfo;
+};
+
+#endif // LOGENTRY_H
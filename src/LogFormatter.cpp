@@ -0,0 +1,169 @@
+#include "LogFormatter.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define LOGFMT_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(LOGFMT_HAS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LOGFMT_TARGET_SSSE3 __attribute__((target("ssse3")))
+#else
+#define LOGFMT_TARGET_SSSE3
+#endif
+
+namespace LogFormatter {
+
+namespace {
+
+const char16_t kHexDigits[] = u"0123456789ABCDEF";
+
+// 十进制查找表：每个字节对应最多 3 位数字加一个空格，整项 8 字节一次拷贝
+struct DecimalEntry {
+    char16_t chars[4];
+    qsizetype length; // 含末尾空格
+};
+
+std::array<DecimalEntry, 256> buildDecimalTable() {
+    std::array<DecimalEntry, 256> table{};
+    for (int value = 0; value < 256; ++value) {
+        DecimalEntry &entry = table[static_cast<size_t>(value)];
+        int n = 0;
+        if (value >= 100) entry.chars[n++] = static_cast<char16_t>(u'0' + value / 100);
+        if (value >= 10) entry.chars[n++] = static_cast<char16_t>(u'0' + value / 10 % 10);
+        entry.chars[n++] = static_cast<char16_t>(u'0' + value % 10);
+        entry.chars[n++] = u' ';
+        entry.length = n;
+    }
+    return table;
+}
+
+const std::array<DecimalEntry, 256> &decimalTable() {
+    static const std::array<DecimalEntry, 256> table = buildDecimalTable();
+    return table;
+}
+
+#ifdef LOGFMT_HAS_X86
+
+// 每次处理 16 字节，输出 48 个 UTF-16 字符 ("HL " x 16)：
+// pshufb 查表得到高/低半字节的 ASCII，交错后再用三组固定的重排掩码插入空格并扩展为 16 位
+LOGFMT_TARGET_SSSE3 qsizetype writeHexSsse3(const uchar *data, qsizetype len, char16_t *out) {
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+    const __m128i nibbleMask = _mm_set1_epi8(0x0F);
+    const char Z = static_cast<char>(0x80); // pshufb 置零
+    const __m128i shuffle0 = _mm_setr_epi8(0, Z, 1, Z, Z, Z, 2, Z, 3, Z, Z, Z, 4, Z, 5, Z);
+    const __m128i shuffle1 = _mm_setr_epi8(Z, Z, 6, Z, 7, Z, Z, Z, 8, Z, 9, Z, Z, Z, 10, Z);
+    const __m128i shuffle2 = _mm_setr_epi8(11, Z, Z, Z, 12, Z, 13, Z, Z, Z, 14, Z, 15, Z, Z, Z);
+    const __m128i space0 = _mm_setr_epi16(0, 0, 0x20, 0, 0, 0x20, 0, 0);
+    const __m128i space1 = _mm_setr_epi16(0x20, 0, 0, 0x20, 0, 0, 0x20, 0);
+    const __m128i space2 = _mm_setr_epi16(0, 0x20, 0, 0, 0x20, 0, 0, 0x20);
+
+    qsizetype i = 0;
+    for (; i + 16 <= len; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i hi = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(v, 4), nibbleMask));
+        const __m128i lo = _mm_shuffle_epi8(digits, _mm_and_si128(v, nibbleMask));
+        const __m128i first = _mm_unpacklo_epi8(hi, lo);   // 字节 0-7 的 16 个字符
+        const __m128i second = _mm_unpackhi_epi8(hi, lo);  // 字节 8-15 的 16 个字符
+
+        __m128i *dst = reinterpret_cast<__m128i *>(out + i * 3);
+        _mm_storeu_si128(dst + 0, _mm_or_si128(_mm_shuffle_epi8(first, shuffle0), space0));
+        _mm_storeu_si128(dst + 1, _mm_or_si128(_mm_shuffle_epi8(first, shuffle1), space1));
+        _mm_storeu_si128(dst + 2, _mm_or_si128(_mm_shuffle_epi8(first, shuffle2), space2));
+        _mm_storeu_si128(dst + 3, _mm_or_si128(_mm_shuffle_epi8(second, shuffle0), space0));
+        _mm_storeu_si128(dst + 4, _mm_or_si128(_mm_shuffle_epi8(second, shuffle1), space1));
+        _mm_storeu_si128(dst + 5, _mm_or_si128(_mm_shuffle_epi8(second, shuffle2), space2));
+    }
+    if (i < len) {
+        writeHexScalar(data + i, len - i, out + i * 3);
+    }
+    return len > 0 ? len * 3 - 1 : 0;
+}
+
+bool cpuHasSsse3() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 9)) != 0;
+#else
+    return __builtin_cpu_supports("ssse3");
+#endif
+}
+
+#endif // LOGFMT_HAS_X86
+
+typedef qsizetype (*HexFn)(const uchar *, qsizetype, char16_t *);
+
+struct KernelTable {
+    HexFn hex;
+    const char *name;
+};
+
+KernelTable selectKernels() {
+#ifdef LOGFMT_HAS_X86
+    if (cpuHasSsse3()) {
+        return { writeHexSsse3, "ssse3" };
+    }
+#endif
+    return { writeHexScalar, "scalar" };
+}
+
+const KernelTable &kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+} // namespace
+
+qsizetype writeHexScalar(const uchar *data, qsizetype len, char16_t *out) {
+    for (qsizetype i = 0; i < len; ++i) {
+        out[i * 3] = kHexDigits[data[i] >> 4];
+        out[i * 3 + 1] = kHexDigits[data[i] & 0x0F];
+        out[i * 3 + 2] = u' ';
+    }
+    return len > 0 ? len * 3 - 1 : 0;
+}
+
+qsizetype writeHex(const uchar *data, qsizetype len, char16_t *out) {
+    return kernels().hex(data, len, out);
+}
+
+qsizetype writeDecimal(const uchar *data, qsizetype len, char16_t *out) {
+    const std::array<DecimalEntry, 256> &table = decimalTable();
+    char16_t *pos = out;
+    for (qsizetype i = 0; i < len; ++i) {
+        const DecimalEntry &entry = table[data[i]];
+        std::memcpy(pos, entry.chars, sizeof(entry.chars));
+        pos += entry.length;
+    }
+    return len > 0 ? (pos - out) - 1 : 0;
+}
+
+QString toHex(const QByteArray &data) {
+    if (data.isEmpty()) return QString();
+    QString result(data.size() * 3, Qt::Uninitialized);
+    const qsizetype written = writeHex(reinterpret_cast<const uchar *>(data.constData()), data.size(),
+                                       reinterpret_cast<char16_t *>(result.data()));
+    result.truncate(written);
+    return result;
+}
+
+QString toDecimal(const QByteArray &data) {
+    if (data.isEmpty()) return QString();
+    QString result(data.size() * 4, Qt::Uninitialized);
+    const qsizetype written = writeDecimal(reinterpret_cast<const uchar *>(data.constData()), data.size(),
+                                           reinterpret_cast<char16_t *>(result.data()));
+    result.truncate(written);
+    return result;
+}
+
+const char *activeKernelName() {
+    return kernels().name;
+}
+
+} // namespace LogFormatter
@@ -0,0 +1,29 @@
+#ifndef LOGFORMATTER_H
+#define LOGFORMATTER_H
+
+#include <QByteArray>
+#include <QString>
+
+// 日志十六进制/十进制格式化。结果一次性写入预先分配好的 QString，
+// 不再为每个字节创建临时字符串；十六进制在支持 SSSE3 的 CPU 上每次处理 16 字节。
+namespace LogFormatter {
+
+// "0A 1B FF"：大写、空格分隔，与 QByteArray::toHex(' ').toUpper() 相同
+QString toHex(const QByteArray &data);
+// "10 27 255"：空格分隔的十进制
+QString toDecimal(const QByteArray &data);
+
+// 写入调用方提供的缓冲区，返回写入的字符数 (不含末尾空格)。
+// writeHex 需要至少 len*3 个字符的空间，writeDecimal 需要至少 len*4 个字符
+qsizetype writeHex(const uchar *data, qsizetype len, char16_t *out);
+qsizetype writeDecimal(const uchar *data, qsizetype len, char16_t *out);
+
+// 标量参考实现
+qsizetype writeHexScalar(const uchar *data, qsizetype len, char16_t *out);
+
+// 当前选中的十六进制实现："ssse3" 或 "scalar"
+const char *activeKernelName();
+
+} // namespace LogFormatter
+
+#endif // LOGFORMATTER_H
@@ -0,0 +1,170 @@
+#include "LogModel.h"
+#include "LogSegmentStore.h"
+#include "LogFormatter.h"
+#include <QFileInfo>
+#include <QTimer>
+#include <QDebug>
+
+namespace {
+constexpr int kFlushIntervalMs = 50;      // 批量插入周期
+constexpr int kMaxPreviewBytes = 16384;   // 单行最多显示的字节数，超出部分只显示总长度
+constexpr int kTextCacheChars = 4 * 1024 * 1024; // 格式化文本缓存上限 (字符数，约 8 MB)
+}
+
+LogModel::LogModel(QObject *parent)
+    : QAbstractListModel(parent)
+    , m_store(std::make_unique<LogSegmentStore>())
+    , m_displayMode(DisplayMode::Ascii)
+    , m_memoryBudget(0)
+    , m_memoryUsed(0)
+    , m_spillFailed(false)
+    , m_textCache(kTextCacheChars)
+{
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushIntervalMs);
+    connect(m_flushTimer, &QTimer::timeout, this, &LogModel::flushPending);
+}
+
+LogModel::~LogModel() {
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_spilledHandles.size() + static_cast<qsizetype>(m_entries.size()));
+}
+
+LogEntry LogModel::entryAt(int row) const {
+    if (row < m_spilledHandles.size()) {
+        // 从内存映射中读回，rawData 直接引用映射内存
+        return m_store->read(m_spilledHandles.at(row));
+    }
+    return m_entries.at(static_cast<size_t>(row - m_spilledHandles.size()));
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return QVariant();
+    }
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole) {
+        return cachedText(index.row());
+    }
+    return QVariant();
+}
+
+QString LogModel::cachedText(int row) const {
+    // 行号在 clear() 之前保持不变 (转存只改变存储位置)，可以直接作为缓存键
+    const qint64 key = (qint64(row) << 2) | static_cast<qint64>(m_displayMode);
+    if (const QString *text = m_textCache.object(key)) {
+        return *text;
+    }
+    const QString text = formatEntry(entryAt(row), m_displayMode);
+    m_textCache.insert(key, new QString(text), qMax<qsizetype>(text.size(), 1));
+    return text;
+}
+
+qint64 LogModel::entryCost(const LogEntry &entry) {
+    return qint64(sizeof(LogEntry)) + entry.rawData.size() + qint64(entry.sourceInfo.size()) * 2;
+}
+
+void LogModel::setMemoryBudget(qint64 bytes) {
+    m_memoryBudget = bytes;
+    spillToBudget();
+}
+
+void LogModel::spillToBudget() {
+    if (m_memoryBudget <= 0 || m_spillFailed) return;
+
+    // 行号不变，只是存储位置从内存移到磁盘，因此无需通知视图
+    while (m_memoryUsed > m_memoryBudget && !m_entries.empty()) {
+        const LogEntry &oldest = m_entries.front();
+        const qint64 handle = m_store->append(oldest);
+        if (handle < 0) {
+            qWarning() << "[Log] 日志转存失败，后续条目将保留在内存中";
+            m_spillFailed = true;
+            return;
+        }
+        m_spilledHandles.append(handle);
+        m_memoryUsed -= entryCost(oldest);
+        m_entries.pop_front();
+    }
+}
+
+void LogModel::appendEntry(const LogEntry &entry) {
+    m_pending.append(entry);
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void LogModel::flushPending() {
+    if (m_pending.isEmpty()) return;
+
+    const int first = rowCount();
+    beginInsertRows(QModelIndex(), first, first + static_cast<int>(m_pending.size()) - 1);
+    for (const LogEntry &entry : m_pending) {
+        m_memoryUsed += entryCost(entry);
+        m_entries.push_back(entry);
+    }
+    endInsertRows();
+    m_pending.clear();
+
+    spillToBudget();
+}
+
+void LogModel::clear() {
+    m_flushTimer->stop();
+    beginResetModel();
+    m_entries.clear();
+    m_pending.clear();
+    m_spilledHandles.clear();
+    m_store->clear();
+    m_memoryUsed = 0;
+    m_spillFailed = false;
+    m_textCache.clear();
+    endResetModel();
+}
+
+void LogModel::setDisplayMode(DisplayMode mode) {
+    if (m_displayMode == mode) return;
+    m_displayMode = mode;
+    if (rowCount() > 0) {
+        emit dataChanged(index(0), index(rowCount() - 1), {Qt::DisplayRole, Qt::ToolTipRole});
+    }
+}
+
+QString LogModel::formatEntry(const LogEntry &entry, DisplayMode mode) {
+    QString displayText;
+    const bool isImage = (entry.sourceInfo == "Image Data");
+    if (isImage) {
+        displayText = QString("[Image Data: %1 bytes]").arg(entry.rawData.size());
+    } else if (!entry.sourceInfo.isEmpty() && QFileInfo(entry.sourceInfo).exists()) {
+        displayText = QString("[Video Data: %1 bytes, path: %2]").arg(entry.rawData.size()).arg(entry.sourceInfo);
+    } else {
+        const QByteArray preview = entry.rawData.left(kMaxPreviewBytes);
+        if (mode == DisplayMode::Ascii) {
+            displayText = QString::fromLocal8Bit(preview);
+            // 每条日志占一行，换行符以可见符号显示
+            displayText.replace(QLatin1String("\r\n"), QString(QChar(0x21B5)));
+            displayText.replace(QLatin1Char('\n'), QChar(0x21B5));
+            displayText.replace(QLatin1Char('\r'), QChar(0x21B5));
+        } else if (mode == DisplayMode::Hex) {
+            displayText = LogFormatter::toHex(preview);
+        } else { // Decimal
+            displayText = LogFormatter::toDecimal(preview);
+        }
+        if (entry.rawData.size() > kMaxPreviewBytes) {
+            displayText += QString(" ... [共 %1 字节]").arg(entry.rawData.size());
+        }
+    }
+
+    if (entry.direction == LogEntry::In) {
+        return QString("[%1] RX %2<- %3")
+                .arg(entry.timestamp.toString("HH:mm:ss.zzz"))
+                .arg(entry.sourceInfo)
+                .arg(displayText);
+    }
+    return QString("[%1] TX -> %2")
+            .arg(entry.timestamp.toString("HH:mm:ss.zzz"))
+            .arg(displayText);
+}
@@ -0,0 +1,69 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QVector>
+#include <deque>
+#include <memory>
+#include "LogEntry.h"
+
+class QTimer;
+class LogSegmentStore;
+
+// 收发日志的数据模型。视图只对可见行调用 data()，因此格式化开销与日志总量无关；
+// 新条目先进入待提交队列，由定时器批量插入，高频收包时视图每个周期只更新一次。
+//
+// 内存中的条目超过预算后，最旧的条目被转存到内存映射的磁盘段 (LogSegmentStore)，
+// 内存里只保留一个 8 字节的句柄；视图滚动到这些行时再从映射中读回。
+//
+// 格式化后的文本按 (行, 显示格式) 缓存，反复重绘或来回切换格式时不再重新格式化。
+class LogModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum class DisplayMode { Ascii, Hex, Decimal };
+
+    explicit LogModel(QObject *parent = nullptr);
+    ~LogModel() override;
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void appendEntry(const LogEntry &entry);
+    void clear();
+    LogEntry entryAt(int row) const;
+
+    // 切换显示格式只触发重绘，不会重建任何数据
+    void setDisplayMode(DisplayMode mode);
+    DisplayMode displayMode() const { return m_displayMode; }
+
+    // 内存预算 (字节)，0 表示不限制
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    qint64 memoryUsage() const { return m_memoryUsed; }
+
+    static QString formatEntry(const LogEntry &entry, DisplayMode mode);
+
+public slots:
+    void flushPending();
+
+private:
+    static qint64 entryCost(const LogEntry &entry);
+    QString cachedText(int row) const;
+    void spillToBudget();
+
+private:
+    QVector<qint64> m_spilledHandles;     // 已转存到磁盘的条目，对应最前面的行
+    std::deque<LogEntry> m_entries;       // 内存中的条目，紧接在转存条目之后
+    QVector<LogEntry> m_pending;          // 尚未通知视图的新条目
+    std::unique_ptr<LogSegmentStore> m_store;
+    QTimer *m_flushTimer;
+    DisplayMode m_displayMode;
+    qint64 m_memoryBudget;
+    qint64 m_memoryUsed;
+    bool m_spillFailed;                   // 磁盘写入失败后不再尝试转存
+    mutable QCache<qint64, QString> m_textCache; // 键: 行号 << 2 | 显示格式，开销按字符数计
+};
+
+#endif // LOGMODEL_H
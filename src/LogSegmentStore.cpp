@@ -0,0 +1,171 @@
+#include "LogSegmentStore.h"
+#include <QDir>
+#include <QStandardPaths>
+#include <QTemporaryFile>
+#include <QDebug>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <cerrno>
+#endif
+
+namespace {
+// 句柄 = 段号 << 40 | 段内偏移
+constexpr int kOffsetBits = 40;
+constexpr qint64 kOffsetMask = (qint64(1) << kOffsetBits) - 1;
+
+// 记录头：时间戳(8) 方向(1) 保留(1) 来源长度(2, UTF-16 单元) 数据长度(4)
+struct RecordHeader {
+    qint64 msecsSinceEpoch;
+    quint8 direction;
+    quint8 reserved;
+    quint16 sourceLength;
+    quint32 dataLength;
+};
+static_assert(sizeof(RecordHeader) == 16, "RecordHeader must stay packed");
+
+QString &configuredDirectory() {
+    static QString directory; // 为空表示使用缓存目录
+    return directory;
+}
+}
+
+QString LogSegmentStore::defaultDirectory() {
+    if (!configuredDirectory().isEmpty()) {
+        return configuredDirectory();
+    }
+    const QString cache = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    return cache.isEmpty() ? QDir::tempPath() : QDir(cache).filePath("logspill");
+}
+
+void LogSegmentStore::setDefaultDirectory(const QString &path) {
+    configuredDirectory() = path;
+}
+
+LogSegmentStore::LogSegmentStore(qint64 segmentSize)
+    : m_segmentSize(segmentSize)
+{
+}
+
+LogSegmentStore::~LogSegmentStore() {
+    clear();
+}
+
+bool LogSegmentStore::openSegment(qint64 minimumSize) {
+    Segment segment;
+    segment.size = qMax(m_segmentSize, minimumSize);
+    const QString directory = defaultDirectory();
+    QDir().mkpath(directory);
+    segment.file = std::make_unique<QTemporaryFile>(QDir(directory).filePath("NexusTerm_log_XXXXXX.seg"));
+    if (!segment.file->open() || !segment.file->resize(segment.size)) {
+        qWarning() << "[Log] 无法创建日志段文件:" << segment.file->errorString();
+        return false;
+    }
+    // resize 得到的是稀疏文件，之后写映射内存时才分配磁盘块，磁盘满会直接 SIGBUS
+    if (!reserveBlocks(segment.file.get(), segment.size)) {
+        qWarning() << "[Log] 磁盘空间不足，无法预留日志段:" << segment.file->fileName();
+        return false;
+    }
+    segment.map = segment.file->map(0, segment.size);
+    if (!segment.map) {
+        qWarning() << "[Log] 无法映射日志段文件:" << segment.file->errorString();
+        return false;
+    }
+    m_segments.push_back(std::move(segment));
+    return true;
+}
+
+bool LogSegmentStore::reserveBlocks(QTemporaryFile *file, qint64 size) {
+#ifdef Q_OS_LINUX
+    const int error = posix_fallocate(file->handle(), 0, size);
+    if (error == 0) {
+        return true;
+    }
+    if (error != EINVAL && error != EOPNOTSUPP) {
+        return false; // ENOSPC 等
+    }
+    // 文件系统不支持 fallocate，退回到逐块写零
+#endif
+    static const QByteArray zeros(1024 * 1024, '\0');
+    if (!file->seek(0)) {
+        return false;
+    }
+    for (qint64 written = 0; written < size; ) {
+        const qint64 chunk = qMin<qint64>(zeros.size(), size - written);
+        if (file->write(zeros.constData(), chunk) != chunk) {
+            return false;
+        }
+        written += chunk;
+    }
+    return file->flush();
+}
+
+qint64 LogSegmentStore::append(const LogEntry &entry) {
+    const qint64 sourceBytes = qint64(qMin<qsizetype>(entry.sourceInfo.size(), 0xFFFF)) * 2;
+    const qint64 recordSize = qint64(sizeof(RecordHeader)) + sourceBytes + entry.rawData.size();
+
+    if (m_segments.empty() || m_segments.back().used + recordSize > m_segments.back().size) {
+        if (!openSegment(recordSize)) {
+            return -1;
+        }
+    }
+
+    Segment &segment = m_segments.back();
+    const qint64 offset = segment.used;
+    uchar *dst = segment.map + offset;
+
+    RecordHeader header;
+    header.msecsSinceEpoch = entry.timestamp.toMSecsSinceEpoch();
+    header.direction = static_cast<quint8>(entry.direction);
+    header.reserved = 0;
+    header.sourceLength = static_cast<quint16>(sourceBytes / 2);
+    header.dataLength = static_cast<quint32>(entry.rawData.size());
+
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + sizeof(header), entry.sourceInfo.constData(), static_cast<size_t>(sourceBytes));
+    std::memcpy(dst + sizeof(header) + sourceBytes, entry.rawData.constData(), static_cast<size_t>(entry.rawData.size()));
+    segment.used += recordSize;
+
+    return (qint64(m_segments.size() - 1) << kOffsetBits) | offset;
+}
+
+LogEntry LogSegmentStore::read(qint64 handle) const {
+    if (handle < 0) {
+        return LogEntry();
+    }
+    const size_t segmentIndex = static_cast<size_t>(handle >> kOffsetBits);
+    const qint64 offset = handle & kOffsetMask;
+    if (segmentIndex >= m_segments.size()) {
+        return LogEntry();
+    }
+
+    const uchar *src = m_segments[segmentIndex].map + offset;
+    RecordHeader header;
+    std::memcpy(&header, src, sizeof(header));
+    src += sizeof(header);
+
+    LogEntry entry;
+    entry.timestamp = QDateTime::fromMSecsSinceEpoch(header.msecsSinceEpoch);
+    entry.direction = static_cast<LogEntry::Direction>(header.direction);
+    entry.sourceInfo = QString(reinterpret_cast<const QChar *>(src), header.sourceLength);
+    src += qint64(header.sourceLength) * 2;
+    entry.rawData = QByteArray::fromRawData(reinterpret_cast<const char *>(src), static_cast<qsizetype>(header.dataLength));
+    return entry;
+}
+
+void LogSegmentStore::clear() {
+    for (Segment &segment : m_segments) {
+        if (segment.map) {
+            segment.file->unmap(segment.map);
+        }
+    }
+    m_segments.clear(); // QTemporaryFile 析构时删除文件
+}
+
+qint64 LogSegmentStore::diskUsage() const {
+    qint64 total = 0;
+    for (const Segment &segment : m_segments) {
+        total += segment.size;
+    }
+    return total;
+}
@@ -0,0 +1,52 @@
+#ifndef LOGSEGMENTSTORE_H
+#define LOGSEGMENTSTORE_H
+
+#include "LogEntry.h"
+#include <QString>
+#include <vector>
+#include <memory>
+
+class QTemporaryFile;
+
+// 只追加的日志段存储：条目序列化后写入内存映射的临时文件段，
+// 读取时直接引用映射内存 (QByteArray::fromRawData)，由操作系统按需换入换出。
+// 每个段创建时就向文件系统预留全部磁盘块再整体映射，磁盘满时建段失败、append 返回 -1，
+// 而不是在写入映射内存时收到 SIGBUS。写满后新建下一个段；超过段大小的单条记录独占一个段。
+class LogSegmentStore {
+public:
+    explicit LogSegmentStore(qint64 segmentSize = 64 * 1024 * 1024);
+    ~LogSegmentStore();
+
+    // 段文件所在目录，只影响之后新建的段。默认是用户缓存目录 (QStandardPaths::CacheLocation)，
+    // 不用系统临时目录：它在很多发行版上是 tmpfs，转存的日志仍然占用内存
+    static QString defaultDirectory();
+    static void setDefaultDirectory(const QString &path);
+
+    LogSegmentStore(const LogSegmentStore &) = delete;
+    LogSegmentStore &operator=(const LogSegmentStore &) = delete;
+
+    // 追加一条记录，返回用于读取的句柄；磁盘空间不足等失败时返回 -1
+    qint64 append(const LogEntry &entry);
+    // 读取记录。rawData 直接指向映射内存，在 clear() 或析构前有效
+    LogEntry read(qint64 handle) const;
+    void clear();
+
+    qint64 diskUsage() const;
+
+private:
+    struct Segment {
+        std::unique_ptr<QTemporaryFile> file;
+        uchar *map = nullptr;
+        qint64 size = 0;
+        qint64 used = 0;
+    };
+
+    bool openSegment(qint64 minimumSize);
+    static bool reserveBlocks(QTemporaryFile *file, qint64 size);
+
+private:
+    qint64 m_segmentSize;
+    std::vector<Segment> m_segments;
+};
+
+#endif // LOGSEGMENTSTORE_H
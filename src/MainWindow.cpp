@@ -18,26 +18,66 @@
 #include <QDebug>
 #include <memory>
 #include <QApplication> 
+#include <QThread>
+#include <QSignalBlocker>
+#include <QTableWidget>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QIntValidator>
 
 #include "QtUdpManager.h"
+#include "TcpServerManager.h"
+#include "VideoStreamDecoder.h"
+#include "CaptureReplayer.h"
+#include "FileSender.h"
+#include "PacedUdpSender.h"
+#include "VideoSurfaceWidget.h"
+#include "TrafficStatsPanel.h"
+#include "TcpClientListModel.h"
+#include "LogSegmentStore.h"
 #ifdef Q_OS_WIN
 #include "WinSockUdpManager.h"
 #endif
+#ifdef Q_OS_LINUX
+#include "LinuxUdpManager.h"
+#include "LinuxTcpServerManager.h"
+#endif
+
+namespace {
+constexpr int kUdpBatchDatagrams = 64; // 无延时发送文件时每批交给 UDP 管理器的数据报数
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
     , ui(new Ui::MainWindow)
+    , m_trafficStats(std::make_unique<TrafficStats>())
     , m_serialManager(std::make_unique<SerialManager>(this))
     , m_tcpManager(std::make_unique<TcpManager>(this))
     , m_udpManager(nullptr) // UDP管理器在连接时才创建，先置空
-    , m_tcpServerManager(std::make_unique<TcpServerManager>(this))
+    , m_tcpServerManager(std::make_unique<TcpServerManager>(this)) // 开始监听时按选项重新创建
+    , m_captureWriter(std::make_unique<CaptureWriter>())
+    , m_sessionManager(std::make_unique<SessionManager>())
     , m_mediaPlayer(nullptr)
     , m_tempMediaFile(nullptr)
     , m_rxBytes(0)
     , m_txBytes(0)
-    , m_lastUdpSenderPort(0)
-    , m_fileSendOffset(0)
+    , m_rxLogModel(nullptr)
+    , m_txLogModel(nullptr)
+    , m_clientListModel(nullptr)
+    , m_framerTimer(nullptr)
+    , m_framerDeadlineNs(0)
+    , m_fileSender(nullptr)
+    , m_fileSendSegmentSize(0)
+    , m_pacedSendThread(nullptr)
+    , m_pacedUdpSender(nullptr)
+    , m_isPacedSending(false)
+    , m_pacedReportedBytes(0)
     , m_isUdpStreaming(false)
+    , m_videoThread(nullptr)
+    , m_videoDecoder(nullptr)
+    , m_isVideoReplay(false)
+    , m_replayThread(nullptr)
+    , m_captureReplayer(nullptr)
     , m_videoHeaderReceived(false)
     , m_videoStreamWidth(0)
     , m_videoStreamHeight(0)
@@ -57,6 +97,11 @@ MainWindow::MainWindow(QWidget *parent)
 
     initUI();
 
+    m_serialManager->setTrafficStats(m_trafficStats.get());
+    m_tcpManager->setTrafficStats(m_trafficStats.get());
+    ui->trafficStatsPanel->setTrafficStats(m_trafficStats.get());
+    ui->sessionsPanel->setSessionManager(m_sessionManager.get());
+
     // --- 连接信号和槽 ---
     connect(m_serialManager.get(), &SerialManager::dataReceived, this, &MainWindow::onSerialDataReceived);
     connect(m_serialManager.get(), &SerialManager::portOpened, this, &MainWindow::onPortOpened);
@@ -70,10 +115,7 @@ MainWindow::MainWindow(QWidget *parent)
 
     // UDP 管理器的信号槽在创建实例时再连接
 
-    connect(m_tcpServerManager.get(), &TcpServerManager::clientConnected, this, &MainWindow::onClientConnected);
-    connect(m_tcpServerManager.get(), &TcpServerManager::clientDisconnected, this, &MainWindow::onClientDisconnected);
-    connect(m_tcpServerManager.get(), &TcpServerManager::dataReceived, this, &MainWindow::onServerDataReceived);
-    connect(m_tcpServerManager.get(), &TcpServerManager::serverMessage, this, &MainWindow::onServerMessage);
+    // TCP 服务器管理器的信号槽在 FileSender 创建之后统一连接
     
     connect(m_autoSendTimer, &QTimer::timeout, this, &MainWindow::on_sendButton_clicked);
 
@@ -81,42 +123,108 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_portScanTimer, &QTimer::timeout, this, &MainWindow::updatePortList);
     m_portScanTimer->start(2000);
 
-    m_udpReassemblyTimer = new QTimer(this);
-    m_udpReassemblyTimer->setInterval(200);
-    m_udpReassemblyTimer->setSingleShot(true);
-    connect(m_udpReassemblyTimer, &QTimer::timeout, this, &MainWindow::onUdpReassemblyTimeout);
-
-    m_tcpReassemblyTimer = new QTimer(this);
-    m_tcpReassemblyTimer->setInterval(200);
-    m_tcpReassemblyTimer->setSingleShot(true);
-    connect(m_tcpReassemblyTimer, &QTimer::timeout, this, &MainWindow::onTcpReassemblyTimeout);
+    // 接收分帧：只有空闲间隔方式需要定时器，其他方式在消息的最后一个字节到达时就交出
+    m_framerClock.start();
+    m_framerTimer = new QTimer(this);
+    m_framerTimer->setSingleShot(true);
+    m_framerTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_framerTimer, &QTimer::timeout, this, &MainWindow::onFramerTimeout);
+    // 串口和 TCP 服务器默认按到达交出，不增加延迟；TCP 客户端保留原来 200ms 空闲间隔的合并行为
+    StreamFramer::Config idleGap;
+    idleGap.type = StreamFramer::Type::IdleGap;
+    m_framerSettings[SerialFramer] = { 0, QString(), StreamFramer::Config() };
+    m_framerSettings[TcpClientFramer] = { 1, QString(), idleGap };
+    m_framerSettings[TcpServerFramer] = { 0, QString(), StreamFramer::Config() };
+    for (int transport = 0; transport < FramerTransportCount; ++transport) {
+        resetFramers(transport);
+    }
+    showFramerSettings();
     
-    m_fileSendTimer = new QTimer(this);
-    connect(m_fileSendTimer, &QTimer::timeout, this, &MainWindow::sendFileChunk);
+    // 大文件流式发送，串口和 TCP 的写出进度驱动下一批数据
+    m_fileSender = new FileSender(this);
+    connect(m_fileSender, &FileSender::chunkSent, this, [this](const QByteArray &chunk) {
+        m_txBytes += chunk.size();
+        // UDP 批量发送时一个分块包含多个数据报，按数据报逐个抓包
+        const qsizetype segment = m_fileSendSegmentSize > 0 ? m_fileSendSegmentSize : chunk.size();
+        for (qsizetype offset = 0; offset < chunk.size(); offset += segment) {
+            captureSent(QByteArray::fromRawData(chunk.constData() + offset, qMin(segment, chunk.size() - offset)),
+                        m_fileSendCaptureTarget);
+        }
+    });
+    connect(m_fileSender, &FileSender::progress, this, &MainWindow::onFileSendProgress);
+    connect(m_fileSender, &FileSender::finished, this, &MainWindow::onFileSendFinished);
+    connect(m_serialManager.get(), &SerialManager::bytesWritten, m_fileSender, &FileSender::onBytesWritten);
+    connect(m_tcpManager.get(), &TcpManager::bytesWritten, m_fileSender, &FileSender::onBytesWritten);
+    connectTcpServerManager();
 
     connect(m_mediaPlayer, &QMediaPlayer::positionChanged, this, &MainWindow::updatePosition);
     connect(m_mediaPlayer, &QMediaPlayer::durationChanged, this, &MainWindow::updateDuration);
     connect(m_mediaPlayer, &QMediaPlayer::playbackStateChanged, this, &MainWindow::updatePlaybackState);
     
-    connect(ui->clientListWidget, &QListWidget::currentItemChanged, this, &MainWindow::updateControlsState);
+    connect(ui->clientListView->selectionModel(), &QItemSelectionModel::currentChanged, this, &MainWindow::updateControlsState);
+    connect(ui->clientListView->selectionModel(), &QItemSelectionModel::selectionChanged, this, &MainWindow::updateControlsState);
+    connect(ui->serverSendTargetComboBox, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::updateControlsState);
 
     m_fpsTimer = new QTimer(this);
     m_fpsTimer->setInterval(1000); // 1秒触发一次
     connect(m_fpsTimer, &QTimer::timeout, this, &MainWindow::updateFpsDisplay);
 
+    // 视频解码器运行在独立线程，UI线程只负责显示
+    m_videoThread = new QThread(this);
+    m_videoDecoder = new VideoStreamDecoder();
+    m_videoDecoder->moveToThread(m_videoThread);
+    connect(m_videoThread, &QThread::finished, m_videoDecoder, &QObject::deleteLater);
+    connect(m_videoDecoder, &VideoStreamDecoder::frameReady, this, &MainWindow::onVideoFrameReady);
+    m_videoThread->start();
+
+    m_replayThread = new QThread(this);
+    m_captureReplayer = new CaptureReplayer();
+    m_captureReplayer->moveToThread(m_replayThread);
+    connect(m_replayThread, &QThread::finished, m_captureReplayer, &QObject::deleteLater);
+    connect(m_captureReplayer, &CaptureReplayer::progress, this, &MainWindow::onReplayProgress);
+    connect(m_captureReplayer, &CaptureReplayer::replayFinished, this, &MainWindow::onReplayFinished);
+    m_replayThread->start();
+
+    // UDP 精确限速发送在独立线程中忙等，不占用界面线程
+    m_pacedSendThread = new QThread(this);
+    m_pacedUdpSender = new PacedUdpSender();
+    m_pacedUdpSender->setCaptureWriter(m_captureWriter.get());
+    m_pacedUdpSender->setTrafficStats(m_trafficStats.get());
+    m_pacedUdpSender->moveToThread(m_pacedSendThread);
+    connect(m_pacedSendThread, &QThread::finished, m_pacedUdpSender, &QObject::deleteLater);
+    connect(m_pacedUdpSender, &PacedUdpSender::progress, this, &MainWindow::onPacedSendProgress);
+    connect(m_pacedUdpSender, &PacedUdpSender::finished, this, &MainWindow::onPacedSendFinished);
+    m_pacedSendThread->start();
+
     ui->displayStackedWidget->setCurrentIndex(0);
 }
 
 MainWindow::~MainWindow() {
+    m_pacedUdpSender->requestStop();
+    m_pacedSendThread->quit();
+    m_pacedSendThread->wait();
+    m_captureReplayer->requestStop();
+    m_replayThread->quit();
+    m_replayThread->wait();
+    m_captureWriter->stop();
+    m_videoThread->quit();
+    m_videoThread->wait();
     if(m_tempMediaFile){
         m_tempMediaFile->remove();
         delete m_tempMediaFile;
     }
+    // 面板随窗口在成员析构之后才销毁，先解除对会话管理器的引用
+    ui->sessionsPanel->setSessionManager(nullptr);
     delete ui;
 }
 
 void MainWindow::initUI() {
-    ui->baudRateComboBox->addItems({"9600", "19200", "38400", "57600", "115200", "460800"});
+    // 波特率可以直接输入任意值，列表中是常用值和 USB 转串口芯片支持的高速率
+    for (qint32 baudRate : SerialManager::commonBaudRates()) {
+        ui->baudRateComboBox->addItem(QString::number(baudRate));
+    }
+    ui->baudRateComboBox->setEditable(true);
+    ui->baudRateComboBox->setValidator(new QIntValidator(50, 100000000, ui->baudRateComboBox));
     ui->parityComboBox->addItems({"None", "Even", "Odd"});
     ui->dataBitsComboBox->addItems({"8", "7", "6", "5"});
     ui->stopBitsComboBox->addItems({"1", "1.5", "2"});
@@ -136,6 +244,25 @@ void MainWindow::initUI() {
     sendGroup->addButton(ui->asciiSendRadio);
     sendGroup->addButton(ui->hexSendRadio);
 
+    // 收发日志使用模型/视图，视图只格式化可见行
+    m_rxLogModel = new LogModel(this);
+    m_txLogModel = new LogModel(this);
+    ui->receiveLogView->setModel(m_rxLogModel);
+    ui->sentLogView->setModel(m_txLogModel);
+    ui->receiveLogView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    ui->sentLogView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    on_autoWrapCheckBox_toggled(ui->autoWrapCheckBox->isChecked());
+    on_logMemoryLimitSpinBox_valueChanged(ui->logMemoryLimitSpinBox->value());
+    ui->logSpillDirectoryButton->setToolTip(LogSegmentStore::defaultDirectory());
+    // 新日志批量插入后滚动到末尾
+    connect(m_rxLogModel, &QAbstractItemModel::rowsInserted, ui->receiveLogView, &QAbstractItemView::scrollToBottom);
+    connect(m_txLogModel, &QAbstractItemModel::rowsInserted, ui->sentLogView, &QAbstractItemView::scrollToBottom);
+
+    // TCP 服务器的客户端列表按句柄索引，连接和断开都不需要逐项查找
+    m_clientListModel = new TcpClientListModel(this);
+    ui->clientListView->setModel(m_clientListModel);
+    ui->clientListView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+
     m_statusLabel = new QLabel("就绪", this);
     m_rxBytesLabel = new QLabel("RX: 0", this);
     m_txBytesLabel = new QLabel("TX: 0", this);
@@ -153,12 +280,24 @@ void MainWindow::initUI() {
     
     ui->resolutionLabel->clear();
     ui->fingerprintStatusLabel->clear(); 
+    setVideoSurfaceVisible(false);
 
     #ifndef Q_OS_WIN
         if(ui->useWinSockCheckBox) {
             ui->useWinSockCheckBox->setVisible(false);
         }
     #endif
+    #ifndef Q_OS_LINUX
+        if(ui->useRecvMmsgCheckBox) {
+            ui->useRecvMmsgCheckBox->setVisible(false);
+        }
+        if(ui->useEpollServerCheckBox) {
+            ui->useEpollServerCheckBox->setVisible(false);
+        }
+        if(ui->serialLowLatencyCheckBox) {
+            ui->serialLowLatencyCheckBox->setVisible(false);
+        }
+    #endif
 }
 
 void MainWindow::handleIncomingData(const QByteArray &data) {
@@ -170,29 +309,31 @@ void MainWindow::handleIncomingData(const QByteArray &data) {
         bool isImage = pixmap.loadFromData(data);
         if (isImage) {
             // 是图像 -> 按图像处理
+            setVideoSurfaceVisible(false);
             ui->imageDisplayLabel->setPixmap(pixmap.scaled(ui->imageDisplayLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
             ui->displayStackedWidget->setCurrentIndex(1);
-            m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, "Image Data"});
+            appendLog({QDateTime::currentDateTime(), LogEntry::In, data, "Image Data"});
         } else {
             // 不是图像 -> 按文本处理
             ui->imageDisplayLabel->clear();
             ui->displayStackedWidget->setCurrentIndex(0);
-            m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, ""});
+            appendLog({QDateTime::currentDateTime(), LogEntry::In, data, ""});
         }
     } else if (ui->textDisplayRadio->isChecked()) {
         // --- 文本模式 ---
         m_mediaPlayer->stop();
         ui->imageDisplayLabel->clear();
         ui->displayStackedWidget->setCurrentIndex(0);
-        m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, ""});
+        appendLog({QDateTime::currentDateTime(), LogEntry::In, data, ""});
     } else if (ui->imageDisplayRadio->isChecked()) {
         // --- 图像模式 ---
         m_mediaPlayer->stop();
         QPixmap pixmap;
         pixmap.loadFromData(data);
+        setVideoSurfaceVisible(false);
         ui->imageDisplayLabel->setPixmap(pixmap.scaled(ui->imageDisplayLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
         ui->displayStackedWidget->setCurrentIndex(1);
-        m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, "Image Data"});
+        appendLog({QDateTime::currentDateTime(), LogEntry::In, data, "Image Data"});
     } else if (ui->videoDisplayRadio->isChecked()) {
         // --- 视频模式 ---
         m_mediaPlayer->stop();
@@ -211,16 +352,13 @@ void MainWindow::handleIncomingData(const QByteArray &data) {
             ui->displayStackedWidget->setCurrentIndex(0);
             m_mediaPlayer->setSource(QUrl::fromLocalFile(tempFilePath));
             m_mediaPlayer->play();
-            m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, tempFilePath});
+            appendLog({QDateTime::currentDateTime(), LogEntry::In, data, tempFilePath});
         } else {
             qDebug() << "Failed to create temporary file for video.";
             delete m_tempMediaFile;
             m_tempMediaFile = nullptr;
         }
     }
-    
-    // 任何模式处理完后，都更新日志显示
-    updateLogDisplay();
 }
 
 void MainWindow::updatePortList() {
@@ -274,18 +412,26 @@ void MainWindow::updateControlsState() {
     ui->settingsStackedWidget->setEnabled(!isConnected);
 
     if (modeIndex == 3) {
-        bool clientSelected = ui->clientListWidget->currentItem() != nullptr;
-        ui->sendButton->setEnabled(clientSelected);
-        ui->sendTextAsFileButton->setEnabled(clientSelected);
-        ui->sendBigFileButton->setEnabled(clientSelected);
-        ui->cyclicSendCheckBox->setEnabled(clientSelected);
-        ui->disconnectClientButton->setEnabled(clientSelected);
+        // 这里会随每次连接和断开调用，不展开 "所有客户端" 的列表
+        bool hasTargets = false;
+        switch (ui->serverSendTargetComboBox->currentIndex()) {
+            case 0: hasTargets = ui->clientListView->selectionModel()->hasSelection(); break;
+            case 1: hasTargets = m_clientListModel->rowCount() > 0; break;
+            default: hasTargets = !serverSendTargets().isEmpty(); break;
+        }
+        ui->sendButton->setEnabled(hasTargets);
+        ui->sendTextAsFileButton->setEnabled(hasTargets);
+        ui->sendBigFileButton->setEnabled(hasTargets || (m_fileSender && m_fileSender->isActive()) || m_isPacedSending);
+        ui->cyclicSendCheckBox->setEnabled(hasTargets);
+        ui->disconnectClientButton->setEnabled(selectedClientId() != 0);
+        ui->addToGroupButton->setEnabled(ui->clientListView->selectionModel()->hasSelection());
     } else {
         ui->sendButton->setEnabled(isConnected);
         ui->sendTextAsFileButton->setEnabled(isConnected);
-        ui->sendBigFileButton->setEnabled(isConnected);
+        ui->sendBigFileButton->setEnabled(isConnected || (m_fileSender && m_fileSender->isActive()) || m_isPacedSending);
         ui->cyclicSendCheckBox->setEnabled(isConnected);
         ui->disconnectClientButton->setEnabled(false);
+        ui->addToGroupButton->setEnabled(false);
     }
 
     if (!isConnected && m_autoSendTimer->isActive()) {
@@ -311,9 +457,16 @@ void MainWindow::on_connectButton_clicked() {
                 }
                 QString portName = ui->portComboBox->currentText();
                 qint32 baudRate = ui->baudRateComboBox->currentText().toInt();
+                if (baudRate <= 0) {
+                    QMessageBox::warning(this, "警告", "无效的波特率");
+                    return;
+                }
                 QSerialPort::DataBits dataBits = static_cast<QSerialPort::DataBits>(ui->dataBitsComboBox->currentText().toInt());
                 QSerialPort::Parity parity = (ui->parityComboBox->currentText() == "Even") ? QSerialPort::EvenParity : ((ui->parityComboBox->currentText() == "Odd") ? QSerialPort::OddParity : QSerialPort::NoParity);
                 QSerialPort::StopBits stopBits = (ui->stopBitsComboBox->currentText() == "1.5") ? QSerialPort::OneAndHalfStop : ((ui->stopBitsComboBox->currentText() == "2") ? QSerialPort::TwoStop : QSerialPort::OneStop);
+                m_serialManager->setReadMode(ui->serialReadModeComboBox->currentIndex() == 1
+                                             ? SerialManager::ReadMode::Batched : SerialManager::ReadMode::LowLatency);
+                m_serialManager->setLowLatency(ui->serialLowLatencyCheckBox->isChecked());
                 m_serialManager->openPort(portName, baudRate, dataBits, parity, stopBits);
             }
             break;
@@ -326,6 +479,7 @@ void MainWindow::on_connectButton_clicked() {
             break;
         case 2: // UDP
             if (m_udpManager && m_udpManager->isBound()) {
+                stopPacedSend(); // 发送线程直接使用套接字，必须先停下
                 m_udpManager->unbindPort(); // 解绑操作
             } else {
                 // 如果实例已存在，先重置（释放旧对象）
@@ -340,12 +494,22 @@ void MainWindow::on_connectButton_clicked() {
                     m_udpManager = std::make_unique<QtUdpManager>(this);
                     qDebug() << "Using Qt UDP Manager";
                 }
+                #elif defined(Q_OS_LINUX)
+                if (ui->useRecvMmsgCheckBox->isChecked()) {
+                    m_udpManager = std::make_unique<LinuxUdpManager>(this);
+                    qDebug() << "Using Linux recvmmsg UDP Manager";
+                } else {
+                    m_udpManager = std::make_unique<QtUdpManager>(this);
+                    qDebug() << "Using Qt UDP Manager";
+                }
                 #else
-                // 在非Windows平台，总是使用QtUdpManager
+                // 在其他平台，总是使用QtUdpManager
                 m_udpManager = std::make_unique<QtUdpManager>(this);
-                qDebug() << "Using Qt UDP Manager (non-Windows)";
+                qDebug() << "Using Qt UDP Manager";
                 #endif
                 
+                m_udpManager->setTrafficStats(m_trafficStats.get());
+
                 // 连接新实例的信号和槽
                 connect(m_udpManager.get(), &IUdpManager::portBound, this, &MainWindow::onUdpBound);
                 connect(m_udpManager.get(), &IUdpManager::portUnbound, this, &MainWindow::onUdpUnbound);
@@ -362,6 +526,25 @@ void MainWindow::on_connectButton_clicked() {
             if (m_tcpServerManager->isListening()) {
                 m_tcpServerManager->stopListening();
             } else {
+                // 根据UI选项重新创建服务器实例，上一次监听残留的客户端列表一并清掉。
+                // 直接赋值而不是先 reset()：旧实例析构时发出的信号看到的已经是新实例
+                m_clientListModel->clear();
+                m_trackedSends.clear();
+                m_serverFramers.clear();
+                #ifdef Q_OS_LINUX
+                if (ui->useEpollServerCheckBox->isChecked()) {
+                    m_tcpServerManager = std::make_unique<LinuxTcpServerManager>(this);
+                    qDebug() << "Using Linux epoll TCP Server Manager";
+                } else {
+                    m_tcpServerManager = std::make_unique<TcpServerManager>(this);
+                    qDebug() << "Using Qt TCP Server Manager";
+                }
+                #else
+                m_tcpServerManager = std::make_unique<TcpServerManager>(this);
+                #endif
+                connectTcpServerManager();
+                refreshServerSendTargets();
+
                 quint16 port = ui->tcpListenPortSpinBox->value();
                 m_tcpServerManager->startListening(port);
             }
@@ -392,22 +575,22 @@ void MainWindow::on_sendButton_clicked() {
                 m_udpManager->writeData(dataToSend, ui->udpTargetHostLineEdit->text(), ui->udpTargetPortSpinBox->value());
             }
             break;
-        case 3: // TCP 服务器
-            if (ui->clientListWidget->currentItem()) {
-                QString clientInfo = ui->clientListWidget->currentItem()->text();
-                m_tcpServerManager->writeData(dataToSend, clientInfo);
-            } else {
-                QMessageBox::warning(this, "警告", "请在列表中选择一个客户端进行发送。");
+        case 3: { // TCP 服务器
+            const QList<quint64> targets = serverSendTargets();
+            if (targets.isEmpty()) {
+                QMessageBox::warning(this, "警告", "请在列表中选择客户端，或选择其他发送目标。");
                 return;
             }
+            writeToServerTargets(dataToSend, targets);
             break;
+        }
     }
 
     m_txBytes += dataToSend.size();
     updateByteCounters();
+    captureSent(dataToSend);
 
-    m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::Out, dataToSend, ""});
-    updateLogDisplay();
+    appendLog({QDateTime::currentDateTime(), LogEntry::Out, dataToSend, ""});
 
     if (ui->cyclicSendCheckBox->isChecked() == false) {
         ui->sendDataEdit->clear();
@@ -415,17 +598,253 @@ void MainWindow::on_sendButton_clicked() {
 }
 
 void MainWindow::on_clearReceiveButton_clicked() {
-    m_logBuffer.clear();
-    updateLogDisplay();
+    m_rxLogModel->clear();
+    m_txLogModel->clear();
     m_rxBytes = 0;
     m_txBytes = 0;
     updateByteCounters();
 }
 
 void MainWindow::on_autoWrapCheckBox_toggled(bool checked) {
-    auto mode = checked ? QTextEdit::WidgetWidth : QTextEdit::NoWrap;
-    ui->receiveDataDisplayEdit->setLineWrapMode(mode);
-    ui->sentDataDisplayEdit->setLineWrapMode(mode);
+    // 日志每条一行：勾选时长行在视图宽度处省略 (完整内容见悬停提示)，否则完整显示
+    auto mode = checked ? Qt::ElideRight : Qt::ElideNone;
+    ui->receiveLogView->setTextElideMode(mode);
+    ui->sentLogView->setTextElideMode(mode);
+}
+
+void MainWindow::on_logMemoryLimitSpinBox_valueChanged(int megabytes) {
+    // 接收日志、发送日志和多会话面板三者平分内存预算 (面板再分给各会话和时间线)，
+    // 合计不超过设定值；超出部分转存到内存映射的磁盘段
+    const qint64 budget = qint64(megabytes) * 1024 * 1024 / 3;
+    m_rxLogModel->setMemoryBudget(budget);
+    m_txLogModel->setMemoryBudget(budget);
+    ui->sessionsPanel->setLogMemoryBudget(budget);
+}
+
+void MainWindow::on_logSpillDirectoryButton_clicked() {
+    const QString directory = QFileDialog::getExistingDirectory(this, "选择日志转存目录", LogSegmentStore::defaultDirectory());
+    if (directory.isEmpty()) return;
+    // 只影响之后新建的段，已转存的日志留在原目录直到清空
+    LogSegmentStore::setDefaultDirectory(directory);
+    ui->logSpillDirectoryButton->setToolTip(directory);
+}
+
+void MainWindow::on_captureButton_toggled(bool checked) {
+    if (!checked) {
+        m_captureWriter->stop();
+        m_statusLabel->setText(QString("抓包已保存: %1 (%2 字节)")
+                               .arg(m_captureWriter->filePath())
+                               .arg(m_captureWriter->bytesWritten()));
+        ui->captureButton->setText("开始抓包");
+        return;
+    }
+
+    QString selectedFilter;
+    const QString filePath = QFileDialog::getSaveFileName(this, "保存抓包文件",
+                                                          QDateTime::currentDateTime().toString("'capture_'yyyyMMdd_HHmmss'.nxcap'"),
+                                                          "NexusTerm 抓包 (*.nxcap);;pcapng (*.pcapng)", &selectedFilter);
+    if (filePath.isEmpty()) {
+        const QSignalBlocker blocker(ui->captureButton);
+        ui->captureButton->setChecked(false);
+        return;
+    }
+
+    const CaptureWriter::Format format = (filePath.endsWith(".pcapng", Qt::CaseInsensitive) || selectedFilter.startsWith("pcapng"))
+            ? CaptureWriter::Format::PcapNg : CaptureWriter::Format::Native;
+    if (!m_captureWriter->start(filePath, format)) {
+        QMessageBox::warning(this, "错误", "无法创建抓包文件: " + m_captureWriter->errorString());
+        const QSignalBlocker blocker(ui->captureButton);
+        ui->captureButton->setChecked(false);
+        return;
+    }
+    ui->captureButton->setText("停止抓包");
+    m_statusLabel->setText(QString("正在抓包: %1").arg(filePath));
+}
+
+MainWindow::CaptureTarget MainWindow::currentCaptureTarget() const {
+    CaptureTarget target;
+    switch (ui->communicationModeComboBox->currentIndex()) {
+        case 0:
+            target.transport = CaptureWriter::Transport::Serial;
+            target.peers.append(ui->portComboBox->currentText());
+            break;
+        case 1:
+            target.transport = CaptureWriter::Transport::TcpClient;
+            target.peers.append(QString("%1:%2").arg(ui->tcpHostLineEdit->text()).arg(ui->tcpPortSpinBox->value()));
+            break;
+        case 2:
+            target.transport = CaptureWriter::Transport::Udp;
+            target.peers.append(QString("%1:%2").arg(ui->udpTargetHostLineEdit->text()).arg(ui->udpTargetPortSpinBox->value()));
+            break;
+        case 3: {
+            target.transport = CaptureWriter::Transport::TcpServer;
+            const QList<quint64> targets = serverSendTargets();
+            for (quint64 clientId : targets) {
+                target.peers.append(m_clientListModel->clientInfo(clientId));
+            }
+            break;
+        }
+    }
+    return target;
+}
+
+void MainWindow::captureSent(const QByteArray &data) {
+    if (!m_captureWriter->isActive()) return;
+    captureSent(data, currentCaptureTarget());
+}
+
+void MainWindow::captureSent(const QByteArray &data, const CaptureTarget &target) {
+    if (!m_captureWriter->isActive()) return;
+    for (const QString &peer : target.peers) {
+        m_captureWriter->record(target.transport, CaptureWriter::RecordType::Tx, peer, data);
+    }
+}
+
+bool MainWindow::writeToCurrentTransport(const QByteArray &data) {
+    switch (ui->communicationModeComboBox->currentIndex()) {
+        case 0:
+            if (!m_serialManager->isOpen()) return false;
+            m_serialManager->writeData(data);
+            return true;
+        case 1:
+            if (!m_tcpManager->isConnected()) return false;
+            m_tcpManager->writeData(data);
+            return true;
+        case 2:
+            if (!m_udpManager) return false;
+            m_udpManager->writeData(data, ui->udpTargetHostLineEdit->text(), ui->udpTargetPortSpinBox->value());
+            return true;
+        case 3: {
+            const QList<quint64> targets = serverSendTargets();
+            if (targets.isEmpty()) return false;
+            m_tcpServerManager->writeToClients(data, targets);
+            return true;
+        }
+    }
+    return false;
+}
+
+void MainWindow::on_replayMaxSpeedCheckBox_toggled(bool checked) {
+    ui->replaySpeedSpinBox->setEnabled(!checked);
+}
+
+void MainWindow::on_replayButton_toggled(bool checked) {
+    if (!checked) {
+        // 界面在 onReplayFinished 中复位
+        m_captureReplayer->requestStop();
+        return;
+    }
+
+    const QString filePath = QFileDialog::getOpenFileName(this, "选择抓包文件", "",
+                                                          "抓包文件 (*.nxcap *.pcapng);;All Files (*)");
+    if (filePath.isEmpty()) {
+        const QSignalBlocker blocker(ui->replayButton);
+        ui->replayButton->setChecked(false);
+        return;
+    }
+
+    const int target = ui->replayTargetComboBox->currentIndex();
+    CaptureReplayer *replayer = m_captureReplayer;
+    if (target == 1) {
+        // 直接送入解码线程，解码器的处理速度决定回放速度
+        VideoStreamDecoder *decoder = m_videoDecoder;
+        m_isVideoReplay = true;
+        resetVideoDecoder();
+        m_fpsCounter = 0;
+        m_currentFps = 0;
+        m_fpsTimer->start();
+        m_replayConnection = connect(replayer, &CaptureReplayer::packetReady, decoder,
+                                     [decoder, replayer](const QByteArray &data, const QString &) {
+            decoder->appendData(data);
+            replayer->packetConsumed();
+        });
+    } else {
+        m_replayConnection = connect(replayer, &CaptureReplayer::packetReady, this,
+                                     [this, replayer, target](const QByteArray &data, const QString &) {
+            if (target == 0) {
+                m_rxBytes += data.size();
+                handleIncomingData(data);
+            } else if (writeToCurrentTransport(data)) {
+                m_txBytes += data.size();
+                captureSent(data);
+            }
+            updateByteCounters();
+            replayer->packetConsumed();
+        });
+    }
+
+    // 默认只回放与目标对应的传输方式，避免把混合抓包中的其他流一起注入
+    CaptureReplayer::Filter filter;
+    filter.peer = ui->replayPeerLineEdit->text().trimmed();
+    switch (ui->replayTransportComboBox->currentIndex()) {
+        case 0:
+            if (target == 1) {
+                filter.transport = CaptureWriter::Transport::Udp;
+            } else {
+                static const CaptureWriter::Transport modeTransports[] = {
+                    CaptureWriter::Transport::Serial, CaptureWriter::Transport::TcpClient,
+                    CaptureWriter::Transport::Udp, CaptureWriter::Transport::TcpServer };
+                filter.transport = modeTransports[qBound(0, ui->communicationModeComboBox->currentIndex(), 3)];
+            }
+            break;
+        case 1: filter.anyTransport = true; break;
+        case 2: filter.transport = CaptureWriter::Transport::Serial; break;
+        case 3: filter.transport = CaptureWriter::Transport::TcpClient; break;
+        case 4: filter.transport = CaptureWriter::Transport::TcpServer; break;
+        default: filter.transport = CaptureWriter::Transport::Udp; break;
+    }
+
+    CaptureReplayer::Timing timing = CaptureReplayer::Timing::Original;
+    const double speed = ui->replaySpeedSpinBox->value();
+    if (ui->replayMaxSpeedCheckBox->isChecked()) {
+        timing = CaptureReplayer::Timing::MaxSpeed;
+    } else if (!qFuzzyCompare(speed, 1.0)) {
+        timing = CaptureReplayer::Timing::Scaled;
+    }
+    QMetaObject::invokeMethod(replayer, [replayer, filePath, timing, speed, filter]() {
+        replayer->startReplay(filePath, timing, speed, filter);
+    }, Qt::QueuedConnection);
+
+    ui->replayButton->setText("停止回放");
+    ui->replayTargetComboBox->setEnabled(false);
+    ui->replayTransportComboBox->setEnabled(false);
+    ui->replayPeerLineEdit->setEnabled(false);
+    m_statusLabel->setText(QString("正在回放: %1 (%2%3)").arg(filePath,
+                           filter.anyTransport ? QString("全部传输") : CaptureWriter::transportName(filter.transport),
+                           filter.peer.isEmpty() ? QString() : QString(" ") + filter.peer));
+}
+
+void MainWindow::onReplayProgress(qint64 records, qint64 bytes, int percent) {
+    m_statusLabel->setText(QString("回放中 %1%: %2 条, %3 字节").arg(percent).arg(records).arg(bytes));
+}
+
+void MainWindow::onReplayFinished(qint64 records, qint64 bytes, qint64 elapsedNs, const QString &errorText) {
+    disconnect(m_replayConnection);
+    if (m_isVideoReplay) {
+        m_isVideoReplay = false;
+        if (!m_isUdpStreaming) {
+            m_fpsTimer->stop();
+        }
+    }
+
+    {
+        const QSignalBlocker blocker(ui->replayButton);
+        ui->replayButton->setChecked(false);
+    }
+    ui->replayButton->setText("回放抓包");
+    ui->replayTargetComboBox->setEnabled(true);
+    ui->replayTransportComboBox->setEnabled(true);
+    ui->replayPeerLineEdit->setEnabled(true);
+
+    if (!errorText.isEmpty()) {
+        QMessageBox::warning(this, "回放错误", errorText);
+    }
+    const double seconds = qMax(elapsedNs, qint64(1)) / 1e9;
+    m_statusLabel->setText(QString("回放结束: %1 条, %2 字节, 用时 %3 s, %4 MB/s")
+                           .arg(records)
+                           .arg(bytes)
+                           .arg(seconds, 0, 'f', 3)
+                           .arg(bytes / seconds / (1024.0 * 1024.0), 0, 'f', 1));
 }
 
 void MainWindow::on_cyclicSendCheckBox_toggled(bool checked) {
@@ -434,7 +853,7 @@ void MainWindow::on_cyclicSendCheckBox_toggled(bool checked) {
     if (modeIndex == 0) canStart = m_serialManager->isOpen();
     else if (modeIndex == 1) canStart = m_tcpManager->isConnected();
     else if (modeIndex == 2) canStart = (m_udpManager && m_udpManager->isBound());
-    else if (modeIndex == 3) canStart = m_tcpServerManager->isListening() && ui->clientListWidget->currentItem();
+    else if (modeIndex == 3) canStart = m_tcpServerManager->isListening() && !serverSendTargets().isEmpty();
 
 
     if (checked && canStart) {
@@ -446,6 +865,7 @@ void MainWindow::on_cyclicSendCheckBox_toggled(bool checked) {
 
 void MainWindow::on_communicationModeComboBox_currentIndexChanged(int index) {
     ui->settingsStackedWidget->setCurrentIndex(index);
+    showFramerSettings();
     if (index == 0) {
         m_portScanTimer->start(2000);
     } else {
@@ -456,9 +876,10 @@ void MainWindow::on_communicationModeComboBox_currentIndexChanged(int index) {
         if (m_isUdpStreaming) {
             m_isUdpStreaming = false;
             ui->playPauseButton->setText("播放");
-            m_videoFrameBuffer.clear();
+            resetVideoDecoder();
         }
         // 清理UDP管理器实例
+        stopPacedSend();
         m_udpManager.reset();
     }
     
@@ -487,86 +908,231 @@ void MainWindow::on_sendTextAsFileButton_clicked() {
                 m_udpManager->writeData(fileData, ui->udpTargetHostLineEdit->text(), ui->udpTargetPortSpinBox->value());
              }
              break;
-        case 3: // TCP 服务器
-            if (ui->clientListWidget->currentItem()) {
-                QString clientInfo = ui->clientListWidget->currentItem()->text();
-                m_tcpServerManager->writeData(fileData, clientInfo);
-            } else {
-                QMessageBox::warning(this, "警告", "请在列表中选择一个客户端进行发送。");
+        case 3: { // TCP 服务器
+            const QList<quint64> targets = serverSendTargets();
+            if (targets.isEmpty()) {
+                QMessageBox::warning(this, "警告", "请在列表中选择客户端，或选择其他发送目标。");
                 return;
             }
+            writeToServerTargets(fileData, targets);
             break;
+        }
     }
 
     m_txBytes += fileData.size();
     updateByteCounters();
+    captureSent(fileData);
 
-    m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::Out, fileData, ""});
-    updateLogDisplay();
+    appendLog({QDateTime::currentDateTime(), LogEntry::Out, fileData, ""});
 }
 
 void MainWindow::on_sendBigFileButton_clicked()
 {
+    if (m_isPacedSending) {
+        // 界面在 onPacedSendFinished 中复位
+        m_pacedUdpSender->requestStop();
+        return;
+    }
+    if (m_fileSender->isActive()) {
+        m_fileSender->cancel();
+        return;
+    }
+
     QString filePath = QFileDialog::getOpenFileName(this, "选择要发送的文件", "", "All Files (*)");
     if (filePath.isEmpty()) {
         return;
     }
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        QMessageBox::warning(this, "错误", "无法打开文件: " + file.errorString());
+    if (ui->communicationModeComboBox->currentIndex() == 2 && ui->pacedSendCheckBox->isChecked()) {
+        startPacedSend(filePath);
         return;
     }
 
-    m_fileDataToSend = file.readAll();
-    file.close();
+    // 发送目标在开始时确定；串口和 TCP 通过写缓冲积压量做背压，UDP 只能按延时/时间片控制
+    FileSender::WriteFunction write;
+    FileSender::PendingFunction pending;
+    qint64 highWaterMark = 1024 * 1024;
+    int chunkSize = ui->packetSizeSpinBox->value();
+    m_fileSendSegmentSize = 0;
+    switch (ui->communicationModeComboBox->currentIndex()) {
+        case 0:
+            write = [this](const QByteArray &chunk) {
+                if (!m_serialManager->isOpen()) return false;
+                // 串口线程稍后才写出，分块是文件映射的视图，必须复制
+                m_serialManager->writeData(QByteArray(chunk.constData(), chunk.size()));
+                return true;
+            };
+            pending = [this]() { return m_serialManager->bytesToWrite(); };
+            // 串口较慢，积压太多会让取消发送迟迟不生效
+            highWaterMark = 16 * 1024;
+            break;
+        case 1:
+            write = [this](const QByteArray &chunk) {
+                if (!m_tcpManager->isConnected()) return false;
+                m_tcpManager->writeData(chunk);
+                return true;
+            };
+            pending = [this]() { return m_tcpManager->bytesToWrite(); };
+            break;
+        case 2: {
+            const QString host = ui->udpTargetHostLineEdit->text();
+            const quint16 port = static_cast<quint16>(ui->udpTargetPortSpinBox->value());
+            if (ui->delaySpinBox->value() > 0) {
+                write = [this, host, port](const QByteArray &chunk) {
+                    if (!m_udpManager || !m_udpManager->isBound()) return false;
+                    m_udpManager->writeData(chunk, host, port);
+                    return true;
+                };
+            } else {
+                // 不需要分包延时时一次交出多个数据报，由 sendmmsg / GSO 批量发送
+                const int segmentSize = chunkSize;
+                chunkSize = segmentSize * kUdpBatchDatagrams;
+                m_fileSendSegmentSize = segmentSize;
+                write = [this, host, port, segmentSize](const QByteArray &chunk) {
+                    if (!m_udpManager || !m_udpManager->isBound()) return false;
+                    m_udpManager->writeDatagrams(chunk, segmentSize, host, port);
+                    return true;
+                };
+            }
+            break;
+        }
+        case 3: {
+            const QList<quint64> targets = serverSendTargets();
+            if (targets.isEmpty()) {
+                QMessageBox::warning(this, "警告", "请在列表中选择客户端，或选择其他发送目标。");
+                return;
+            }
+            write = [this, targets](const QByteArray &chunk) {
+                if (!m_tcpServerManager->isListening()) return false;
+                m_tcpServerManager->writeToClients(chunk, targets);
+                return true;
+            };
+            // 按最慢的客户端控制读取速度
+            pending = [this, targets]() {
+                qint64 maxPending = 0;
+                for (quint64 clientId : targets) {
+                    maxPending = qMax(maxPending, m_tcpServerManager->bytesToWrite(clientId));
+                }
+                return maxPending;
+            };
+            break;
+        }
+    }
 
-    if (m_fileDataToSend.isEmpty()) {
-        QMessageBox::information(this, "提示", "文件为空，无需发送。");
+    m_fileSendCaptureTarget = currentCaptureTarget();
+    m_fileSender->setHighWaterMark(highWaterMark);
+    if (!m_fileSender->start(filePath, chunkSize, ui->delaySpinBox->value(), write, pending)) {
+        QMessageBox::information(this, "提示", m_fileSender->errorString());
         return;
     }
+    ui->sendBigFileButton->setText("取消发送");
+    ui->fileSendProgressBar->setValue(0);
+    m_statusLabel->setText(QString("正在发送文件: %1").arg(QFileInfo(filePath).fileName()));
+}
 
-    m_fileSendOffset = 0;
-    int delay = ui->delaySpinBox->value();
-    
-    // 立即发送第一块数据
-    sendFileChunk();
-    
-    if (delay > 0) {
-        m_fileSendTimer->start(delay);
+void MainWindow::onFileSendProgress(qint64 sentBytes, qint64 totalBytes, double bytesPerSecond)
+{
+    ui->fileSendProgressBar->setValue(static_cast<int>(sentBytes * 1000 / qMax<qint64>(totalBytes, 1)));
+    ui->fileSendRateLabel->setText(QString("%1 / %2 MB  %3 MB/s")
+                                   .arg(sentBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                   .arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                   .arg(bytesPerSecond / (1024.0 * 1024.0), 0, 'f', 2));
+    updateByteCounters();
+}
+
+void MainWindow::onFileSendFinished(bool success, const QString &errorText)
+{
+    ui->sendBigFileButton->setText("发送文件");
+    updateByteCounters();
+    if (success) {
+        const double seconds = qMax<qint64>(m_fileSender->elapsedMs(), 1) / 1000.0;
+        m_statusLabel->setText(QString("文件发送完成: %1 字节, 平均 %2 MB/s")
+                               .arg(m_fileSender->totalBytes())
+                               .arg(m_fileSender->totalBytes() / seconds / (1024.0 * 1024.0), 0, 'f', 2));
     } else {
-        // 如果延时为0，循环发送直到完成
-        while(m_fileSendOffset < m_fileDataToSend.size()) {
-            sendFileChunk();
-        }
+        m_statusLabel->setText(QString("文件发送中止: %1").arg(errorText));
     }
 }
 
-void MainWindow::sendFileChunk()
+void MainWindow::on_pacedSendCheckBox_toggled(bool checked)
 {
-    if (m_fileSendOffset >= m_fileDataToSend.size()) {
-        if(m_fileSendTimer->isActive()){
-            m_fileSendTimer->stop();
-        }
-        return;
-    }
+    ui->paceRateSpinBox->setEnabled(checked);
+    ui->paceUnitComboBox->setEnabled(checked);
+    ui->paceBurstSpinBox->setEnabled(checked);
+}
 
-    int chunkSize = ui->packetSizeSpinBox->value();
-    QByteArray chunk = m_fileDataToSend.mid(m_fileSendOffset, chunkSize);
+void MainWindow::startPacedSend(const QString &filePath)
+{
+    if (!m_udpManager || !m_udpManager->isBound()) return;
+
+    const double rate = ui->paceRateSpinBox->value();
+    const PacedUdpSender::RateUnit unit = ui->paceUnitComboBox->currentIndex() == 0
+            ? PacedUdpSender::RateUnit::MegabitsPerSecond : PacedUdpSender::RateUnit::PacketsPerSecond;
+    const qintptr socketDescriptor = m_udpManager->socketDescriptor();
+    const QString host = ui->udpTargetHostLineEdit->text();
+    const quint16 port = static_cast<quint16>(ui->udpTargetPortSpinBox->value());
+    const int packetSize = ui->packetSizeSpinBox->value();
+    const int burst = ui->paceBurstSpinBox->value();
+
+    PacedUdpSender *sender = m_pacedUdpSender;
+    QMetaObject::invokeMethod(sender, [sender, socketDescriptor, host, port, filePath, packetSize, rate, unit, burst]() {
+        sender->sendFile(socketDescriptor, host, port, filePath, packetSize, rate, unit, burst);
+    }, Qt::QueuedConnection);
+
+    m_isPacedSending = true;
+    m_pacedReportedBytes = 0;
+    m_pacedRequestedRate = rate > 0 ? QString("%1 %2").arg(rate).arg(ui->paceUnitComboBox->currentText()) : QString("不限速");
+    ui->sendBigFileButton->setText("取消发送");
+    ui->fileSendProgressBar->setValue(0);
+    ui->pacedSendCheckBox->setEnabled(false);
+    m_statusLabel->setText(QString("正在限速发送文件: %1").arg(QFileInfo(filePath).fileName()));
+}
 
-    if (m_udpManager) {
-        m_udpManager->writeData(chunk, ui->udpTargetHostLineEdit->text(), ui->udpTargetPortSpinBox->value());
+void MainWindow::stopPacedSend()
+{
+    if (m_isPacedSending) {
+        m_pacedUdpSender->stopAndWait();
     }
+}
 
-    m_txBytes += chunk.size();
+void MainWindow::onPacedSendProgress(qint64 sentBytes, qint64 totalBytes, double bitsPerSecond, double packetsPerSecond)
+{
+    m_txBytes += sentBytes - m_pacedReportedBytes;
+    m_pacedReportedBytes = sentBytes;
+    ui->fileSendProgressBar->setValue(static_cast<int>(sentBytes * 1000 / qMax<qint64>(totalBytes, 1)));
+    // 实际速率与目标速率并列显示，便于判断是否被网卡或接收端限制
+    ui->fileSendRateLabel->setText(QString("%1 / %2 MB  实际 %3 Mbit/s (%4 包/秒)  目标 %5")
+                                   .arg(sentBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                   .arg(totalBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                                   .arg(bitsPerSecond / 1e6, 0, 'f', 2)
+                                   .arg(packetsPerSecond, 0, 'f', 0)
+                                   .arg(m_pacedRequestedRate));
     updateByteCounters();
-    m_fileSendOffset += chunk.size();
+}
+
+void MainWindow::onPacedSendFinished(bool success, qint64 packets, qint64 elapsedNs, const QString &errorText)
+{
+    m_isPacedSending = false;
+    ui->sendBigFileButton->setText("发送文件");
+    ui->pacedSendCheckBox->setEnabled(true);
+    updateByteCounters();
+    updateControlsState();
+    if (success) {
+        const double seconds = qMax<qint64>(elapsedNs, 1) / 1e9;
+        m_statusLabel->setText(QString("限速发送完成: %1 包, %2 字节, 平均 %3 Mbit/s")
+                               .arg(packets)
+                               .arg(m_pacedReportedBytes)
+                               .arg(m_pacedReportedBytes * 8.0 / seconds / 1e6, 0, 'f', 2));
+    } else {
+        m_statusLabel->setText(QString("限速发送中止: %1").arg(errorText));
+    }
 }
 
 void MainWindow::on_clearDisplayButton_clicked()
 {
     m_mediaPlayer->stop();
     ui->imageDisplayLabel->clear();
+    ui->videoSurfaceWidget->clear();
     ui->resolutionLabel->clear(); 
     ui->fingerprintStatusLabel->clear(); 
     m_lastFingerprintStatus = 0xFFFFFFFF; // <-- 重置：状态缓存
@@ -589,7 +1155,7 @@ void MainWindow::on_playPauseButton_clicked()
         if (!m_isUdpStreaming) {
             // --- 开始视频流 ---
             m_isUdpStreaming = true;
-            m_videoFrameBuffer.clear(); // 清空旧的缓冲
+            resetVideoDecoder(); // 清空旧的缓冲
 
             m_fpsCounter = 0;
             m_currentFps = 0;
@@ -611,13 +1177,14 @@ void MainWindow::on_playPauseButton_clicked()
             m_fpsTimer->stop();
             
             ui->playPauseButton->setText("播放");
+            setVideoSurfaceVisible(false);
             m_statusLabel->setText(QString("UDP已绑定本地端口: %1").arg(ui->udpBindPortSpinBox->value()));
             ui->resolutionLabel->clear();
             ui->fingerprintStatusLabel->clear(); 
             m_lastFingerprintStatus = 0xFFFFFFFF; // <-- 重置：状态缓存
             
             // 清空视频缓冲区，丢弃所有已接收但未处理的数据
-            m_videoFrameBuffer.clear();
+            resetVideoDecoder();
             qDebug() << "[Video Control] Streaming stopped by user. Video buffer cleared.";
         }
     } else {
@@ -661,54 +1228,48 @@ void MainWindow::updateDuration(qint64 duration)
     ui->progressSlider->setRange(0, duration);
 }
 
+void MainWindow::appendLog(const LogEntry &entry) {
+    if (entry.direction == LogEntry::In) {
+        m_rxLogModel->appendEntry(entry);
+    } else {
+        m_txLogModel->appendEntry(entry);
+    }
+}
+
 void MainWindow::updateLogDisplay() {
-    ui->receiveDataDisplayEdit->clear();
-    ui->sentDataDisplayEdit->clear();
-    for (const auto &entry : m_logBuffer) {
-        QString displayText;
-        bool isImage = (entry.sourceInfo == "Image Data");
-        if (isImage) {
-             displayText = QString("[Image Data: %1 bytes]").arg(entry.rawData.size());
-        } else if (!entry.sourceInfo.isEmpty() && entry.sourceInfo != "Image Data" && QFileInfo(entry.sourceInfo).exists()){
-            displayText = QString("[Video Data: %1 bytes, path: %2]").arg(entry.rawData.size()).arg(entry.sourceInfo);
-        }
-        else if (ui->asciiDisplayRadio->isChecked()) {
-            displayText = QString::fromLocal8Bit(entry.rawData);
-        } else if (ui->hexDisplayRadio->isChecked()) {
-            displayText = QString::fromLatin1(entry.rawData.toHex(' ').toUpper());
-        } else { // Decimal
-            QStringList decValues;
-            for (quint8 byte : entry.rawData) { decValues.append(QString::number(byte)); }
-            displayText = decValues.join(' ');
-        }
-        if (entry.direction == LogEntry::In) {
-            const QString logStr = QString("[%1] RX %2<- %3")
-                                     .arg(entry.timestamp.toString("HH:mm:ss.zzz"))
-                                     .arg(entry.sourceInfo)
-                                     .arg(displayText);
-            ui->receiveDataDisplayEdit->append(logStr);
-        } else { // Out
-            const QString logStr = QString("[%1] TX -> %2")
-                                     .arg(entry.timestamp.toString("HH:mm:ss.zzz"))
-                                     .arg(displayText);
-            ui->sentDataDisplayEdit->append(logStr);
-        }
+    // 只切换显示格式，可见行由视图按需重新格式化
+    LogModel::DisplayMode mode = LogModel::DisplayMode::Decimal;
+    if (ui->asciiDisplayRadio->isChecked()) {
+        mode = LogModel::DisplayMode::Ascii;
+    } else if (ui->hexDisplayRadio->isChecked()) {
+        mode = LogModel::DisplayMode::Hex;
     }
-    ui->receiveDataDisplayEdit->moveCursor(QTextCursor::End);
-    ui->sentDataDisplayEdit->moveCursor(QTextCursor::End);
+    m_rxLogModel->setDisplayMode(mode);
+    m_txLogModel->setDisplayMode(mode);
 }
 
 // === 通信管理器槽函数实现 ===
 void MainWindow::onSerialDataReceived(const QByteArray &data) {
-    handleIncomingData(data);
+    m_captureWriter->record(CaptureWriter::Transport::Serial, CaptureWriter::RecordType::Rx,
+                            ui->portComboBox->currentText(), data);
+    const QList<QByteArray> frames = frameIncoming(m_serialFramer.get(), data);
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
+    }
     m_rxBytes += data.size();
     updateByteCounters();
 }
 void MainWindow::onPortOpened() {
+    m_serialFramer->reset();
     updateControlsState();
     m_statusLabel->setText(QString("已连接 %1").arg(ui->portComboBox->currentText()));
 }
 void MainWindow::onPortClosed() {
+    QList<QByteArray> frames;
+    m_serialFramer->flush(&frames);
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
+    }
     updateControlsState();
     m_statusLabel->setText("已断开");
 }
@@ -717,23 +1278,30 @@ void MainWindow::onPortError(const QString &errorText) {
     updateControlsState();
 }
 void MainWindow::onTcpConnected() {
-    m_tcpBuffer.clear();
+    m_tcpFramer->reset();
     updateControlsState();
     m_statusLabel->setText(QString("已连接到 %1:%2").arg(ui->tcpHostLineEdit->text()).arg(ui->tcpPortSpinBox->value()));
 }
 void MainWindow::onTcpDisconnected() {
     updateControlsState();
     m_statusLabel->setText("TCP 已断开");
-    if (!m_tcpBuffer.isEmpty()) {
-        m_tcpReassemblyTimer->stop();
-        onTcpReassemblyTimeout();
+    QList<QByteArray> frames;
+    m_tcpFramer->flush(&frames);
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
     }
 }
 void MainWindow::onTcpDataReceived(const QByteArray &data) {
+    if (m_captureWriter->isActive()) {
+        m_captureWriter->record(CaptureWriter::Transport::TcpClient, CaptureWriter::RecordType::Rx,
+                                QString("%1:%2").arg(ui->tcpHostLineEdit->text()).arg(ui->tcpPortSpinBox->value()), data);
+    }
     m_rxBytes += data.size();
     updateByteCounters();
-    m_tcpBuffer.append(data);
-    m_tcpReassemblyTimer->start();
+    const QList<QByteArray> frames = frameIncoming(m_tcpFramer.get(), data);
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
+    }
 }
 void MainWindow::onTcpError(const QString &errorText) {
     if (!errorText.isEmpty()) QMessageBox::critical(this, "TCP错误", errorText);
@@ -750,7 +1318,7 @@ void MainWindow::onUdpUnbound() {
         m_videoHeaderReceived = false;
 
         ui->playPauseButton->setText("播放");
-        m_videoFrameBuffer.clear();
+        resetVideoDecoder();
     }
     
     m_udpManager.reset();
@@ -760,176 +1328,438 @@ void MainWindow::onUdpUnbound() {
 }
 
 void MainWindow::onUdpDataReceived(const QByteArray &data, const QString &senderHost, quint16 senderPort) {
+    // 抓包记录传输层收到的所有数据，与是否在播放视频无关
+    if (m_captureWriter->isActive()) {
+        m_captureWriter->record(CaptureWriter::Transport::Udp, CaptureWriter::RecordType::Rx,
+                                QString("%1:%2").arg(senderHost).arg(senderPort), data);
+    }
     if (!m_isUdpStreaming) {
         return; 
     }
     m_rxBytes += data.size();
     updateByteCounters();
-    m_videoFrameBuffer.append(data);
-    processVideoFrameBuffer();
+    // 帧同步和解码交给工作线程，这里只做转发
+    VideoStreamDecoder *decoder = m_videoDecoder;
+    QMetaObject::invokeMethod(decoder, [decoder, data]() { decoder->appendData(data); }, Qt::QueuedConnection);
 }
 
-void MainWindow::processVideoFrameBuffer() {
-    static const QByteArray frameHeader("\xF0\x5A\xA5\x0F", 4);
-
-    // 循环处理，确保一次调用能处理完缓冲区里所有完整的帧
-    while (true) {
-        // --- 步骤 1: 寻找并对齐帧头 ---
-        int headerPos = m_videoFrameBuffer.indexOf(frameHeader);
-        if (headerPos == -1) {
-            // 缓冲区里没有帧头，退出函数，等待更多数据
-            return;
-        }
-
-        // 丢弃帧头前的所有无效数据，实现数据流同步
-        m_videoFrameBuffer.remove(0, headerPos);
+void MainWindow::resetVideoDecoder() {
+    // 排队执行，保证在此之前已投递的数据先被丢弃
+    VideoStreamDecoder *decoder = m_videoDecoder;
+    QMetaObject::invokeMethod(decoder, [decoder]() { decoder->reset(); }, Qt::QueuedConnection);
+}
 
-        // --- 步骤 2: 验证元数据长度 ---
-        if (m_videoFrameBuffer.size() < 13) {
-            // 数据不足以解析出宽度、高度和状态，退出等待
-            return;
-        }
+void MainWindow::setVideoSurfaceVisible(bool visible) {
+    // 视频流使用 videoSurfaceWidget，静态图片仍然使用 imageDisplayLabel
+    if (!visible) {
+        ui->videoSurfaceWidget->clear();
+    }
+    ui->videoSurfaceWidget->setVisible(visible);
+    ui->imageDisplayLabel->setVisible(!visible);
+}
 
-        // --- 步骤 3: 解析并验证分辨率 ---
-        const uchar* meta = reinterpret_cast<const uchar*>(m_videoFrameBuffer.constData() + 4);
-        quint16 width  = (meta[0] << 8) | meta[1];
-        quint16 height = (meta[2] << 8) | meta[3];
+void MainWindow::onVideoFrameReady() {
+    QImage image;
+    QByteArray statusBytes;
+    const int decodedFrames = m_videoDecoder->takeLatestFrame(&image, &statusBytes);
 
-        if (width == 0 || height == 0 || width > 4096 || height > 4096) {
-            // 分辨率数值无效，说明这个帧头是伪造的或已损坏
-            qDebug() << "[Video Sync Error] 解析到无效分辨率: " << width << "x" << height << ". 丢弃数据并寻找下一个帧头...";
-            m_videoFrameBuffer.remove(0, 1); // 只移除1个字节，以防在同一个错误位置死循环
-            continue; // 继续外层while循环，寻找下一个有效的帧头
-        }
-        
-        // --- 步骤 3.5: 解析并验证状态头 ---
-        const uchar* statusHeader = reinterpret_cast<const uchar*>(m_videoFrameBuffer.constData() + 8);
-
-        // 检查帧头格式 FF ... FF
-        if (statusHeader[0] != 0xFF || statusHeader[4] != 0xFF) {
-            qDebug() << "[Video Sync Error] 状态头格式错误 (FF ... FF). 丢弃数据并寻找下一个帧头...";
-            m_videoFrameBuffer.remove(0, 1); // 只移除1个字节，以防在同一个错误位置死循环
-            continue; // 继续外层while循环，寻找下一个有效的帧头
-        }
-        
-        // --- 步骤 4: 验证数据帧的完整性 ---
-        int singleFrameSize = width * height * 2;
-        int totalFrameSize = 13 + singleFrameSize; // 整个数据帧的大小 = 元数据(13) + 像素数据
-
-        if (m_videoFrameBuffer.size() < totalFrameSize) {
-            // 缓冲区的数据还不够一整帧，退出等待
-            return;
-        }
+    // 停止播放后，信箱中可能还留有已解码的帧，直接丢弃
+    if (decodedFrames == 0 || !(m_isUdpStreaming || m_isVideoReplay)) {
+        return;
+    }
 
-        // --- 步骤 5: 最终校验，检查帧内部是否混入下一个帧头 ---
-        int nextHeaderPos = m_videoFrameBuffer.indexOf(frameHeader, 1);
-        if (nextHeaderPos != -1 && nextHeaderPos < totalFrameSize) {
-            // 在当前帧结束前就出现了下一个帧头，说明当前帧因丢包而损坏
-            qDebug() << "[Video Sync] 检测到损坏的帧，正在重新同步...";
-            m_videoFrameBuffer.remove(0, nextHeaderPos); // 丢弃损坏帧的数据
-            continue; // 继续外层while循环，处理找到的下一个帧头
-        }
+    // 只保存最新一帧并请求重绘，UI 跟不上时中间帧会在解码器信箱中被覆盖
+    if (ui->videoSurfaceWidget->isHidden()) {
+        setVideoSurfaceVisible(true);
+    }
+    ui->videoSurfaceWidget->setFrame(image);
 
-        // --- 所有检查通过，解码并显示图像 ---
-        QByteArray imageDataBytes = m_videoFrameBuffer.mid(13, singleFrameSize);
+    // 确保显示的是图像页面
+    if (ui->displayStackedWidget->currentIndex() != 1) {
+         ui->displayStackedWidget->setCurrentIndex(1);
+    }
 
-        // 修正字节序
-        for(int i = 0; i < imageDataBytes.size(); i += 2) {
-            std::swap(imageDataBytes[i], imageDataBytes[i+1]);
-        }
+    // ******** START: 修改：更新FPS和分辨率 ********
+    m_videoStreamWidth = image.width();
+    m_videoStreamHeight = image.height();
+    // 立即更新标签文本（而不是等待定时器）
+    updateFpsDisplay();
 
-        const uchar* correctedImageDataPtr = reinterpret_cast<const uchar*>(imageDataBytes.constData());
-        QImage image(correctedImageDataPtr, width, height, QImage::Format_RGB16);
+    // 检查状态码
+    updateFingerprintStatus(statusBytes, image); // 传入当前帧
 
-        if (!image.isNull()) {
-            QPixmap pixmap = QPixmap::fromImage(image);
-            
-            // 绘制前清空，防止UI残留
-            ui->imageDisplayLabel->clear();
-            ui->imageDisplayLabel->setPixmap(pixmap.scaled(ui->imageDisplayLabel->size(), Qt::KeepAspectRatio, Qt::SmoothTransformation));
-            
-            // 确保显示的是图像页面
-            if (ui->displayStackedWidget->currentIndex() != 1) {
-                 ui->displayStackedWidget->setCurrentIndex(1);
-            }
-            
-            // ******** START: 修改：更新FPS和分辨率 ********
-            m_videoStreamWidth = width;
-            m_videoStreamHeight = height;
-            // 立即更新标签文本（而不是等待定时器）
-            updateFpsDisplay(); 
-            
-            // 提取状态码并检查
-            QByteArray statusBytes = m_videoFrameBuffer.mid(9, 3);
-            updateFingerprintStatus(statusBytes, image); // 传入当前帧
-            
-            m_fpsCounter++; 
+    // FPS 统计解码帧数，包括被跳过显示的帧
+    m_fpsCounter += decodedFrames;
+}
 
-        } else {
-            qDebug() << "[Video ERROR] QImage无法从数据加载。";
-        }
+void MainWindow::on_smoothScalingCheckBox_toggled(bool checked) {
+    ui->videoSurfaceWidget->setScalingMode(checked ? VideoSurfaceWidget::ScalingMode::Smooth
+                                                   : VideoSurfaceWidget::ScalingMode::Fast);
+}
 
-        // 从缓冲区移除已处理的完整帧
-        m_videoFrameBuffer.remove(0, totalFrameSize);
-    }
+void MainWindow::on_packetizedVideoCheckBox_toggled(bool checked) {
+    VideoStreamDecoder *decoder = m_videoDecoder;
+    QMetaObject::invokeMethod(decoder, [decoder, checked]() { decoder->setPacketizedMode(checked); }, Qt::QueuedConnection);
 }
 
 void MainWindow::updateFpsDisplay() {
-    // 这个函数现在由定时器（每秒）和processVideoFrameBuffer（每帧）调用
+    // 这个函数现在由定时器（每秒）和onVideoFrameReady（每帧）调用
     
     // 如果是定时器触发，则更新FPS值
     if (sender() == m_fpsTimer) {
         m_currentFps = m_fpsCounter;
         m_fpsCounter = 0;
+        updateVideoStatsPanel(m_fpsTimer->interval() / 1000.0);
     }
 
     // 任何情况下（无论是定时器还是新帧）都更新标签文本
-    if (m_isUdpStreaming) {
-        ui->resolutionLabel->setText(QString("%1 x %2 @ %3 FPS")
-                                     .arg(m_videoStreamWidth)
-                                     .arg(m_videoStreamHeight)
-                                     .arg(m_currentFps));
+    if (m_isUdpStreaming || m_isVideoReplay) {
+        QString text = QString("%1 x %2 @ %3 FPS")
+                .arg(m_videoStreamWidth)
+                .arg(m_videoStreamHeight)
+                .arg(m_currentFps);
+        if (ui->packetizedVideoCheckBox->isChecked()) {
+            // 分包模式下附带丢包统计
+            const VideoStreamDecoder::Stats stats = m_videoDecoder->stats();
+            const quint64 expected = stats.packets + stats.lostPackets;
+            text += QString("  丢包 %1 (%2%)  迟到 %3  补齐帧 %4")
+                    .arg(stats.lostPackets)
+                    .arg(expected > 0 ? stats.lostPackets * 100.0 / expected : 0.0, 0, 'f', 2)
+                    .arg(stats.latePackets)
+                    .arg(stats.partialFrames);
+        }
+        ui->resolutionLabel->setText(text);
     } else {
         ui->resolutionLabel->clear();
     }
 }
 
-void MainWindow::onUdpReassemblyTimeout() {
-    if (m_udpBuffer.isEmpty()) return;
-    handleIncomingData(m_udpBuffer);
-    m_udpBuffer.clear();
-    m_lastUdpSenderHost.clear();
-    m_lastUdpSenderPort = 0;
+void MainWindow::updateVideoStatsPanel(double intervalSeconds) {
+    const VideoStreamDecoder::Stats stats = m_videoDecoder->stats();
+    const VideoStreamDecoder::Stats &last = m_lastVideoStats;
+    // 解码器复位后计数从 0 开始，差值按 0 处理
+    auto rate = [intervalSeconds](quint64 now, quint64 before) {
+        return now >= before ? (now - before) / intervalSeconds : 0.0;
+    };
+    const quint64 decodedDelta = stats.decodedFrames >= last.decodedFrames ? stats.decodedFrames - last.decodedFrames : 0;
+    const quint64 decodeNsDelta = stats.decodeTimeNs >= last.decodeTimeNs ? stats.decodeTimeNs - last.decodeTimeNs : 0;
+
+    m_videoStatRows = {
+        { "displayed_frames", "显示帧", static_cast<double>(stats.decodedFrames), static_cast<double>(m_currentFps) },
+        { "completed_frames", "完整帧", static_cast<double>(stats.completedFrames), rate(stats.completedFrames, last.completedFrames) },
+        { "corrupted_frames", "损坏/中断帧", static_cast<double>(stats.corruptedFrames), rate(stats.corruptedFrames, last.corruptedFrames) },
+        { "invalid_headers", "无效帧头", static_cast<double>(stats.invalidHeaders), rate(stats.invalidHeaders, last.invalidHeaders) },
+        { "resync_discarded_bytes", "重同步丢弃字节", static_cast<double>(stats.discardedBytes), rate(stats.discardedBytes, last.discardedBytes) },
+        { "packets", "有效数据包", static_cast<double>(stats.packets), rate(stats.packets, last.packets) },
+        { "lost_packets", "丢包", static_cast<double>(stats.lostPackets), rate(stats.lostPackets, last.lostPackets) },
+        { "late_packets", "迟到包", static_cast<double>(stats.latePackets), rate(stats.latePackets, last.latePackets) },
+        { "frame_resyncs", "帧号重同步", static_cast<double>(stats.frameResyncs), rate(stats.frameResyncs, last.frameResyncs) },
+        { "duplicate_packets", "重复包", static_cast<double>(stats.duplicatePackets), rate(stats.duplicatePackets, last.duplicatePackets) },
+        { "invalid_packets", "无效包", static_cast<double>(stats.invalidPackets), rate(stats.invalidPackets, last.invalidPackets) },
+        { "partial_frames", "补齐帧", static_cast<double>(stats.partialFrames), rate(stats.partialFrames, last.partialFrames) },
+        { "skipped_frames", "跳过帧", static_cast<double>(stats.skippedFrames), rate(stats.skippedFrames, last.skippedFrames) },
+        // 解码耗时两列分别是整体平均值和本周期平均值 (毫秒)
+        { "decode_ms_avg", "平均解码耗时 (ms)",
+          stats.decodedFrames > 0 ? stats.decodeTimeNs / 1e6 / stats.decodedFrames : 0.0,
+          decodedDelta > 0 ? decodeNsDelta / 1e6 / decodedDelta : 0.0 },
+        { "decode_ms_max", "最大解码耗时 (ms)", stats.maxDecodeTimeNs / 1e6, 0.0 },
+    };
+    m_lastVideoStats = stats;
+
+    QTableWidget *table = ui->videoStatsTable;
+    table->setRowCount(m_videoStatRows.size());
+    for (int row = 0; row < m_videoStatRows.size(); ++row) {
+        const VideoStatRow &stat = m_videoStatRows.at(row);
+        const int precision = stat.key.startsWith("decode_ms") ? 3 : 0;
+        const QString texts[3] = { stat.label, QString::number(stat.total, 'f', precision),
+                                   QString::number(stat.perSecond, 'f', stat.key.startsWith("decode_ms") ? 3 : 1) };
+        for (int column = 0; column < 3; ++column) {
+            QTableWidgetItem *item = table->item(row, column);
+            if (!item) {
+                item = new QTableWidgetItem();
+                table->setItem(row, column, item);
+            }
+            item->setText(texts[column]);
+        }
+    }
 }
 
-void MainWindow::onTcpReassemblyTimeout() {
-    if (m_tcpBuffer.isEmpty()) return;
-    handleIncomingData(m_tcpBuffer);
-    m_tcpBuffer.clear();
+void MainWindow::on_exportVideoStatsButton_clicked() {
+    if (m_videoStatRows.isEmpty()) {
+        QMessageBox::information(this, "提示", "还没有视频统计数据。");
+        return;
+    }
+    const QString filePath = QFileDialog::getSaveFileName(this, "导出视频统计",
+                                                          QString("video_stats_%1.csv").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+                                                          "CSV (*.csv);;JSON (*.json)");
+    if (filePath.isEmpty()) return;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "错误", "无法写入文件: " + file.errorString());
+        return;
+    }
+    if (filePath.endsWith(".json", Qt::CaseInsensitive)) {
+        QJsonObject metrics;
+        for (const VideoStatRow &stat : m_videoStatRows) {
+            metrics.insert(stat.key, QJsonObject{ { "total", stat.total }, { "per_second", stat.perSecond } });
+        }
+        const QJsonObject root{ { "timestamp", QDateTime::currentDateTime().toString(Qt::ISODateWithMs) },
+                                { "width", m_videoStreamWidth },
+                                { "height", m_videoStreamHeight },
+                                { "packetized", ui->packetizedVideoCheckBox->isChecked() },
+                                { "metrics", metrics } };
+        file.write(QJsonDocument(root).toJson());
+    } else {
+        QByteArray csv("metric,total,per_second\n");
+        for (const VideoStatRow &stat : m_videoStatRows) {
+            csv += QString("%1,%2,%3\n").arg(stat.key).arg(stat.total, 0, 'f', 3).arg(stat.perSecond, 0, 'f', 3).toUtf8();
+        }
+        file.write(csv);
+    }
+    m_statusLabel->setText("视频统计已导出: " + QFileInfo(filePath).fileName());
+}
+
+// === 接收分帧 ===
+void MainWindow::on_framerComboBox_currentIndexChanged(int index) {
+    ui->framerParamLineEdit->clear();
+    updateFramerParamField(index);
+    applyFramerSettings();
+}
+
+void MainWindow::on_framerParamLineEdit_editingFinished() {
+    applyFramerSettings();
+}
+
+int MainWindow::currentFramerTransport() const {
+    switch (ui->communicationModeComboBox->currentIndex()) {
+        case 0: return SerialFramer;
+        case 1: return TcpClientFramer;
+        case 3: return TcpServerFramer;
+        default: return -1;
+    }
+}
+
+// 界面只显示当前通信模式的分帧设置
+void MainWindow::showFramerSettings() {
+    const int transport = currentFramerTransport();
+    const FramerSetting setting = transport >= 0 ? m_framerSettings[transport] : FramerSetting { 0, QString(), StreamFramer::Config() };
+    {
+        const QSignalBlocker blocker(ui->framerComboBox);
+        ui->framerComboBox->setCurrentIndex(setting.type);
+    }
+    ui->framerParamLineEdit->setText(setting.param);
+    ui->framerComboBox->setEnabled(transport >= 0);
+    updateFramerParamField(transport >= 0 ? setting.type : 0);
+}
+
+void MainWindow::updateFramerParamField(int type) {
+    static const char *const kPlaceholders[] = {
+        "", "微秒，默认 200000", "1/2/4 [be|le] [+hdr]，默认 2be", "默认 \\n，支持 \\r \\n \\xHH", "", "", "字节数，默认 64"
+    };
+    const bool hasParam = type >= 0 && type < 7 && kPlaceholders[type][0] != '\0';
+    ui->framerParamLineEdit->setEnabled(hasParam);
+    ui->framerParamLineEdit->setPlaceholderText(hasParam ? QString(kPlaceholders[type]) : QString());
+}
+
+void MainWindow::applyFramerSettings() {
+    const int transport = currentFramerTransport();
+    if (transport < 0) return;
+    // 与 framerComboBox 的选项一一对应
+    static const char *const kFramerNames[] = { "none", "idle", "length", "delim", "slip", "cobs", "fixed" };
+    const int type = qBound(0, ui->framerComboBox->currentIndex(), 6);
+    QString spec = kFramerNames[type];
+    const QString param = ui->framerParamLineEdit->text().trimmed();
+    if (!param.isEmpty()) spec += ":" + param;
+
+    StreamFramer::Config config;
+    QString error;
+    if (!StreamFramer::parseSpec(spec, &config, &error)) {
+        m_statusLabel->setText("分帧设置无效: " + error);
+        return;
+    }
+    // 切换前把这条流中攒着的数据交出去，新的分帧器从空状态开始
+    flushFramers(transport);
+    m_framerSettings[transport] = { type, param, config };
+    resetFramers(transport);
+}
+
+void MainWindow::resetFramers(int transport) {
+    const StreamFramer::Config &config = m_framerSettings[transport].config;
+    switch (transport) {
+        case SerialFramer: m_serialFramer = StreamFramer::create(config); break;
+        case TcpClientFramer: m_tcpFramer = StreamFramer::create(config); break;
+        case TcpServerFramer: m_serverFramers.clear(); break; // 各客户端收到数据时按新设置创建
+    }
+    // 其他传输的空闲间隔仍在计时，定时器不停；提前到期只会重新检查一遍
+}
+
+QList<QByteArray> MainWindow::frameIncoming(StreamFramer *framer, const QByteArray &data) {
+    QList<QByteArray> frames;
+    framer->feed(data, m_framerClock.nsecsElapsed(), &frames);
+    scheduleFramerTimer(framer->deadlineNs());
+    return frames;
+}
+
+// 定时器只跟踪最早的到期时刻，到期后检查所有分帧器并重新安排
+void MainWindow::scheduleFramerTimer(qint64 deadlineNs) {
+    if (deadlineNs < 0) return;
+    if (m_framerTimer->isActive() && m_framerDeadlineNs <= deadlineNs) return;
+    m_framerDeadlineNs = deadlineNs;
+    const qint64 remainingNs = deadlineNs - m_framerClock.nsecsElapsed();
+    m_framerTimer->start(static_cast<int>(qBound<qint64>(0, (remainingNs + 999999) / 1000000, 60 * 60 * 1000)));
+}
+
+void MainWindow::onFramerTimeout() {
+    const qint64 nowNs = m_framerClock.nsecsElapsed();
+    qint64 nextDeadlineNs = -1;
+    auto track = [&nextDeadlineNs](const StreamFramer *framer) {
+        const qint64 deadlineNs = framer->deadlineNs();
+        if (deadlineNs >= 0 && (nextDeadlineNs < 0 || deadlineNs < nextDeadlineNs)) nextDeadlineNs = deadlineNs;
+    };
+
+    QList<QByteArray> frames;
+    m_serialFramer->poll(nowNs, &frames);
+    m_tcpFramer->poll(nowNs, &frames);
+    track(m_serialFramer.get());
+    track(m_tcpFramer.get());
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
+    }
+    for (auto it = m_serverFramers.cbegin(); it != m_serverFramers.cend(); ++it) {
+        QList<QByteArray> serverFrames;
+        it.value()->poll(nowNs, &serverFrames);
+        track(it.value().get());
+        deliverServerFrames(serverFrames, it.key());
+    }
+    scheduleFramerTimer(nextDeadlineNs);
+}
+
+void MainWindow::flushFramers(int transport) {
+    if (transport == TcpServerFramer) {
+        for (auto it = m_serverFramers.cbegin(); it != m_serverFramers.cend(); ++it) {
+            QList<QByteArray> serverFrames;
+            it.value()->flush(&serverFrames);
+            deliverServerFrames(serverFrames, it.key());
+        }
+        return;
+    }
+    QList<QByteArray> frames;
+    StreamFramer *framer = transport == SerialFramer ? m_serialFramer.get() : m_tcpFramer.get();
+    if (framer) framer->flush(&frames);
+    for (const QByteArray &frame : frames) {
+        handleIncomingData(frame);
+    }
+}
+
+void MainWindow::deliverServerFrames(const QList<QByteArray> &frames, quint64 clientId) {
+    if (frames.isEmpty()) return;
+    const QString clientInfo = m_clientListModel->clientInfo(clientId);
+    const QDateTime now = QDateTime::currentDateTime();
+    for (const QByteArray &frame : frames) {
+        appendLog({now, LogEntry::In, frame, clientInfo});
+    }
 }
 
 // === TCP服务器槽函数实现 ===
-void MainWindow::onClientConnected(const QString &clientInfo) {
-    ui->clientListWidget->addItem(clientInfo);
-    updateControlsState();
+void MainWindow::connectTcpServerManager() {
+    m_tcpServerManager->setTrafficStats(m_trafficStats.get());
+    connect(m_tcpServerManager.get(), &ITcpServerManager::clientConnected, this, &MainWindow::onClientConnected);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::clientDisconnected, this, &MainWindow::onClientDisconnected);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::dataReceived, this, &MainWindow::onServerDataReceived);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::serverMessage, this, &MainWindow::onServerMessage);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::bytesWritten, m_fileSender, &FileSender::onBytesWritten);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::sendCompleted, this, &MainWindow::onServerSendCompleted);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::sendFinished, this, &MainWindow::onServerSendFinished);
+    connect(m_tcpServerManager.get(), &ITcpServerManager::groupsChanged, this, &MainWindow::refreshServerSendTargets);
 }
 
-void MainWindow::onClientDisconnected(const QString &clientInfo) {
-    for (int i = 0; i < ui->clientListWidget->count(); ++i) {
-        if (ui->clientListWidget->item(i)->text() == clientInfo) {
-            delete ui->clientListWidget->takeItem(i);
-            break;
+quint64 MainWindow::selectedClientId() const {
+    return m_clientListModel->clientIdAt(ui->clientListView->currentIndex().row());
+}
+
+QList<quint64> MainWindow::selectedClientIds() const {
+    QList<quint64> clientIds;
+    const QModelIndexList rows = ui->clientListView->selectionModel()->selectedRows();
+    for (const QModelIndex &index : rows) {
+        if (const quint64 clientId = m_clientListModel->clientIdAt(index.row())) clientIds.append(clientId);
+    }
+    return clientIds;
+}
+
+QList<quint64> MainWindow::serverSendTargets() const {
+    switch (ui->serverSendTargetComboBox->currentIndex()) {
+        case 0: return selectedClientIds();
+        case 1: return m_tcpServerManager->clientIds();
+        default: return m_tcpServerManager->groupMembers(ui->serverSendTargetComboBox->currentText());
+    }
+}
+
+void MainWindow::writeToServerTargets(const QByteArray &data, const QList<quint64> &targets) {
+    const quint64 sendId = m_tcpServerManager->writeToClients(data, targets);
+    if (sendId == 0) return;
+    m_trackedSends.insert(sendId);
+    for (quint64 clientId : targets) {
+        m_clientListModel->setSendState(clientId, TcpClientListModel::SendPending);
+    }
+}
+
+void MainWindow::onServerSendCompleted(quint64 sendId, quint64 clientId, bool success) {
+    if (!m_trackedSends.contains(sendId)) return;
+    m_clientListModel->setSendState(clientId, success ? TcpClientListModel::SendDone : TcpClientListModel::SendFailed);
+}
+
+void MainWindow::onServerSendFinished(quint64 sendId, int succeeded, int failed) {
+    if (!m_trackedSends.remove(sendId)) return;
+    if (succeeded + failed > 1) {
+        m_statusLabel->setText(QString("群发完成: %1 个客户端成功, %2 个失败").arg(succeeded).arg(failed));
+    }
+}
+
+// 前两项固定为 "选定的客户端" 和 "所有客户端"，其后是当前的分组
+void MainWindow::refreshServerSendTargets() {
+    const QString current = ui->serverSendTargetComboBox->currentText();
+    const int currentIndex = ui->serverSendTargetComboBox->currentIndex();
+    const QStringList groups = m_tcpServerManager->groupNames();
+    {
+        const QSignalBlocker blocker(ui->serverSendTargetComboBox);
+        while (ui->serverSendTargetComboBox->count() > 2) {
+            ui->serverSendTargetComboBox->removeItem(2);
         }
+        ui->serverSendTargetComboBox->addItems(groups);
+        if (currentIndex >= 2) {
+            // 分组被删除 (成员全部断开) 时退回到选定的客户端
+            const int index = groups.indexOf(current);
+            ui->serverSendTargetComboBox->setCurrentIndex(index >= 0 ? index + 2 : 0);
+        }
+    }
+    updateControlsState();
+}
+
+void MainWindow::onClientConnected(quint64 clientId, const QString &clientInfo) {
+    m_clientListModel->addClient(clientId, clientInfo);
+    updateControlsState();
+}
+
+void MainWindow::onClientDisconnected(quint64 clientId) {
+    if (const std::shared_ptr<StreamFramer> framer = m_serverFramers.take(clientId)) {
+        QList<QByteArray> frames;
+        framer->flush(&frames);
+        deliverServerFrames(frames, clientId);
     }
+    m_clientListModel->removeClient(clientId);
     updateControlsState();
 }
 
-void MainWindow::onServerDataReceived(const QByteArray &data, const QString &clientInfo) {
+void MainWindow::onServerDataReceived(const QByteArray &data, quint64 clientId) {
+    const QString clientInfo = m_clientListModel->clientInfo(clientId);
+    m_captureWriter->record(CaptureWriter::Transport::TcpServer, CaptureWriter::RecordType::Rx, clientInfo, data);
     m_rxBytes += data.size();
     updateByteCounters();
-    
-    m_logBuffer.append({QDateTime::currentDateTime(), LogEntry::In, data, clientInfo});
-    updateLogDisplay();
+
+    std::shared_ptr<StreamFramer> &framer = m_serverFramers[clientId];
+    if (!framer) framer = StreamFramer::create(m_framerSettings[TcpServerFramer].config);
+    deliverServerFrames(frameIncoming(framer.get(), data), clientId);
 }
 
 void MainWindow::onServerMessage(const QString &message) {
@@ -938,10 +1768,23 @@ void MainWindow::onServerMessage(const QString &message) {
 }
 
 void MainWindow::on_disconnectClientButton_clicked() {
-    if (ui->clientListWidget->currentItem()) {
-        QString clientInfo = ui->clientListWidget->currentItem()->text();
-        m_tcpServerManager->disconnectClient(clientInfo);
+    if (const quint64 clientId = selectedClientId()) {
+        m_tcpServerManager->disconnectClient(clientId);
+    }
+}
+
+void MainWindow::on_addToGroupButton_clicked() {
+    const QString group = ui->clientGroupLineEdit->text().trimmed();
+    if (group.isEmpty()) {
+        QMessageBox::warning(this, "警告", "请输入分组名。");
+        return;
+    }
+    const QList<quint64> clientIds = selectedClientIds();
+    for (quint64 clientId : clientIds) {
+        m_tcpServerManager->addToGroup(group, clientId);
     }
+    const int index = ui->serverSendTargetComboBox->findText(group);
+    if (index >= 2) ui->serverSendTargetComboBox->setCurrentIndex(index);
 }
 
 // ******** START: 优化和修改后的函数 ********
@@ -4,11 +4,18 @@
 #include <QMainWindow>
 #include <QLabel>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <memory>
 #include "SerialManager.h"
 #include "TcpManager.h"
 #include "IUdpManager.h"
-#include "TcpServerManager.h"
+#include "ITcpServerManager.h"
+#include "LogModel.h"
+#include "CaptureWriter.h"
+#include "TrafficStats.h"
+#include "VideoStreamDecoder.h"
+#include "StreamFramer.h"
+#include "SessionManager.h"
 
 #include <QMediaPlayer>
 #include <QTemporaryFile>
@@ -19,15 +26,11 @@ namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
 class QTimer;
-
-struct LogEntry {
-    enum Direction { In, Out };
-
-    QDateTime timestamp;
-    Direction direction;
-    QByteArray rawData;
-    QString sourceInfo;
-};
+class QThread;
+class CaptureReplayer;
+class FileSender;
+class PacedUdpSender;
+class TcpClientListModel;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -50,6 +53,18 @@ private slots:
     void on_playPauseButton_clicked();
     void on_progressSlider_valueChanged(int value);
     void on_disconnectClientButton_clicked();
+    void on_addToGroupButton_clicked();
+    void on_smoothScalingCheckBox_toggled(bool checked);
+    void on_packetizedVideoCheckBox_toggled(bool checked);
+    void on_exportVideoStatsButton_clicked();
+    void on_logMemoryLimitSpinBox_valueChanged(int megabytes);
+    void on_logSpillDirectoryButton_clicked();
+    void on_captureButton_toggled(bool checked);
+    void on_replayButton_toggled(bool checked);
+    void on_replayMaxSpeedCheckBox_toggled(bool checked);
+    void on_pacedSendCheckBox_toggled(bool checked);
+    void on_framerComboBox_currentIndexChanged(int index);
+    void on_framerParamLineEdit_editingFinished();
 
     // 通信管理器槽函数
     void onSerialDataReceived(const QByteArray &data);
@@ -64,17 +79,25 @@ private slots:
     void onUdpUnbound();
     void onUdpDataReceived(const QByteArray &data, const QString &senderHost, quint16 senderPort);
     // TCP 服务器槽函数
-    void onClientConnected(const QString &clientInfo);
-    void onClientDisconnected(const QString &clientInfo);
-    void onServerDataReceived(const QByteArray &data, const QString &clientInfo);
+    void onClientConnected(quint64 clientId, const QString &clientInfo);
+    void onClientDisconnected(quint64 clientId);
+    void onServerDataReceived(const QByteArray &data, quint64 clientId);
     void onServerMessage(const QString &message);
+    void onServerSendCompleted(quint64 sendId, quint64 clientId, bool success);
+    void onServerSendFinished(quint64 sendId, int succeeded, int failed);
+    void refreshServerSendTargets();
 
     // 其他槽函数
     void updateLogDisplay();
-    void onUdpReassemblyTimeout();
-    void onTcpReassemblyTimeout();
-    void sendFileChunk();
+    void onFramerTimeout();
+    void onFileSendProgress(qint64 sentBytes, qint64 totalBytes, double bytesPerSecond);
+    void onFileSendFinished(bool success, const QString &errorText);
+    void onPacedSendProgress(qint64 sentBytes, qint64 totalBytes, double bitsPerSecond, double packetsPerSecond);
+    void onPacedSendFinished(bool success, qint64 packets, qint64 elapsedNs, const QString &errorText);
     void updateFpsDisplay();
+    void onVideoFrameReady();
+    void onReplayProgress(qint64 records, qint64 bytes, int percent);
+    void onReplayFinished(qint64 records, qint64 bytes, qint64 elapsedNs, const QString &errorText);
 
     // 媒体播放器状态更新槽函数
     void updatePlaybackState(QMediaPlayer::PlaybackState state);
@@ -88,19 +111,58 @@ private:
     void updatePortList();
     void updateControlsState();
     void updateByteCounters();
+    void appendLog(const LogEntry &entry);
     // <-- ******** 修改：增加了QImage参数 ********
     void updateFingerprintStatus(const QByteArray &statusBytes, const QImage &currentFrame); 
     void handleIncomingData(const QByteArray &data);
-    void processVideoFrameBuffer();
+    void resetVideoDecoder();
+    void setVideoSurfaceVisible(bool visible);
     void saveErrorFrame(const QImage &image);
+    // 发送记录在抓包中归属的传输方式和对端
+    struct CaptureTarget {
+        CaptureWriter::Transport transport = CaptureWriter::Transport::Serial;
+        QStringList peers;               // TCP 服务器群发时每个目标客户端一项
+    };
+    CaptureTarget currentCaptureTarget() const;
+    void captureSent(const QByteArray &data);
+    void captureSent(const QByteArray &data, const CaptureTarget &target);
+    bool writeToCurrentTransport(const QByteArray &data);
+    void updateVideoStatsPanel(double intervalSeconds);
+    void startPacedSend(const QString &filePath);
+    void stopPacedSend();
+    void connectTcpServerManager();
+    quint64 selectedClientId() const; // 未选中客户端时返回 0
+    // 分帧设置按传输分开保存；UDP 数据报本身就是消息，不分帧
+    enum FramerTransport { SerialFramer, TcpClientFramer, TcpServerFramer, FramerTransportCount };
+    struct FramerSetting {
+        int type;                     // framerComboBox 的选项
+        QString param;
+        StreamFramer::Config config;
+    };
+    int currentFramerTransport() const; // 当前通信模式没有分帧时返回 -1
+    void showFramerSettings();
+    void updateFramerParamField(int type);
+    void applyFramerSettings();
+    void resetFramers(int transport);
+    QList<QByteArray> frameIncoming(StreamFramer *framer, const QByteArray &data);
+    void scheduleFramerTimer(qint64 deadlineNs);
+    void flushFramers(int transport);
+    void deliverServerFrames(const QList<QByteArray> &frames, quint64 clientId);
+    QList<quint64> selectedClientIds() const;
+    QList<quint64> serverSendTargets() const; // 按 "发送到" 选项得到的目标客户端
+    void writeToServerTargets(const QByteArray &data, const QList<quint64> &targets);
 
 private:
     Ui::MainWindow *ui;
 
+    // 各管理器和发送线程直接记录流量，必须比它们活得更久，因此放在最前面
+    std::unique_ptr<TrafficStats> m_trafficStats;
     std::unique_ptr<SerialManager> m_serialManager;
     std::unique_ptr<TcpManager> m_tcpManager;
     std::unique_ptr<IUdpManager> m_udpManager;
-    std::unique_ptr<TcpServerManager> m_tcpServerManager;
+    std::unique_ptr<ITcpServerManager> m_tcpServerManager;
+    std::unique_ptr<CaptureWriter> m_captureWriter;
+    std::unique_ptr<SessionManager> m_sessionManager; // "多会话" 页中并行运行的会话，与上面的单一连接互不影响
 
     // 媒体播放器
     QMediaPlayer *m_mediaPlayer;
@@ -109,7 +171,6 @@ private:
     // 定时器
     QTimer *m_autoSendTimer;
     QTimer *m_portScanTimer;
-    QTimer *m_fileSendTimer;
     QTimer *m_fpsTimer;
 
     // 状态栏
@@ -121,19 +182,50 @@ private:
     long long m_rxBytes;
     long long m_txBytes;
     QList<QString> m_knownPorts;
-    QList<LogEntry> m_logBuffer;
-    QByteArray m_tcpBuffer;
-    QByteArray m_udpBuffer;
-    QTimer* m_udpReassemblyTimer;
-    QTimer* m_tcpReassemblyTimer;
-    QString m_lastUdpSenderHost;
-    quint16 m_lastUdpSenderPort;
-    QByteArray m_fileDataToSend;
-    qint64 m_fileSendOffset;
+    LogModel *m_rxLogModel;
+    LogModel *m_txLogModel;
+    TcpClientListModel *m_clientListModel;
+    QSet<quint64> m_trackedSends;       // 需要在客户端列表中显示进度的群发
+
+    // 接收分帧：每条字节流一个分帧器，空闲间隔方式共用一个定时器检查到期
+    FramerSetting m_framerSettings[FramerTransportCount];
+    std::unique_ptr<StreamFramer> m_serialFramer;
+    std::unique_ptr<StreamFramer> m_tcpFramer;
+    QHash<quint64, std::shared_ptr<StreamFramer>> m_serverFramers; // 键为 TCP 服务器的客户端句柄
+    QTimer *m_framerTimer;
+    qint64 m_framerDeadlineNs;           // m_framerTimer 对应的到期时刻
+    QElapsedTimer m_framerClock;
+    FileSender *m_fileSender;
+    int m_fileSendSegmentSize;          // UDP 批量发送时每个数据报的大小，0 表示每个分块就是一个数据报
+    CaptureTarget m_fileSendCaptureTarget; // 开始发送时的目标，发送途中切换界面不影响抓包
+
+    // UDP 精确限速发送
+    QThread *m_pacedSendThread;
+    PacedUdpSender *m_pacedUdpSender;   // 运行在 m_pacedSendThread 中
+    bool m_isPacedSending;
+    QString m_pacedRequestedRate;       // 界面上显示的目标速率
+    qint64 m_pacedReportedBytes;        // 已计入发送字节数的部分
 
     // UDP视频流相关
     bool m_isUdpStreaming;
-    QByteArray m_videoFrameBuffer;
+    QThread *m_videoThread;             // 视频解码工作线程
+    VideoStreamDecoder *m_videoDecoder; // 运行在 m_videoThread 中
+    bool m_isVideoReplay;               // 正在把抓包回放到视频解码器
+
+    // 视频统计面板：key 用于导出，label 显示在表格中
+    struct VideoStatRow {
+        QString key;
+        QString label;
+        double total;
+        double perSecond;
+    };
+    QList<VideoStatRow> m_videoStatRows;
+    VideoStreamDecoder::Stats m_lastVideoStats; // 上一次刷新时的累计值，用于计算每秒速率
+
+    // 抓包回放
+    QThread *m_replayThread;
+    CaptureReplayer *m_captureReplayer; // 运行在 m_replayThread 中
+    QMetaObject::Connection m_replayConnection;
 
     bool m_videoHeaderReceived; // 标志位，用于判断是否已收到帧头
     quint16 m_videoStreamWidth;   // 从流中解析出的视频宽度
@@ -0,0 +1,175 @@
+#include "PacedUdpSender.h"
+#include "CaptureWriter.h"
+#include "TokenBucket.h"
+#include "TrafficStats.h"
+#include "UdpDestination.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QThread>
+
+namespace {
+constexpr qint64 kReadBlockBytes = 4 * 1024 * 1024;  // 每次从文件读取的块大小 (整包对齐)
+constexpr qint64 kSpinThresholdNs = 200000;           // 剩余不足 200 us 时不再休眠，改为让出时间片
+constexpr qint64 kMaxSleepUs = 50000;                  // 单次休眠上限，保证及时响应停止请求
+constexpr int kProgressIntervalMs = 100;
+constexpr int kWouldBlockRetryUs = 50;                 // 发送缓冲满时的重试间隔
+}
+
+PacedUdpSender::PacedUdpSender(QObject *parent)
+    : QObject(parent)
+    , m_stopRequested(false)
+    , m_captureWriter(nullptr)
+    , m_trafficStats(nullptr)
+{
+}
+
+PacedUdpSender::~PacedUdpSender() {
+}
+
+void PacedUdpSender::requestStop() {
+    m_stopRequested.store(true, std::memory_order_release);
+}
+
+void PacedUdpSender::stopAndWait() {
+    requestStop();
+    QMutexLocker locker(&m_runMutex);
+}
+
+void PacedUdpSender::waitUntil(qint64 deadlineNs, qint64 nowNs) {
+    const qint64 remainingNs = deadlineNs - nowNs;
+    if (remainingNs > kSpinThresholdNs) {
+        // 提前醒来，留出系统定时器的误差
+        const qint64 sleepUs = qMin<qint64>((remainingNs - kSpinThresholdNs) / 1000, kMaxSleepUs);
+        QThread::usleep(static_cast<unsigned long>(qMax<qint64>(sleepUs, 1)));
+    } else {
+        QThread::yieldCurrentThread();
+    }
+}
+
+void PacedUdpSender::sendFile(qintptr socketDescriptor, const QString &host, quint16 port, const QString &filePath,
+                              int packetSize, double rate, PacedUdpSender::RateUnit unit, int burstPackets) {
+    QMutexLocker locker(&m_runMutex);
+    m_stopRequested.store(false, std::memory_order_release);
+
+    UdpDestination destination;
+    if (!destination.resolve(socketDescriptor, host, port)) {
+        emit finished(false, 0, 0, QString("无效的目标地址: %1:%2").arg(host).arg(port));
+        return;
+    }
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        emit finished(false, 0, 0, file.errorString());
+        return;
+    }
+    const qint64 total = file.size();
+    if (total <= 0 || packetSize <= 0) {
+        emit finished(false, 0, 0, "文件为空，无需发送。");
+        return;
+    }
+
+    // 按字节限速时令牌是字节，按包数限速时令牌是包
+    TokenBucket bucket;
+    const int burst = qMax(burstPackets, 1);
+    if (unit == RateUnit::MegabitsPerSecond) {
+        bucket.configure(rate * 1e6 / 8.0, static_cast<double>(burst) * packetSize);
+    } else {
+        bucket.configure(rate, burst);
+    }
+
+    QElapsedTimer clock;
+    clock.start();
+    bucket.reset(0);
+
+    const qint64 blockBytes = qMax<qint64>(kReadBlockBytes / packetSize, 1) * packetSize;
+    QByteArray block;
+    qint64 sent = 0;
+    qint64 packets = 0;
+    qint64 lastProgressNs = 0;
+    qint64 lastProgressBytes = 0;
+    qint64 lastProgressPackets = 0;
+    QString errorText;
+    const QString peer = QString("%1:%2").arg(host).arg(port);
+
+    while (sent < total && errorText.isEmpty()) {
+        block = file.read(qMin(blockBytes, total - sent));
+        if (block.isEmpty()) {
+            errorText = "读取文件失败: " + file.errorString();
+            break;
+        }
+
+        for (qint64 offset = 0; offset < block.size(); ) {
+            if (m_stopRequested.load(std::memory_order_acquire)) {
+                errorText = "发送已取消";
+                break;
+            }
+
+            // 令牌允许时一次取出最多 burst 个包，用一次 sendBatch (sendmmsg / GSO) 发出
+            qint64 nowNs = clock.nsecsElapsed();
+            qint64 batchBytes = 0;
+            int batchPackets = 0;
+            qint64 waitNs = 0;
+            while (batchPackets < burst && offset + batchBytes < block.size()) {
+                const qint64 length = qMin<qint64>(packetSize, block.size() - offset - batchBytes);
+                const double cost = (unit == RateUnit::MegabitsPerSecond) ? static_cast<double>(length) : 1.0;
+                waitNs = bucket.reserve(cost, nowNs);
+                if (waitNs > 0) break;
+                batchBytes += length;
+                ++batchPackets;
+            }
+            if (batchPackets == 0) {
+                waitUntil(nowNs + waitNs, nowNs);
+                continue;
+            }
+
+            const char *batch = block.constData() + offset;
+            qint64 batchSent = 0;
+            while (batchSent < batchBytes && !m_stopRequested.load(std::memory_order_acquire)) {
+                const qsizetype result = destination.sendBatch(socketDescriptor, batch + batchSent,
+                                                               batchBytes - batchSent, packetSize);
+                if (result < 0) {
+                    errorText = "发送失败: " + UdpDestination::lastErrorString();
+                    break;
+                }
+                batchSent += result;
+                if (batchSent < batchBytes) {
+                    QThread::usleep(kWouldBlockRetryUs); // 发送缓冲已满
+                }
+            }
+
+            if (m_captureWriter && m_captureWriter->isActive()) {
+                for (qint64 captured = 0; captured < batchSent; captured += packetSize) {
+                    const qsizetype length = static_cast<qsizetype>(qMin<qint64>(packetSize, batchSent - captured));
+                    m_captureWriter->record(CaptureWriter::Transport::Udp, CaptureWriter::RecordType::Tx, peer,
+                                            QByteArray::fromRawData(batch + captured, length));
+                }
+            }
+            const qint64 batchSentPackets = (batchSent + packetSize - 1) / packetSize;
+            if (m_trafficStats && batchSent > 0) {
+                m_trafficStats->record(TrafficStats::Tx, CaptureWriter::Transport::Udp, host, port, batchSent,
+                                       static_cast<quint64>(batchSentPackets));
+            }
+            offset += batchSent;
+            sent += batchSent;
+            packets += batchSentPackets;
+            if (!errorText.isEmpty()) break;
+
+            nowNs = clock.nsecsElapsed();
+            if (nowNs - lastProgressNs >= kProgressIntervalMs * 1000000LL) {
+                const double seconds = (nowNs - lastProgressNs) / 1e9;
+                emit progress(sent, total, (sent - lastProgressBytes) * 8.0 / seconds,
+                              (packets - lastProgressPackets) / seconds);
+                lastProgressNs = nowNs;
+                lastProgressBytes = sent;
+                lastProgressPackets = packets;
+            }
+        }
+    }
+
+    const qint64 elapsedNs = clock.nsecsElapsed();
+    if (errorText.isEmpty() && elapsedNs > 0) {
+        // 最后一次报告整体平均速率
+        const double seconds = elapsedNs / 1e9;
+        emit progress(sent, total, sent * 8.0 / seconds, packets / seconds);
+    }
+    emit finished(errorText.isEmpty(), packets, elapsedNs, errorText);
+}
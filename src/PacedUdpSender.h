@@ -0,0 +1,55 @@
+#ifndef PACEDUDPSENDER_H
+#define PACEDUDPSENDER_H
+
+#include <QObject>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+
+class CaptureWriter;
+class TrafficStats;
+
+// 精确限速的 UDP 文件发送工作者，运行在独立线程中。
+// 用令牌桶控制速率 (Mbit/s 或 包/秒)，包间隔可以小于 1 ms：
+// 距离发送时刻较远时休眠，最后 kSpinThresholdNs 内让出时间片忙等，
+// 事件循环的定时器精度 (毫秒级) 不再限制发送速率。令牌足够时同一突发内的包一次批量发出。
+// 直接在 UDP 管理器的原生套接字上 sendto，调用方必须在解绑端口前调用 stopAndWait()。
+class PacedUdpSender : public QObject {
+    Q_OBJECT
+
+public:
+    enum class RateUnit { MegabitsPerSecond, PacketsPerSecond };
+
+    explicit PacedUdpSender(QObject *parent = nullptr);
+    ~PacedUdpSender() override;
+
+    // 可在任意线程调用
+    void requestStop();
+    // 请求停止并阻塞到发送循环退出，之后可以安全地关闭套接字
+    void stopAndWait();
+
+    // 抓包写入器的 record() 是线程安全的，发送线程直接记录每个发出的包
+    void setCaptureWriter(CaptureWriter *writer) { m_captureWriter = writer; }
+    // 同上，流量统计同样直接在发送线程中记录
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; }
+
+public slots:
+    // rate <= 0 表示不限速；burstPackets 是允许连续发出的最大包数
+    void sendFile(qintptr socketDescriptor, const QString &host, quint16 port, const QString &filePath,
+                  int packetSize, double rate, PacedUdpSender::RateUnit unit, int burstPackets);
+
+signals:
+    void progress(qint64 sentBytes, qint64 totalBytes, double bitsPerSecond, double packetsPerSecond);
+    void finished(bool success, qint64 packets, qint64 elapsedNs, const QString &errorText);
+
+private:
+    void waitUntil(qint64 deadlineNs, qint64 nowNs);
+
+private:
+    std::atomic<bool> m_stopRequested;
+    CaptureWriter *m_captureWriter;
+    TrafficStats *m_trafficStats;
+    QMutex m_runMutex;    // sendFile 执行期间持有
+};
+
+#endif // PACEDUDPSENDER_H
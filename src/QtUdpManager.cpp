@@ -1,6 +1,7 @@
 #include "QtUdpManager.h"
 #include <QHostAddress>
 #include <QVariant>
+#include "TrafficStats.h"
 
 // 构造函数：将 UdpManager:: 修正为 QtUdpManager::
 QtUdpManager::QtUdpManager(QObject *parent) : IUdpManager(parent) {
@@ -19,6 +20,7 @@ bool QtUdpManager::bindPort(quint16 port) {
     
     m_udpSocket->setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, QVariant(2 * 1024 * 1024));
 
+    m_targetHost.clear();
     if (m_udpSocket->bind(QHostAddress::Any, port)) {
         emit portBound();
         return true;
@@ -36,16 +38,46 @@ void QtUdpManager::unbindPort() {
 
 // writeData 函数：将 UdpManager:: 修正为 QtUdpManager::
 void QtUdpManager::writeData(const QByteArray &data, const QString &host, quint16 port) {
-    if (isBound()) {
-        m_udpSocket->writeDatagram(data, QHostAddress(host), port);
+    if (isBound() && m_udpSocket->writeDatagram(data, targetAddress(host), port) >= 0 && m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, CaptureWriter::Transport::Udp, host, port, data.size());
+    }
+}
+
+void QtUdpManager::writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) {
+    if (!isBound() || segmentSize <= 0) return;
+    // QUdpSocket 没有批量接口，至少省掉每包的地址解析和 QByteArray 构造
+    const QHostAddress &address = targetAddress(host);
+    qint64 sentBytes = 0;
+    quint64 sentPackets = 0;
+    for (qsizetype offset = 0; offset < data.size(); offset += segmentSize) {
+        const qsizetype length = qMin<qsizetype>(segmentSize, data.size() - offset);
+        if (m_udpSocket->writeDatagram(data.constData() + offset, length, address, port) >= 0) {
+            sentBytes += length;
+            ++sentPackets;
+        }
+    }
+    if (sentPackets > 0 && m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, CaptureWriter::Transport::Udp, host, port, sentBytes, sentPackets);
     }
 }
 
+const QHostAddress &QtUdpManager::targetAddress(const QString &host) {
+    if (host != m_targetHost) {
+        m_targetHost = host;
+        m_targetAddress = QHostAddress(host);
+    }
+    return m_targetAddress;
+}
+
 // isBound 函数：将 UdpManager:: 修正为 QtUdpManager::
 bool QtUdpManager::isBound() const {
     return m_udpSocket->state() == QAbstractSocket::BoundState;
 }
 
+qintptr QtUdpManager::socketDescriptor() const {
+    return isBound() ? m_udpSocket->socketDescriptor() : -1;
+}
+
 // handleReadyRead 函数：将 UdpManager:: 修正为 QtUdpManager::
 void QtUdpManager::handleReadyRead() {
     while (m_udpSocket->hasPendingDatagrams()) {
@@ -55,7 +87,11 @@ void QtUdpManager::handleReadyRead() {
         quint16 senderPort;
 
         m_udpSocket->readDatagram(datagram.data(), datagram.size(), &senderHost, &senderPort);
+        const QString host = senderHost.toString();
+        if (m_trafficStats) {
+            m_trafficStats->record(TrafficStats::Rx, CaptureWriter::Transport::Udp, host, senderPort, datagram.size());
+        }
         
-        emit dataReceived(datagram, senderHost.toString(), senderPort);
+        emit dataReceived(datagram, host, senderPort);
     }
 }
\ No newline at end of file
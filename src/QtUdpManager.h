@@ -3,6 +3,7 @@
 
 #include "IUdpManager.h" // 包含接口头文件
 #include <QUdpSocket>
+#include <QHostAddress>
 
 class QtUdpManager : public IUdpManager { // 继承自 IUdpManager
     Q_OBJECT
@@ -15,13 +16,21 @@ public:
     bool bindPort(quint16 port) override;
     void unbindPort() override;
     void writeData(const QByteArray &data, const QString &host, quint16 port) override;
+    void writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) override;
     bool isBound() const override;
+    qintptr socketDescriptor() const override;
 
 private slots:
     void handleReadyRead();
 
+private:
+    const QHostAddress &targetAddress(const QString &host);
+
 private:
     QUdpSocket *m_udpSocket;
+    // 目标地址缓存，避免每个数据报都重新解析字符串
+    QString m_targetHost;
+    QHostAddress m_targetAddress;
 };
 
 #endif // QTUDPMANAGER_H
\ No newline at end of file
@@ -0,0 +1,213 @@
+#include "Rgb565Kernels.h"
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RGB565_HAS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC/Clang 需要为 AVX2 函数单独开启目标指令集；MSVC 无需额外标记
+#if defined(RGB565_HAS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RGB565_TARGET_AVX2 __attribute__((target("avx2")))
+#define RGB565_TARGET_SSE2 __attribute__((target("sse2")))
+#else
+#define RGB565_TARGET_AVX2
+#define RGB565_TARGET_SSE2
+#endif
+
+namespace Rgb565Kernels {
+
+namespace {
+
+inline quint32 expandPixel(quint16 p) {
+    const quint32 r5 = p >> 11;
+    const quint32 g6 = (p >> 5) & 0x3F;
+    const quint32 b5 = p & 0x1F;
+    const quint32 r8 = (r5 << 3) | (r5 >> 2);
+    const quint32 g8 = (g6 << 2) | (g6 >> 4);
+    const quint32 b8 = (b5 << 3) | (b5 >> 2);
+    return 0xFF000000u | (r8 << 16) | (g8 << 8) | b8;
+}
+
+#ifdef RGB565_HAS_X86
+
+RGB565_TARGET_SSE2 void swapBytesSse2(const uchar *src, uchar *dst, qsizetype pixelCount) {
+    qsizetype i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i * 2), v);
+    }
+    swapBytesScalar(src + i * 2, dst + i * 2, pixelCount - i);
+}
+
+// 8 个 16 位像素 (已是本机字节序) -> 两组各 4 个 32 位像素
+RGB565_TARGET_SSE2 inline void expandSse2(__m128i p, __m128i *lo, __m128i *hi) {
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i r5 = _mm_srli_epi16(p, 11);
+    const __m128i g6 = _mm_and_si128(_mm_srli_epi16(p, 5), mask6);
+    const __m128i b5 = _mm_and_si128(p, mask5);
+    const __m128i r8 = _mm_or_si128(_mm_slli_epi16(r5, 3), _mm_srli_epi16(r5, 2));
+    const __m128i g8 = _mm_or_si128(_mm_slli_epi16(g6, 2), _mm_srli_epi16(g6, 4));
+    const __m128i b8 = _mm_or_si128(_mm_slli_epi16(b5, 3), _mm_srli_epi16(b5, 2));
+    const __m128i gb = _mm_or_si128(b8, _mm_slli_epi16(g8, 8));           // 低 16 位: G B
+    const __m128i ar = _mm_or_si128(r8, _mm_set1_epi16(static_cast<short>(0xFF00))); // 高 16 位: A R
+    *lo = _mm_unpacklo_epi16(gb, ar);
+    *hi = _mm_unpackhi_epi16(gb, ar);
+}
+
+RGB565_TARGET_SSE2 void convertSse2(const uchar *src, quint32 *dst, qsizetype pixelCount) {
+    qsizetype i = 0;
+    for (; i + 8 <= pixelCount; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i * 2));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        __m128i lo, hi;
+        expandSse2(v, &lo, &hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i + 4), hi);
+    }
+    convertBigEndianToRgb32Scalar(src + i * 2, dst + i, pixelCount - i);
+}
+
+RGB565_TARGET_AVX2 void swapBytesAvx2(const uchar *src, uchar *dst, qsizetype pixelCount) {
+    qsizetype i = 0;
+    for (; i + 16 <= pixelCount; i += 16) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 2));
+        v = _mm256_or_si256(_mm256_slli_epi16(v, 8), _mm256_srli_epi16(v, 8));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i * 2), v);
+    }
+    swapBytesScalar(src + i * 2, dst + i * 2, pixelCount - i);
+}
+
+RGB565_TARGET_AVX2 void convertAvx2(const uchar *src, quint32 *dst, qsizetype pixelCount) {
+    const __m256i mask5 = _mm256_set1_epi16(0x1F);
+    const __m256i mask6 = _mm256_set1_epi16(0x3F);
+    const __m256i alpha = _mm256_set1_epi16(static_cast<short>(0xFF00));
+    qsizetype i = 0;
+    for (; i + 16 <= pixelCount; i += 16) {
+        __m256i p = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i * 2));
+        p = _mm256_or_si256(_mm256_slli_epi16(p, 8), _mm256_srli_epi16(p, 8));
+        const __m256i r5 = _mm256_srli_epi16(p, 11);
+        const __m256i g6 = _mm256_and_si256(_mm256_srli_epi16(p, 5), mask6);
+        const __m256i b5 = _mm256_and_si256(p, mask5);
+        const __m256i r8 = _mm256_or_si256(_mm256_slli_epi16(r5, 3), _mm256_srli_epi16(r5, 2));
+        const __m256i g8 = _mm256_or_si256(_mm256_slli_epi16(g6, 2), _mm256_srli_epi16(g6, 4));
+        const __m256i b8 = _mm256_or_si256(_mm256_slli_epi16(b5, 3), _mm256_srli_epi16(b5, 2));
+        const __m256i gb = _mm256_or_si256(b8, _mm256_slli_epi16(g8, 8));
+        const __m256i ar = _mm256_or_si256(r8, alpha);
+        // unpack 按 128 位通道工作，得到 [0-3, 8-11] 和 [4-7, 12-15]，再重排回顺序
+        const __m256i lo = _mm256_unpacklo_epi16(gb, ar);
+        const __m256i hi = _mm256_unpackhi_epi16(gb, ar);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    convertBigEndianToRgb32Scalar(src + i * 2, dst + i, pixelCount - i);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    // 操作系统必须保存 YMM 寄存器状态
+    if ((_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // RGB565_HAS_X86
+
+typedef void (*SwapFn)(const uchar *, uchar *, qsizetype);
+typedef void (*ConvertFn)(const uchar *, quint32 *, qsizetype);
+
+struct KernelTable {
+    SwapFn swap;
+    ConvertFn convert;
+    const char *name;
+};
+
+bool cpuHasSse2() {
+#ifdef RGB565_HAS_X86
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return true;
+#elif defined(__GNUC__) || defined(__clang__)
+    return __builtin_cpu_supports("sse2");
+#endif
+#endif
+    return false;
+}
+
+KernelTable selectKernels() {
+#ifdef RGB565_HAS_X86
+    if (cpuHasAvx2()) {
+        return { swapBytesAvx2, convertAvx2, "avx2" };
+    }
+    if (cpuHasSse2()) {
+        return { swapBytesSse2, convertSse2, "sse2" };
+    }
+#endif
+    return { swapBytesScalar, convertBigEndianToRgb32Scalar, "scalar" };
+}
+
+const KernelTable &kernels() {
+    static const KernelTable table = selectKernels();
+    return table;
+}
+
+} // namespace
+
+void swapBytesScalar(const uchar *src, uchar *dst, qsizetype pixelCount) {
+    for (qsizetype i = 0; i < pixelCount; ++i) {
+        const uchar hi = src[i * 2];
+        dst[i * 2] = src[i * 2 + 1];
+        dst[i * 2 + 1] = hi;
+    }
+}
+
+void convertBigEndianToRgb32Scalar(const uchar *src, quint32 *dst, qsizetype pixelCount) {
+    for (qsizetype i = 0; i < pixelCount; ++i) {
+        dst[i] = expandPixel(static_cast<quint16>((src[i * 2] << 8) | src[i * 2 + 1]));
+    }
+}
+
+void swapBytes(const uchar *src, uchar *dst, qsizetype pixelCount) {
+    kernels().swap(src, dst, pixelCount);
+}
+
+void convertBigEndianToRgb32(const uchar *src, quint32 *dst, qsizetype pixelCount) {
+    kernels().convert(src, dst, pixelCount);
+}
+
+const char *activeKernelName() {
+    return kernels().name;
+}
+
+bool kernelByName(const char *name, SwapFunction *swap, ConvertFunction *convert) {
+    KernelTable table { nullptr, nullptr, nullptr };
+    if (std::strcmp(name, "scalar") == 0) {
+        table = { swapBytesScalar, convertBigEndianToRgb32Scalar, "scalar" };
+#ifdef RGB565_HAS_X86
+    } else if (std::strcmp(name, "sse2") == 0 && cpuHasSse2()) {
+        table = { swapBytesSse2, convertSse2, "sse2" };
+    } else if (std::strcmp(name, "avx2") == 0 && cpuHasAvx2()) {
+        table = { swapBytesAvx2, convertAvx2, "avx2" };
+#endif
+    }
+    if (!table.swap) return false;
+    if (swap) *swap = table.swap;
+    if (convert) *convert = table.convert;
+    return true;
+}
+
+} // namespace Rgb565Kernels
@@ -0,0 +1,32 @@
+#ifndef RGB565KERNELS_H
+#define RGB565KERNELS_H
+
+#include <QtGlobal>
+
+// 视频通路使用的 RGB565 像素转换内核。
+// 运行时根据 CPU 特性在 AVX2 / SSE2 / 标量实现之间选择，三者输出逐位一致。
+namespace Rgb565Kernels {
+
+// 交换每个像素的两个字节：大端 RGB565 -> 本机字节序 RGB565 (QImage::Format_RGB16)
+void swapBytes(const uchar *src, uchar *dst, qsizetype pixelCount);
+
+// 大端 RGB565 -> 0xFFRRGGBB，可直接写入 QImage::Format_RGB32 / Format_ARGB32_Premultiplied。
+// 位扩展方式与 Qt 自身的 RGB16 -> RGB32 转换相同 (高位复制到低位)
+void convertBigEndianToRgb32(const uchar *src, quint32 *dst, qsizetype pixelCount);
+
+// 标量参考实现，始终可用
+void swapBytesScalar(const uchar *src, uchar *dst, qsizetype pixelCount);
+void convertBigEndianToRgb32Scalar(const uchar *src, quint32 *dst, qsizetype pixelCount);
+
+// 当前选中的实现名称："avx2"、"sse2" 或 "scalar"
+const char *activeKernelName();
+
+// 按名称取得某一实现 ("avx2"、"sse2" 或 "scalar")，当前 CPU 不支持时返回 false。
+// 用于测试和基准逐一比较各实现，正常路径请用上面的自动选择版本
+typedef void (*SwapFunction)(const uchar *src, uchar *dst, qsizetype pixelCount);
+typedef void (*ConvertFunction)(const uchar *src, quint32 *dst, qsizetype pixelCount);
+bool kernelByName(const char *name, SwapFunction *swap, ConvertFunction *convert);
+
+} // namespace Rgb565Kernels
+
+#endif // RGB565KERNELS_H
@@ -0,0 +1,115 @@
+// Rgb565Kernels 的一致性测试：当前 CPU 支持的每个实现 (avx2 / sse2 / scalar) 都与标量参考实现、
+// 以及原来的逐像素 std::swap + QImage RGB16 -> RGB32 转换逐位比较。
+// 覆盖 0..300 个像素的每个长度 (包括奇数和不满一个向量的尾部)，以及非对齐的输入地址和 (字节交换的) 输出地址。
+#include "Rgb565Kernels.h"
+#include <QImage>
+#include <QRandomGenerator>
+#include <QTest>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+constexpr int kMaxPixels = 300;
+constexpr int kMaxOffset = 3;   // 输入、输出相对对齐地址的最大字节偏移
+
+std::vector<uchar> randomBytes(size_t size, quint32 seed) {
+    std::vector<uchar> bytes(size);
+    QRandomGenerator generator(seed);
+    for (uchar &byte : bytes) {
+        byte = static_cast<uchar>(generator.bounded(256));
+    }
+    return bytes;
+}
+
+// 旧实现：逐像素 std::swap 得到本机字节序的 RGB16，再由 Qt 转成 RGB32
+std::vector<quint32> qtReference(const uchar *src, int pixelCount) {
+    std::vector<quint32> result(static_cast<size_t>(pixelCount));
+    if (pixelCount == 0) return result;
+    std::vector<uchar> swapped(src, src + pixelCount * 2);
+    for (int i = 0; i < pixelCount; ++i) {
+        std::swap(swapped[i * 2], swapped[i * 2 + 1]);
+    }
+    const QImage rgb16(swapped.data(), pixelCount, 1, pixelCount * 2, QImage::Format_RGB16);
+    const QImage rgb32 = rgb16.convertToFormat(QImage::Format_RGB32);
+    const quint32 *line = reinterpret_cast<const quint32 *>(rgb32.constScanLine(0));
+    std::copy(line, line + pixelCount, result.begin());
+    return result;
+}
+
+void addKernelRows() {
+    QTest::addColumn<QByteArray>("kernel");
+    for (const char *name : { "scalar", "sse2", "avx2" }) {
+        if (Rgb565Kernels::kernelByName(name, nullptr, nullptr)) {
+            QTest::newRow(name) << QByteArray(name);
+        }
+    }
+}
+}
+
+class Rgb565KernelsTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void swapBytes_data() { addKernelRows(); }
+    void swapBytes();
+    void convertToRgb32_data() { addKernelRows(); }
+    void convertToRgb32();
+    void activeKernelIsAvailable();
+};
+
+void Rgb565KernelsTest::swapBytes() {
+    QFETCH(QByteArray, kernel);
+    Rgb565Kernels::SwapFunction swap = nullptr;
+    QVERIFY(Rgb565Kernels::kernelByName(kernel.constData(), &swap, nullptr));
+
+    for (int pixels = 0; pixels <= kMaxPixels; ++pixels) {
+        const std::vector<uchar> input = randomBytes(pixels * 2 + kMaxOffset, pixels);
+        for (int srcOffset = 0; srcOffset <= kMaxOffset; ++srcOffset) {
+            for (int dstOffset = 0; dstOffset <= kMaxOffset; ++dstOffset) {
+                const uchar *src = input.data() + srcOffset;
+                // 输出缓冲两端各留一个哨兵字节，检查没有越界写
+                std::vector<uchar> output(pixels * 2 + kMaxOffset + 1, 0xA5);
+                std::vector<uchar> expected(output);
+                swap(src, output.data() + dstOffset, pixels);
+                Rgb565Kernels::swapBytesScalar(src, expected.data() + dstOffset, pixels);
+                QVERIFY2(output == expected, qPrintable(QString("pixels=%1 src+%2 dst+%3").arg(pixels).arg(srcOffset).arg(dstOffset)));
+
+                std::vector<uchar> stdSwapped(src, src + pixels * 2);
+                for (int i = 0; i < pixels; ++i) {
+                    std::swap(stdSwapped[i * 2], stdSwapped[i * 2 + 1]);
+                }
+                QVERIFY(std::equal(stdSwapped.begin(), stdSwapped.end(), output.begin() + dstOffset));
+            }
+        }
+    }
+}
+
+void Rgb565KernelsTest::convertToRgb32() {
+    QFETCH(QByteArray, kernel);
+    Rgb565Kernels::ConvertFunction convert = nullptr;
+    QVERIFY(Rgb565Kernels::kernelByName(kernel.constData(), nullptr, &convert));
+
+    for (int pixels = 0; pixels <= kMaxPixels; ++pixels) {
+        const std::vector<uchar> input = randomBytes(pixels * 2 + kMaxOffset, 0x10000u + pixels);
+        for (int srcOffset = 0; srcOffset <= kMaxOffset; ++srcOffset) {
+            const uchar *src = input.data() + srcOffset;
+            // 输出多留一个哨兵像素，检查没有越界写
+            std::vector<quint32> output(pixels + 1, 0xA5A5A5A5u);
+            std::vector<quint32> expected(output);
+            convert(src, output.data(), pixels);
+            Rgb565Kernels::convertBigEndianToRgb32Scalar(src, expected.data(), pixels);
+            QVERIFY2(output == expected, qPrintable(QString("pixels=%1 src+%2").arg(pixels).arg(srcOffset)));
+
+            output.pop_back();
+            QVERIFY2(output == qtReference(src, pixels), qPrintable(QString("pixels=%1 src+%2 与 QImage 转换不一致").arg(pixels).arg(srcOffset)));
+        }
+    }
+}
+
+void Rgb565KernelsTest::activeKernelIsAvailable() {
+    QVERIFY(Rgb565Kernels::kernelByName(Rgb565Kernels::activeKernelName(), nullptr, nullptr));
+}
+
+QTEST_APPLESS_MAIN(Rgb565KernelsTest)
+#include "Rgb565KernelsTest.moc"
@@ -1,13 +1,188 @@
 #include "SerialManager.h"
+#include "TrafficStats.h"
+#include "LinuxSerialTuning.h"
 
-SerialManager::SerialManager(QObject *parent) : QObject(parent) {
-    m_serialPort = new QSerialPort(this);
-    connect(m_serialPort, &QSerialPort::readyRead, this, &SerialManager::handleReadyRead);
-    connect(m_serialPort, &QSerialPort::errorOccurred, this, &SerialManager::handleError);
+#include <QCoreApplication>
+#include <QDebug>
+#include <QThread>
+#include <QTimer>
+
+namespace {
+
+// 批量方式：最多攒这么久或这么多字节就交出
+constexpr int kBatchIntervalMs = 10;
+constexpr int kBatchMaxBytes = 64 * 1024;
+
+} // namespace
+
+SerialPortWorker::SerialPortWorker(QObject *parent)
+    : QObject(parent)
+    , m_serialPort(nullptr)
+    , m_batchTimer(nullptr)
+{
+}
+
+bool SerialPortWorker::open(const Settings &settings)
+{
+    if (!m_serialPort) {
+        m_serialPort = new QSerialPort(this);
+        connect(m_serialPort, &QSerialPort::readyRead, this, &SerialPortWorker::handleReadyRead);
+        connect(m_serialPort, &QSerialPort::errorOccurred, this, &SerialPortWorker::handleError);
+        connect(m_serialPort, &QSerialPort::bytesWritten, this, &SerialPortWorker::bytesWritten);
+        m_batchTimer = new QTimer(this);
+        m_batchTimer->setSingleShot(true);
+        m_batchTimer->setTimerType(Qt::PreciseTimer);
+        connect(m_batchTimer, &QTimer::timeout, this, &SerialPortWorker::flushBatch);
+    }
+    close();
+    m_settings = settings;
+    m_statsPeer = settings.trafficStats
+            ? settings.trafficStats->peer(CaptureWriter::Transport::Serial, settings.portName, 0) : TrafficStats::PeerHandle();
+
+    m_serialPort->setPortName(settings.portName);
+#ifdef Q_OS_LINUX
+    // 系统没有对应 Bxxx 常量的速率先按 115200 打开，打开后再用 termios2 设置实际值
+    const bool customBaudRate = !QSerialPortInfo::standardBaudRates().contains(settings.baudRate);
+    m_serialPort->setBaudRate(customBaudRate ? QSerialPort::Baud115200 : settings.baudRate);
+#else
+    m_serialPort->setBaudRate(settings.baudRate);
+#endif
+    m_serialPort->setDataBits(settings.dataBits);
+    m_serialPort->setParity(settings.parity);
+    m_serialPort->setStopBits(settings.stopBits);
+    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    m_serialPort->setReadBufferSize(0); // 不限制，本线程总能及时取走数据
+
+    if (!m_serialPort->open(QIODevice::ReadWrite)) {
+        return false; // 错误已经通过 handleError 报告
+    }
+
+#ifdef Q_OS_LINUX
+    if (customBaudRate) {
+        qint32 actualBaudRate = 0;
+        QString errorText;
+        if (!LinuxSerialTuning::setCustomBaudRate(m_serialPort->handle(), settings.baudRate, &actualBaudRate, &errorText)) {
+            m_serialPort->close();
+            emit errorOccurred(QString("无法设置波特率 %1: %2").arg(settings.baudRate).arg(errorText), false);
+            return false;
+        }
+        if (actualBaudRate != settings.baudRate) {
+            qWarning() << "串口" << settings.portName << "请求波特率" << settings.baudRate << "，驱动实际为" << actualBaudRate;
+        }
+    }
+    if (settings.lowLatency) {
+        QString errorText;
+        if (!LinuxSerialTuning::setLowLatency(m_serialPort->handle(), true, &errorText)) {
+            // 部分驱动不支持，不影响正常收发
+            qWarning() << "串口" << settings.portName << "无法启用 ASYNC_LOW_LATENCY:" << errorText;
+        }
+    }
+#endif
+    return true;
+}
+
+void SerialPortWorker::close()
+{
+    if (!m_serialPort || !m_serialPort->isOpen()) {
+        return;
+    }
+    // 驱动里剩下的数据和未交出的批量数据都在关闭前交出
+    const QByteArray remaining = m_serialPort->readAll();
+    if (!remaining.isEmpty()) {
+        deliver(remaining);
+    }
+    flushBatch();
+    m_serialPort->close();
+}
+
+void SerialPortWorker::write(const QByteArray &data)
+{
+    if (!m_serialPort || !m_serialPort->isOpen() || !m_serialPort->isWritable()) {
+        return;
+    }
+    // 只统计实际交给串口的字节，写入失败 (返回 -1) 时不计
+    const qint64 written = m_serialPort->write(data);
+    if (written > 0 && m_settings.trafficStats) {
+        m_settings.trafficStats->record(TrafficStats::Tx, m_statsPeer, written);
+    }
+}
+
+void SerialPortWorker::handleReadyRead()
+{
+    const QByteArray data = m_serialPort->readAll();
+    if (!data.isEmpty()) {
+        deliver(data);
+    }
+}
+
+void SerialPortWorker::deliver(const QByteArray &data)
+{
+    if (m_settings.trafficStats) {
+        m_settings.trafficStats->record(TrafficStats::Rx, m_statsPeer, data.size());
+    }
+    if (!m_settings.batched) {
+        emit dataReceived(data);
+        return;
+    }
+    m_batch.append(data);
+    if (m_batch.size() >= kBatchMaxBytes) {
+        flushBatch();
+    } else if (!m_batchTimer->isActive()) {
+        m_batchTimer->start(kBatchIntervalMs);
+    }
+}
+
+void SerialPortWorker::flushBatch()
+{
+    if (m_batchTimer) {
+        m_batchTimer->stop();
+    }
+    if (m_batch.isEmpty()) {
+        return;
+    }
+    QByteArray batch;
+    batch.swap(m_batch);
+    emit dataReceived(batch);
+}
+
+void SerialPortWorker::handleError(QSerialPort::SerialPortError error)
+{
+    if (error == QSerialPort::NoError) {
+        return;
+    }
+    const QString errorText = m_serialPort->errorString();
+    const bool closed = error == QSerialPort::ResourceError && m_serialPort->isOpen();
+    if (closed) {
+        // 设备被拔出等情况，先把已收到的数据交出再关闭
+        flushBatch();
+        m_serialPort->close();
+    }
+    emit errorOccurred(errorText, closed);
+}
+
+SerialManager::SerialManager(QObject *parent)
+    : QObject(parent)
+    , m_thread(new QThread(this))
+    , m_worker(new SerialPortWorker)
+    , m_trafficStats(nullptr)
+    , m_readMode(ReadMode::LowLatency)
+    , m_lowLatency(false)
+    , m_isOpen(false)
+    , m_pendingBytes(0)
+{
+    m_thread->setObjectName("SerialIO");
+    m_worker->moveToThread(m_thread);
+    connect(m_thread, &QThread::finished, m_worker, &QObject::deleteLater);
+    connect(m_worker, &SerialPortWorker::dataReceived, this, &SerialManager::dataReceived);
+    connect(m_worker, &SerialPortWorker::bytesWritten, this, &SerialManager::handleBytesWritten);
+    connect(m_worker, &SerialPortWorker::errorOccurred, this, &SerialManager::handleError);
+    m_thread->start(QThread::TimeCriticalPriority);
 }
 
 SerialManager::~SerialManager() {
     closePort();
+    m_thread->quit();
+    m_thread->wait();
 }
 
 void SerialManager::openPort(const QString &portName, qint32 baudRate, QSerialPort::DataBits dataBits,
@@ -15,49 +190,80 @@ void SerialManager::openPort(const QString &portName, qint32 baudRate, QSerialPo
     if (isOpen()) {
         closePort();
     }
-    m_serialPort->setPortName(portName);
-    m_serialPort->setBaudRate(baudRate);
-    m_serialPort->setDataBits(dataBits);
-    m_serialPort->setParity(parity);
-    m_serialPort->setStopBits(stopBits);
-    m_serialPort->setFlowControl(QSerialPort::NoFlowControl);
+    SerialPortWorker::Settings settings;
+    settings.portName = portName;
+    settings.baudRate = baudRate;
+    settings.dataBits = dataBits;
+    settings.parity = parity;
+    settings.stopBits = stopBits;
+    settings.batched = m_readMode == ReadMode::Batched;
+    settings.lowLatency = m_lowLatency;
+    settings.trafficStats = m_trafficStats;
 
-    if (m_serialPort->open(QIODevice::ReadWrite)) {
+    bool opened = false;
+    QMetaObject::invokeMethod(m_worker, [this, &settings, &opened]() {
+        opened = m_worker->open(settings);
+    }, Qt::BlockingQueuedConnection);
+
+    // 打开失败时的错误信号已在队列中，先处理掉，调用方返回后即可看到
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    if (opened) {
+        m_isOpen = true;
+        m_pendingBytes = 0;
         emit portOpened();
-    } 
+    }
 }
 
 void SerialManager::closePort() {
-    if (m_serialPort->isOpen()) {
-        m_serialPort->close();
+    if (!m_isOpen) {
+        return;
+    }
+    QMetaObject::invokeMethod(m_worker, [this]() { m_worker->close(); }, Qt::BlockingQueuedConnection);
+    // 串口线程在关闭前交出的数据还在队列里，保证它们先于 portClosed 到达
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+    if (m_isOpen) {
+        m_isOpen = false;
+        m_pendingBytes = 0;
         emit portClosed();
     }
 }
 
 void SerialManager::writeData(const QByteArray &data) {
-    if (isOpen() && m_serialPort->isWritable()) {
-        m_serialPort->write(data);
+    if (!isOpen() || data.isEmpty()) {
+        return;
     }
+    m_pendingBytes += data.size();
+    SerialPortWorker *worker = m_worker;
+    QMetaObject::invokeMethod(m_worker, [worker, data]() { worker->write(data); }, Qt::QueuedConnection);
 }
 
 bool SerialManager::isOpen() const {
-    return m_serialPort->isOpen();
+    return m_isOpen;
+}
+
+qint64 SerialManager::bytesToWrite() const {
+    return m_pendingBytes;
 }
 
 QList<QSerialPortInfo> SerialManager::getAvailablePorts() {
     return QSerialPortInfo::availablePorts();
 }
 
-void SerialManager::handleReadyRead() {
-    const QByteArray data = m_serialPort->readAll();
-    emit dataReceived(data);
+QList<qint32> SerialManager::commonBaudRates() {
+    return {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600,
+            1000000, 1500000, 2000000, 3000000, 4000000, 6000000, 8000000, 12000000};
 }
 
-void SerialManager::handleError(QSerialPort::SerialPortError error) {
-    if (error != QSerialPort::NoError) {
-        if (error == QSerialPort::ResourceError) {
-             closePort();
-        }
-        emit errorOccurred(m_serialPort->errorString());
+void SerialManager::handleBytesWritten(qint64 bytes) {
+    m_pendingBytes = qMax<qint64>(0, m_pendingBytes - bytes);
+    emit bytesWritten(bytes);
+}
+
+void SerialManager::handleError(const QString &errorText, bool closed) {
+    if (closed && m_isOpen) {
+        m_isOpen = false;
+        m_pendingBytes = 0;
+        emit portClosed();
     }
-}
\ No newline at end of file
+    emit errorOccurred(errorText);
+}
@@ -4,34 +4,107 @@
 #include <QObject>
 #include <QSerialPort>
 #include <QSerialPortInfo>
+#include "TrafficStats.h"
+
+class QThread;
+class QTimer;
+
+// 工作类：在独立的串口线程中创建并读写 QSerialPort，界面线程繁忙时也能及时取走驱动里的数据，
+// 避免突发数据把 USB 转串口芯片 (如 FTDI) 的缓冲区撑爆
+class SerialPortWorker : public QObject
+{
+    Q_OBJECT
+public:
+    struct Settings {
+        QString portName;
+        qint32 baudRate = 115200;
+        QSerialPort::DataBits dataBits = QSerialPort::Data8;
+        QSerialPort::Parity parity = QSerialPort::NoParity;
+        QSerialPort::StopBits stopBits = QSerialPort::OneStop;
+        bool batched = false;     // 批量方式：攒满一小段时间或一定字节数再交出
+        bool lowLatency = false;  // 仅 Linux：ASYNC_LOW_LATENCY
+        TrafficStats *trafficStats = nullptr;
+    };
+
+    explicit SerialPortWorker(QObject *parent = nullptr);
+
+    // 以下都在串口线程中调用
+    bool open(const Settings &settings);
+    void close();
+    void write(const QByteArray &data);
+
+signals:
+    void dataReceived(const QByteArray &data);
+    void bytesWritten(qint64 bytes);
+    // closed 为 true 表示串口因该错误已被关闭
+    void errorOccurred(const QString &errorText, bool closed);
+
+private slots:
+    void handleReadyRead();
+    void handleError(QSerialPort::SerialPortError error);
+    void flushBatch();
+
+private:
+    void deliver(const QByteArray &data);
+
+    QSerialPort *m_serialPort; // 第一次 open 时在串口线程中创建
+    QTimer *m_batchTimer;
+    QByteArray m_batch;        // 批量方式下尚未交出的数据
+    Settings m_settings;
+    TrafficStats::PeerHandle m_statsPeer; // 打开时查找一次
+};
 
 class SerialManager : public QObject {
     Q_OBJECT
 
 public:
+    enum class ReadMode {
+        LowLatency, // 每次收到数据立即交出
+        Batched     // 按 10ms 或 64KB 合并后交出，高波特率下减少信号和界面刷新次数
+    };
+
     explicit SerialManager(QObject *parent = nullptr);
     ~SerialManager();
 
-    // 接收所有配置参数
+    // 以下两项在下一次 openPort 时生效
+    void setReadMode(ReadMode mode) { m_readMode = mode; }
+    void setLowLatency(bool enable) { m_lowLatency = enable; } // 仅 Linux 有效
+
+    // 接收所有配置参数。在串口线程中打开，返回时已打开 (或已报告错误)。
+    // 波特率可以是任意值，Linux 下非标准值通过 termios2 设置
     void openPort(const QString &portName, qint32 baudRate, QSerialPort::DataBits dataBits,
                   QSerialPort::Parity parity, QSerialPort::StopBits stopBits);
     void closePort();
+    // 由串口线程异步写出，data 不能是引用外部内存的 QByteArray::fromRawData
     void writeData(const QByteArray &data);
     bool isOpen() const;
+    // 已提交但尚未写入串口的字节数，用于发送端背压
+    qint64 bytesToWrite() const;
     static QList<QSerialPortInfo> getAvailablePorts();
+    // 界面上列出的常用波特率，包括 USB 转串口芯片支持的高速率
+    static QList<qint32> commonBaudRates();
+    // 为空时不统计
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; }
 
 signals:
     void portOpened();
     void portClosed();
     void dataReceived(const QByteArray &data);
+    void bytesWritten(qint64 bytes);
     void errorOccurred(const QString &errorText);
 
 private slots:
-    void handleReadyRead();
-    void handleError(QSerialPort::SerialPortError error);
+    void handleBytesWritten(qint64 bytes);
+    void handleError(const QString &errorText, bool closed);
 
 private:
-    QSerialPort *m_serialPort;
+    QThread *m_thread;
+    SerialPortWorker *m_worker; // 运行在 m_thread 中
+    TrafficStats *m_trafficStats;
+    ReadMode m_readMode;
+    bool m_lowLatency;
+    bool m_isOpen;
+    qint64 m_pendingBytes;      // 已交给串口线程但尚未写出的字节数
 };
 
-#endif // SERIALMANAGER_H
\ No newline at end of file
+#endif // SERIALMANAGER_H
@@ -0,0 +1,176 @@
+#include "SessionManager.h"
+#include "CliEndpoint.h"
+#include "TrafficStats.h"
+#include <QThread>
+#include <algorithm>
+
+namespace {
+constexpr int kMaxDefaultIoThreads = 4;
+}
+
+SessionManager::SessionManager(int ioThreads, QObject *parent)
+    : QObject(parent)
+    , m_nextSessionId(1)
+{
+    if (ioThreads <= 0) {
+        ioThreads = qBound(1, QThread::idealThreadCount(), kMaxDefaultIoThreads);
+    }
+    for (int i = 0; i < ioThreads; ++i) {
+        QThread *thread = new QThread(this);
+        thread->setObjectName(QString("SessionIO-%1").arg(i));
+        thread->start();
+        m_threads.append(thread);
+    }
+    m_epoch = QDateTime::currentDateTime();
+    m_clock.start();
+}
+
+SessionManager::~SessionManager() {
+    // 端点必须在自己的线程中关闭和析构，逐个等待完成后再停线程
+    for (auto it = m_sessions.begin(); it != m_sessions.end(); ++it) {
+        destroyEndpoint(it->endpoint);
+    }
+    m_sessions.clear();
+    for (QThread *thread : m_threads) {
+        thread->quit();
+        thread->wait();
+    }
+}
+
+quint64 SessionManager::addSession(const QString &spec, const StreamFramer::Config &framer, QString *error) {
+    // 使用 Qt 的 UDP / TCP 服务器实现：它们运行在会话所在的线程里，不再额外开线程
+    CliEndpoint *endpoint = CliEndpoint::fromSpec(spec, CliEndpoint::UdpBackend::Qt, error);
+    if (!endpoint) {
+        return 0;
+    }
+    const quint64 sessionId = m_nextSessionId++;
+
+    Session session;
+    session.spec = spec;
+    session.endpoint = endpoint;
+    session.thread = leastLoadedThread();
+    session.trafficStats = std::make_shared<TrafficStats>();
+    endpoint->setTrafficStats(session.trafficStats.get());
+    endpoint->setFramer(framer);
+
+    // 以下连接的上下文是端点本身，在 I/O 线程中执行：时间戳在收到数据的那一刻取得
+    connect(endpoint, &CliEndpoint::messageReceived, endpoint, [this, sessionId](const QByteArray &message, const QString &peer) {
+        emit messageReceived(sessionId, nowNs(), message, peer);
+    });
+    connect(endpoint, &CliEndpoint::errorOccurred, endpoint, [this, sessionId](const QString &errorText) {
+        emit errorOccurred(sessionId, nowNs(), errorText);
+    });
+    // 状态只在管理器所在的线程中修改
+    // 打开过程中被关闭的会话，迟到的 opened() 不再改回 Open
+    connect(endpoint, &CliEndpoint::opened, this, [this, sessionId]() {
+        if (state(sessionId) != State::Closed) setState(sessionId, State::Open);
+    });
+    connect(endpoint, &CliEndpoint::closed, this, [this, sessionId]() { setState(sessionId, State::Closed); });
+    // TCP 连接失败时只有错误，没有 closed()
+    connect(endpoint, &CliEndpoint::errorOccurred, this, [this, sessionId]() {
+        if (state(sessionId) == State::Opening) setState(sessionId, State::Closed);
+    });
+
+    endpoint->moveToThread(session.thread);
+    m_sessions.insert(sessionId, session);
+    emit sessionAdded(sessionId);
+    return sessionId;
+}
+
+void SessionManager::removeSession(quint64 sessionId) {
+    const auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end()) {
+        return;
+    }
+    // 同步等待端点析构：不会留下排队中的删除，管理器随后析构也不会泄漏；
+    // 端点析构前可能还在记录流量，统计对象在此之后才随会话释放
+    destroyEndpoint(it->endpoint);
+    m_sessions.erase(it);
+    emit sessionRemoved(sessionId);
+}
+
+void SessionManager::openSession(quint64 sessionId) {
+    const auto it = m_sessions.constFind(sessionId);
+    if (it == m_sessions.constEnd() || it->state != State::Closed) {
+        return;
+    }
+    setState(sessionId, State::Opening);
+    CliEndpoint *endpoint = it->endpoint;
+    QMetaObject::invokeMethod(endpoint, [this, endpoint, sessionId]() {
+        // 打开串口会阻塞到设置完成，只占用本会话所在的 I/O 线程
+        if (!endpoint->open()) {
+            QMetaObject::invokeMethod(this, [this, sessionId]() { setState(sessionId, State::Closed); }, Qt::QueuedConnection);
+        }
+    }, Qt::QueuedConnection);
+}
+
+void SessionManager::closeSession(quint64 sessionId) {
+    const auto it = m_sessions.constFind(sessionId);
+    if (it == m_sessions.constEnd() || it->state == State::Closed) {
+        return;
+    }
+    CliEndpoint *endpoint = it->endpoint;
+    QMetaObject::invokeMethod(endpoint, [endpoint]() { endpoint->close(); }, Qt::QueuedConnection);
+    // UDP / TCP 服务器关闭时不一定发出 closed()，这里直接更新状态
+    setState(sessionId, State::Closed);
+}
+
+void SessionManager::write(quint64 sessionId, const QByteArray &data) {
+    const auto it = m_sessions.constFind(sessionId);
+    if (it == m_sessions.constEnd() || it->state != State::Open || data.isEmpty()) {
+        return;
+    }
+    CliEndpoint *endpoint = it->endpoint;
+    // 在 I/O 线程中写出后再取时间戳，与同一会话的接收事件出自同一线程、同一时钟
+    QMetaObject::invokeMethod(endpoint, [this, endpoint, sessionId, data]() {
+        endpoint->write(data);
+        emit dataSent(sessionId, nowNs(), data);
+    }, Qt::QueuedConnection);
+}
+
+QList<quint64> SessionManager::sessionIds() const {
+    QList<quint64> ids = m_sessions.keys();
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+QString SessionManager::spec(quint64 sessionId) const {
+    return m_sessions.value(sessionId).spec;
+}
+
+SessionManager::State SessionManager::state(quint64 sessionId) const {
+    return m_sessions.value(sessionId).state;
+}
+
+TrafficStats *SessionManager::trafficStats(quint64 sessionId) const {
+    const auto it = m_sessions.constFind(sessionId);
+    return it != m_sessions.constEnd() ? it->trafficStats.get() : nullptr;
+}
+
+void SessionManager::destroyEndpoint(CliEndpoint *endpoint) {
+    QMetaObject::invokeMethod(endpoint, [endpoint]() {
+        endpoint->close();
+        delete endpoint;
+    }, Qt::BlockingQueuedConnection);
+}
+
+QThread *SessionManager::leastLoadedThread() const {
+    QHash<QThread *, int> load;
+    for (const Session &session : m_sessions) {
+        ++load[session.thread];
+    }
+    QThread *best = m_threads.first();
+    for (QThread *thread : m_threads) {
+        if (load.value(thread) < load.value(best)) best = thread;
+    }
+    return best;
+}
+
+void SessionManager::setState(quint64 sessionId, State state) {
+    const auto it = m_sessions.find(sessionId);
+    if (it == m_sessions.end() || it->state == state) {
+        return;
+    }
+    it->state = state;
+    emit stateChanged(sessionId, state);
+}
@@ -0,0 +1,86 @@
+#ifndef SESSIONMANAGER_H
+#define SESSIONMANAGER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <memory>
+#include "StreamFramer.h"
+
+class CliEndpoint;
+class QThread;
+class TrafficStats;
+
+// 同时运行多个相互独立的会话 (串口、TCP 客户端、TCP 服务器、UDP)。
+// 每个会话是一个 CliEndpoint，带自己的流量统计和分帧器，运行在共享的 I/O 线程池中：
+// 会话按当前负载分配到其中一个线程，收发和分帧都在该线程中完成，界面线程只接收结果。
+//
+// 所有事件使用同一个单调时钟打时间戳 (在 I/O 线程中收到数据时)，
+// 不同会话的事件因此可以直接按时间戳比较先后。
+class SessionManager : public QObject {
+    Q_OBJECT
+
+public:
+    enum class State { Closed, Opening, Open };
+
+    // ioThreads 为 0 时按 CPU 核数，最多 4 个
+    explicit SessionManager(int ioThreads = 0, QObject *parent = nullptr);
+    ~SessionManager() override;
+
+    // 新建会话但不打开。spec 格式同 CliEndpoint::fromSpec，格式错误时返回 0 并填写 error
+    quint64 addSession(const QString &spec, const StreamFramer::Config &framer, QString *error);
+    void removeSession(quint64 sessionId);
+    // 异步打开，结果通过 stateChanged 通知
+    void openSession(quint64 sessionId);
+    void closeSession(quint64 sessionId);
+    // 由会话所在的 I/O 线程写出，data 不能是 QByteArray::fromRawData
+    void write(quint64 sessionId, const QByteArray &data);
+
+    QList<quint64> sessionIds() const;
+    QString spec(quint64 sessionId) const;
+    State state(quint64 sessionId) const;
+    // 会话移除后失效
+    TrafficStats *trafficStats(quint64 sessionId) const;
+    int ioThreadCount() const { return m_threads.size(); }
+
+    // 共享时钟：自管理器创建起的纳秒数，可在任意线程调用
+    qint64 nowNs() const { return m_clock.nsecsElapsed(); }
+    // 把共享时钟的时间戳换算成墙上时间
+    QDateTime toDateTime(qint64 timestampNs) const { return m_epoch.addMSecs(timestampNs / 1000000); }
+
+signals:
+    void sessionAdded(quint64 sessionId);
+    void sessionRemoved(quint64 sessionId);
+    void stateChanged(quint64 sessionId, SessionManager::State state);
+    // 以下信号从 I/O 线程发出，连接到界面对象时自动排队
+    void messageReceived(quint64 sessionId, qint64 timestampNs, const QByteArray &message, const QString &peer);
+    void dataSent(quint64 sessionId, qint64 timestampNs, const QByteArray &data);
+    void errorOccurred(quint64 sessionId, qint64 timestampNs, const QString &errorText);
+
+private:
+    struct Session {
+        QString spec;
+        CliEndpoint *endpoint = nullptr;      // 属于 thread，只能在该线程中访问
+        QThread *thread = nullptr;
+        std::shared_ptr<TrafficStats> trafficStats;
+        State state = State::Closed;
+    };
+
+    QThread *leastLoadedThread() const;
+    // 在端点所在的 I/O 线程中关闭并析构，返回时端点已经不存在
+    static void destroyEndpoint(CliEndpoint *endpoint);
+    void setState(quint64 sessionId, State state);
+
+private:
+    QList<QThread *> m_threads;
+    QHash<quint64, Session> m_sessions;
+    quint64 m_nextSessionId;
+    QElapsedTimer m_clock;
+    QDateTime m_epoch;                         // m_clock 起点对应的墙上时间
+};
+
+#endif // SESSIONMANAGER_H
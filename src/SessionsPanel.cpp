@@ -0,0 +1,354 @@
+#include "SessionsPanel.h"
+#include "LogModel.h"
+#include "TrafficStats.h"
+#include "TrafficStatsPanel.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QListView>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <limits>
+
+namespace {
+constexpr int kRefreshIntervalMs = 1000;
+constexpr int kTimelineReorderMs = 50;     // 时间线的重排窗口，晚于此到达界面线程的事件不再插回原位
+
+enum Column { IdColumn, SpecColumn, StateColumn, RxColumn, TxColumn, MessagesColumn, ErrorsColumn, ColumnCount };
+}
+
+SessionsPanel::SessionsPanel(QWidget *parent)
+    : QWidget(parent)
+    , m_manager(nullptr)
+    , m_timelineModel(new LogModel(this))
+    , m_timelineFlushedNs(-1)
+    , m_timelineTimer(new QTimer(this))
+    , m_logMemoryBudget(0)
+    , m_refreshTimer(new QTimer(this))
+{
+    m_specLineEdit = new QLineEdit(this);
+    m_specLineEdit->setPlaceholderText("serial:<端口>[:<波特率>] | tcp:<主机>:<端口> | tcp-server:<端口> | udp:<本地端口>[:<主机>:<端口>]");
+    m_framerLineEdit = new QLineEdit("none", this);
+    m_framerLineEdit->setToolTip("分帧方式: none、idle[:<微秒>]、length[:<1|2|4>[be|le][+hdr]]、delim[:<分隔符>]、line、slip、cobs 或 fixed[:<字节数>]");
+    m_framerLineEdit->setMaximumWidth(160);
+    QPushButton *addButton = new QPushButton("添加会话", this);
+
+    QHBoxLayout *addLayout = new QHBoxLayout();
+    addLayout->addWidget(new QLabel("端点", this));
+    addLayout->addWidget(m_specLineEdit, 1);
+    addLayout->addWidget(new QLabel("分帧", this));
+    addLayout->addWidget(m_framerLineEdit);
+    addLayout->addWidget(addButton);
+
+    m_sessionTable = new QTableWidget(0, ColumnCount, this);
+    m_sessionTable->setHorizontalHeaderLabels({ "编号", "端点", "状态", "接收字节", "发送字节", "消息", "错误" });
+    m_sessionTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_sessionTable->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_sessionTable->setSelectionMode(QAbstractItemView::SingleSelection);
+    m_sessionTable->verticalHeader()->setVisible(false);
+    m_sessionTable->horizontalHeader()->setSectionResizeMode(SpecColumn, QHeaderView::Stretch);
+
+    m_openButton = new QPushButton("打开", this);
+    m_removeButton = new QPushButton("移除", this);
+    m_displayModeComboBox = new QComboBox(this);
+    m_displayModeComboBox->addItems({ "ASCII", "HEX", "十进制" });
+    m_timelineCheckBox = new QCheckBox("合并所有会话", this);
+    m_timelineCheckBox->setToolTip(QString("把所有会话的收发按共享时钟的时间戳排序后合并显示。"
+                                           "为等待其他 I/O 线程较晚送达的事件，显示会延后约 %1ms").arg(kTimelineReorderMs));
+
+    QHBoxLayout *sessionToolbar = new QHBoxLayout();
+    sessionToolbar->addWidget(m_openButton);
+    sessionToolbar->addWidget(m_removeButton);
+    sessionToolbar->addStretch(1);
+    sessionToolbar->addWidget(m_timelineCheckBox);
+    sessionToolbar->addWidget(m_displayModeComboBox);
+
+    m_logView = new QListView(this);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    QFont logFont("Consolas");
+    logFont.setStyleHint(QFont::Monospace);
+    m_logView->setFont(logFont);
+    m_statsPanel = new TrafficStatsPanel(this);
+
+    m_sendLineEdit = new QLineEdit(this);
+    m_sendLineEdit->setPlaceholderText("发送到选中的会话");
+    m_sendButton = new QPushButton("发送", this);
+    QHBoxLayout *sendLayout = new QHBoxLayout();
+    sendLayout->addWidget(m_sendLineEdit, 1);
+    sendLayout->addWidget(m_sendButton);
+
+    QWidget *logWidget = new QWidget(this);
+    QVBoxLayout *logLayout = new QVBoxLayout(logWidget);
+    logLayout->setContentsMargins(0, 0, 0, 0);
+    logLayout->addWidget(m_logView);
+    logLayout->addLayout(sendLayout);
+
+    QSplitter *detailSplitter = new QSplitter(Qt::Horizontal, this);
+    detailSplitter->addWidget(logWidget);
+    detailSplitter->addWidget(m_statsPanel);
+
+    QWidget *tableWidget = new QWidget(this);
+    QVBoxLayout *tableLayout = new QVBoxLayout(tableWidget);
+    tableLayout->setContentsMargins(0, 0, 0, 0);
+    tableLayout->addWidget(m_sessionTable);
+    tableLayout->addLayout(sessionToolbar);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(tableWidget);
+    splitter->addWidget(detailSplitter);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(addLayout);
+    layout->addWidget(splitter);
+
+    connect(addButton, &QPushButton::clicked, this, &SessionsPanel::addSession);
+    connect(m_specLineEdit, &QLineEdit::returnPressed, this, &SessionsPanel::addSession);
+    connect(m_openButton, &QPushButton::clicked, this, &SessionsPanel::toggleSelectedSession);
+    connect(m_removeButton, &QPushButton::clicked, this, &SessionsPanel::removeSelectedSession);
+    connect(m_sendButton, &QPushButton::clicked, this, &SessionsPanel::sendToSelectedSession);
+    connect(m_sendLineEdit, &QLineEdit::returnPressed, this, &SessionsPanel::sendToSelectedSession);
+    connect(m_sessionTable, &QTableWidget::itemSelectionChanged, this, &SessionsPanel::updateSelection);
+    connect(m_timelineCheckBox, &QCheckBox::toggled, this, &SessionsPanel::updateSelection);
+    connect(m_displayModeComboBox, &QComboBox::currentIndexChanged, this, &SessionsPanel::updateSelection);
+    connect(m_refreshTimer, &QTimer::timeout, this, &SessionsPanel::refreshCounters);
+    m_timelineTimer->setSingleShot(true);
+    m_timelineTimer->setInterval(kTimelineReorderMs);
+    connect(m_timelineTimer, &QTimer::timeout, this, &SessionsPanel::flushTimeline);
+
+    m_refreshTimer->start(kRefreshIntervalMs);
+    updateSelection();
+}
+
+void SessionsPanel::setSessionManager(SessionManager *manager) {
+    if (m_manager) {
+        disconnect(m_manager, nullptr, this, nullptr);
+    }
+    m_manager = manager;
+    if (!m_manager) {
+        setEnabled(false);
+        return;
+    }
+    setEnabled(true);
+    connect(m_manager, &SessionManager::sessionAdded, this, &SessionsPanel::onSessionAdded);
+    connect(m_manager, &SessionManager::sessionRemoved, this, &SessionsPanel::onSessionRemoved);
+    connect(m_manager, &SessionManager::stateChanged, this, &SessionsPanel::onStateChanged);
+    connect(m_manager, &SessionManager::messageReceived, this, &SessionsPanel::onMessageReceived);
+    connect(m_manager, &SessionManager::dataSent, this, &SessionsPanel::onDataSent);
+    connect(m_manager, &SessionManager::errorOccurred, this, &SessionsPanel::onErrorOccurred);
+    for (quint64 sessionId : m_manager->sessionIds()) {
+        onSessionAdded(sessionId);
+    }
+}
+
+void SessionsPanel::setLogMemoryBudget(qint64 bytes) {
+    m_logMemoryBudget = bytes;
+    applyLogMemoryBudget();
+}
+
+// 会话增减时重新分配：每个会话日志和时间线各得 1/(N+1)
+void SessionsPanel::applyLogMemoryBudget() {
+    const qint64 share = m_logMemoryBudget > 0 ? qMax<qint64>(1, m_logMemoryBudget / (m_views.size() + 1)) : 0;
+    m_timelineModel->setMemoryBudget(share);
+    for (const SessionView &view : m_views) {
+        view.log->setMemoryBudget(share);
+    }
+}
+
+void SessionsPanel::addSession() {
+    if (!m_manager) return;
+    const QString spec = m_specLineEdit->text().trimmed();
+    if (spec.isEmpty()) return;
+
+    QString error;
+    StreamFramer::Config framer;
+    if (!StreamFramer::parseSpec(m_framerLineEdit->text().trimmed(), &framer, &error)
+        || m_manager->addSession(spec, framer, &error) == 0) {
+        QMessageBox::warning(this, "添加会话", error);
+        return;
+    }
+    m_specLineEdit->clear();
+}
+
+void SessionsPanel::toggleSelectedSession() {
+    const quint64 sessionId = selectedSessionId();
+    if (!m_manager || sessionId == 0) return;
+    if (m_manager->state(sessionId) == SessionManager::State::Closed) {
+        m_manager->openSession(sessionId);
+    } else {
+        m_manager->closeSession(sessionId);
+    }
+}
+
+void SessionsPanel::removeSelectedSession() {
+    const quint64 sessionId = selectedSessionId();
+    if (!m_manager || sessionId == 0) return;
+    m_manager->removeSession(sessionId);
+}
+
+void SessionsPanel::sendToSelectedSession() {
+    const quint64 sessionId = selectedSessionId();
+    if (!m_manager || sessionId == 0 || m_sendLineEdit->text().isEmpty()) return;
+    m_manager->write(sessionId, m_sendLineEdit->text().toUtf8());
+}
+
+void SessionsPanel::onSessionAdded(quint64 sessionId) {
+    if (m_views.contains(sessionId)) return;
+    SessionView view;
+    view.log = new LogModel(this);
+    connect(view.log, &QAbstractItemModel::rowsInserted, this, [this, model = view.log]() {
+        if (m_logView->model() == model) m_logView->scrollToBottom();
+    });
+    m_views.insert(sessionId, view);
+    applyLogMemoryBudget();
+
+    const int row = m_sessionTable->rowCount();
+    m_sessionTable->insertRow(row);
+    QTableWidgetItem *idItem = new QTableWidgetItem(QString::number(sessionId));
+    idItem->setData(Qt::UserRole, sessionId);
+    m_sessionTable->setItem(row, IdColumn, idItem);
+    m_sessionTable->setItem(row, SpecColumn, new QTableWidgetItem(m_manager->spec(sessionId)));
+    m_sessionTable->setItem(row, StateColumn, new QTableWidgetItem(stateText(m_manager->state(sessionId))));
+    for (int column = RxColumn; column < ColumnCount; ++column) {
+        m_sessionTable->setItem(row, column, new QTableWidgetItem("0"));
+    }
+    m_sessionTable->selectRow(row);
+}
+
+void SessionsPanel::onSessionRemoved(quint64 sessionId) {
+    const int row = rowOf(sessionId);
+    const SessionView view = m_views.take(sessionId);
+    // 先解除统计面板和视图的引用，再移除行 (会触发 updateSelection)
+    if (m_logView->model() == view.log) m_logView->setModel(nullptr);
+    m_statsPanel->setTrafficStats(nullptr);
+    if (row >= 0) m_sessionTable->removeRow(row);
+    delete view.log;
+    applyLogMemoryBudget();
+    updateSelection();
+}
+
+void SessionsPanel::onStateChanged(quint64 sessionId, SessionManager::State state) {
+    const int row = rowOf(sessionId);
+    if (row < 0) return;
+    m_sessionTable->item(row, StateColumn)->setText(stateText(state));
+    if (sessionId == selectedSessionId()) updateSelection();
+}
+
+void SessionsPanel::onMessageReceived(quint64 sessionId, qint64 timestampNs, const QByteArray &message, const QString &peer) {
+    const auto it = m_views.find(sessionId);
+    if (it == m_views.end()) return; // 会话已移除，I/O 线程中还有在途的数据
+    ++it->messages;
+    appendLog(sessionId, timestampNs, true, message, peer);
+}
+
+void SessionsPanel::onDataSent(quint64 sessionId, qint64 timestampNs, const QByteArray &data) {
+    if (!m_views.contains(sessionId)) return;
+    appendLog(sessionId, timestampNs, false, data, m_manager->spec(sessionId));
+}
+
+void SessionsPanel::onErrorOccurred(quint64 sessionId, qint64 timestampNs, const QString &errorText) {
+    const auto it = m_views.find(sessionId);
+    if (it == m_views.end()) return;
+    ++it->errors;
+    appendLog(sessionId, timestampNs, true, errorText.toUtf8(), "错误");
+}
+
+void SessionsPanel::appendLog(quint64 sessionId, qint64 timestampNs, bool incoming, const QByteArray &data, const QString &peer) {
+    LogEntry entry;
+    entry.timestamp = m_manager->toDateTime(timestampNs);
+    entry.direction = incoming ? LogEntry::In : LogEntry::Out;
+    entry.rawData = data;
+    entry.sourceInfo = peer;
+    // 同一会话的事件都从它所在的 I/O 线程发出，到达顺序就是时间戳顺序
+    m_views.value(sessionId).log->appendEntry(entry);
+    entry.sourceInfo = QString("#%1 %2").arg(sessionId).arg(peer);
+    if (timestampNs <= m_timelineFlushedNs) {
+        // 比重排窗口还晚，前面的条目已经写入，只能追加在末尾
+        m_timelineModel->appendEntry(entry);
+        return;
+    }
+    m_timelinePending.insert(timestampNs, entry);
+    if (!m_timelineTimer->isActive()) m_timelineTimer->start();
+}
+
+// 把超过重排窗口的暂存事件按时间戳顺序写入时间线
+void SessionsPanel::flushTimeline() {
+    const qint64 cutoffNs = m_manager ? m_manager->nowNs() - qint64(kTimelineReorderMs) * 1000000 : std::numeric_limits<qint64>::max();
+    auto it = m_timelinePending.begin();
+    while (it != m_timelinePending.end() && it.key() <= cutoffNs) {
+        m_timelineModel->appendEntry(it.value());
+        m_timelineFlushedNs = it.key();
+        it = m_timelinePending.erase(it);
+    }
+    if (!m_timelinePending.isEmpty()) m_timelineTimer->start();
+}
+
+void SessionsPanel::refreshCounters() {
+    if (!m_manager || !isVisible()) return;
+    for (int row = 0; row < m_sessionTable->rowCount(); ++row) {
+        const quint64 sessionId = m_sessionTable->item(row, IdColumn)->data(Qt::UserRole).toULongLong();
+        TrafficStats *stats = m_manager->trafficStats(sessionId);
+        if (!stats) continue;
+        const TrafficStats::Snapshot snapshot = stats->snapshot();
+        const SessionView view = m_views.value(sessionId);
+        m_sessionTable->item(row, RxColumn)->setText(QString::number(snapshot.direction[TrafficStats::Rx].bytes));
+        m_sessionTable->item(row, TxColumn)->setText(QString::number(snapshot.direction[TrafficStats::Tx].bytes));
+        m_sessionTable->item(row, MessagesColumn)->setText(QString::number(view.messages));
+        m_sessionTable->item(row, ErrorsColumn)->setText(QString::number(view.errors));
+    }
+}
+
+void SessionsPanel::updateSelection() {
+    const quint64 sessionId = selectedSessionId();
+    const bool hasSession = m_manager && sessionId != 0;
+    const SessionManager::State state = hasSession ? m_manager->state(sessionId) : SessionManager::State::Closed;
+
+    m_openButton->setEnabled(hasSession);
+    m_openButton->setText(state == SessionManager::State::Closed ? "打开" : "关闭");
+    m_removeButton->setEnabled(hasSession);
+    m_sendButton->setEnabled(state == SessionManager::State::Open);
+    m_statsPanel->setTrafficStats(hasSession ? m_manager->trafficStats(sessionId) : nullptr);
+
+    LogModel *model = m_timelineCheckBox->isChecked() ? m_timelineModel
+                      : (hasSession ? m_views.value(sessionId).log : nullptr);
+    if (model) {
+        const int mode = m_displayModeComboBox->currentIndex();
+        model->setDisplayMode(mode == 1 ? LogModel::DisplayMode::Hex
+                              : (mode == 2 ? LogModel::DisplayMode::Decimal : LogModel::DisplayMode::Ascii));
+    }
+    if (m_logView->model() != model) {
+        m_logView->setModel(model);
+        m_logView->scrollToBottom();
+    }
+}
+
+quint64 SessionsPanel::selectedSessionId() const {
+    const QList<QTableWidgetItem *> items = m_sessionTable->selectedItems();
+    if (items.isEmpty()) return 0;
+    QTableWidgetItem *idItem = m_sessionTable->item(items.first()->row(), IdColumn);
+    return idItem ? idItem->data(Qt::UserRole).toULongLong() : 0;
+}
+
+int SessionsPanel::rowOf(quint64 sessionId) const {
+    for (int row = 0; row < m_sessionTable->rowCount(); ++row) {
+        const QTableWidgetItem *idItem = m_sessionTable->item(row, IdColumn);
+        if (idItem && idItem->data(Qt::UserRole).toULongLong() == sessionId) return row;
+    }
+    return -1;
+}
+
+QString SessionsPanel::stateText(SessionManager::State state) {
+    switch (state) {
+    case SessionManager::State::Opening: return "正在打开";
+    case SessionManager::State::Open: return "已打开";
+    case SessionManager::State::Closed: break;
+    }
+    return "已关闭";
+}
@@ -0,0 +1,86 @@
+#ifndef SESSIONSPANEL_H
+#define SESSIONSPANEL_H
+
+#include <QWidget>
+#include <QHash>
+#include <QMultiMap>
+#include "LogEntry.h"
+#include "SessionManager.h"
+
+class QCheckBox;
+class QComboBox;
+class QLineEdit;
+class QListView;
+class QPushButton;
+class QTableWidget;
+class QTimer;
+class LogModel;
+class TrafficStatsPanel;
+
+// 多会话面板：添加、打开、关闭会话，列出各会话的状态和流量，
+// 下方显示选中会话的日志和流量统计，或按共享时间戳合并的所有会话时间线
+class SessionsPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit SessionsPanel(QWidget *parent = nullptr);
+
+    // 为空时面板不可用
+    void setSessionManager(SessionManager *manager);
+    // 所有会话的日志和合并时间线共用这个预算，平均分给各个模型，0 表示不限制
+    void setLogMemoryBudget(qint64 bytes);
+
+private slots:
+    void addSession();
+    void toggleSelectedSession();
+    void removeSelectedSession();
+    void sendToSelectedSession();
+    void onSessionAdded(quint64 sessionId);
+    void onSessionRemoved(quint64 sessionId);
+    void onStateChanged(quint64 sessionId, SessionManager::State state);
+    void onMessageReceived(quint64 sessionId, qint64 timestampNs, const QByteArray &message, const QString &peer);
+    void onDataSent(quint64 sessionId, qint64 timestampNs, const QByteArray &data);
+    void onErrorOccurred(quint64 sessionId, qint64 timestampNs, const QString &errorText);
+    void refreshCounters();
+    void flushTimeline();
+    void updateSelection();
+
+private:
+    struct SessionView {
+        LogModel *log = nullptr;
+        quint64 messages = 0;
+        quint64 errors = 0;
+    };
+
+    quint64 selectedSessionId() const; // 未选中时返回 0
+    int rowOf(quint64 sessionId) const;
+    void appendLog(quint64 sessionId, qint64 timestampNs, bool incoming, const QByteArray &data, const QString &peer);
+    void applyLogMemoryBudget();
+    static QString stateText(SessionManager::State state);
+
+private:
+    SessionManager *m_manager;
+    QHash<quint64, SessionView> m_views;
+    LogModel *m_timelineModel;      // 所有会话按共享时钟的时间戳合并
+    // 不同 I/O 线程的事件到达界面线程的顺序与时间戳不一定一致：先按时间戳暂存，
+    // 超过重排窗口后再按顺序写入时间线
+    QMultiMap<qint64, LogEntry> m_timelinePending;
+    qint64 m_timelineFlushedNs;     // 已写入时间线的最新时间戳
+    QTimer *m_timelineTimer;
+    qint64 m_logMemoryBudget;       // 总预算
+
+    QLineEdit *m_specLineEdit;
+    QLineEdit *m_framerLineEdit;
+    QTableWidget *m_sessionTable;
+    QPushButton *m_openButton;
+    QPushButton *m_removeButton;
+    QComboBox *m_displayModeComboBox;
+    QCheckBox *m_timelineCheckBox;
+    QListView *m_logView;
+    TrafficStatsPanel *m_statsPanel;
+    QLineEdit *m_sendLineEdit;
+    QPushButton *m_sendButton;
+    QTimer *m_refreshTimer;
+};
+
+#endif // SESSIONSPANEL_H
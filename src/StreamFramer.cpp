@@ -0,0 +1,403 @@
+#include "StreamFramer.h"
+#include <cstring>
+
+namespace {
+
+// 不分帧：每次到达的数据就是一条消息
+class PassThroughFramer : public StreamFramer {
+public:
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        if (!data.isEmpty()) frames->append(data);
+    }
+};
+
+// 静默超过设定时间才算一条消息结束。下一批数据到达时如果已经超时，先交出上一条，
+// 否则由调用方在 deadlineNs() 到期后调用 poll()
+class IdleGapFramer : public StreamFramer {
+public:
+    explicit IdleGapFramer(const Config &config)
+        : m_gapNs(config.idleGapUs * 1000), m_maxFrameSize(config.maxFrameSize), m_lastNs(0) {}
+
+    void feed(const QByteArray &data, qint64 nowNs, QList<QByteArray> *frames) override {
+        if (data.isEmpty()) return;
+        if (!m_buffer.isEmpty() && nowNs - m_lastNs >= m_gapNs) takeBuffer(frames);
+        m_buffer.append(data);
+        m_lastNs = nowNs;
+        // 一直没有静默的流按最大长度切开，避免无限积攒
+        if (m_buffer.size() >= m_maxFrameSize) takeBuffer(frames);
+    }
+
+    qint64 deadlineNs() const override { return m_buffer.isEmpty() ? -1 : m_lastNs + m_gapNs; }
+
+    void poll(qint64 nowNs, QList<QByteArray> *frames) override {
+        if (!m_buffer.isEmpty() && nowNs - m_lastNs >= m_gapNs) takeBuffer(frames);
+    }
+
+private:
+    void takeBuffer(QList<QByteArray> *frames) {
+        frames->append(std::move(m_buffer));
+        m_buffer = QByteArray();
+    }
+
+    qint64 m_gapNs;
+    qsizetype m_maxFrameSize;
+    qint64 m_lastNs;
+};
+
+// 长度字段 + 负载。长度不合理时丢弃一个字节重新同步
+class LengthPrefixedFramer : public StreamFramer {
+public:
+    explicit LengthPrefixedFramer(const Config &config) : m_config(config) {}
+
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        m_buffer.append(data);
+        const qsizetype headerSize = m_config.lengthFieldSize;
+        const uchar *bytes = reinterpret_cast<const uchar *>(m_buffer.constData());
+        qsizetype pos = 0;
+        while (m_buffer.size() - pos >= headerSize) {
+            quint32 length = 0;
+            for (qsizetype i = 0; i < headerSize; ++i) {
+                const quint32 byte = bytes[pos + (m_config.lengthBigEndian ? i : headerSize - 1 - i)];
+                length = (length << 8) | byte;
+            }
+            const qint64 payload = m_config.lengthIncludesHeader ? qint64(length) - headerSize : qint64(length);
+            if (payload < 0 || payload > m_config.maxFrameSize) {
+                ++pos;
+                ++m_discardedBytes;
+                continue;
+            }
+            if (m_buffer.size() - pos - headerSize < payload) break;
+            frames->append(m_buffer.mid(pos + headerSize, payload));
+            pos += headerSize + payload;
+        }
+        if (pos > 0) m_buffer.remove(0, pos);
+    }
+
+private:
+    Config m_config;
+};
+
+// 以分隔符结尾的消息。已经找过的部分不再重复查找，长消息分多次到达时总开销仍是线性的
+class DelimiterFramer : public StreamFramer {
+public:
+    explicit DelimiterFramer(const Config &config)
+        : m_delimiter(config.delimiter), m_maxFrameSize(config.maxFrameSize), m_scanned(0) {}
+
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        m_buffer.append(data);
+        qsizetype start = 0;
+        qsizetype from = qMax<qsizetype>(0, m_scanned - (m_delimiter.size() - 1));
+        for (;;) {
+            const qsizetype index = m_buffer.indexOf(m_delimiter, from);
+            if (index < 0) break;
+            if (index > start) frames->append(m_buffer.mid(start, index - start));
+            start = index + m_delimiter.size();
+            from = start;
+        }
+        if (start > 0) m_buffer.remove(0, start);
+        m_scanned = m_buffer.size();
+        if (m_buffer.size() > m_maxFrameSize) {
+            m_discardedBytes += m_buffer.size();
+            reset();
+        }
+    }
+
+    void reset() override {
+        StreamFramer::reset();
+        m_scanned = 0;
+    }
+
+private:
+    QByteArray m_delimiter;
+    qsizetype m_maxFrameSize;
+    qsizetype m_scanned; // m_buffer 中已经找过分隔符的长度
+};
+
+// SLIP (RFC 1055)：0xC0 结束，0xDB 0xDC / 0xDB 0xDD 转义。边收边解码，m_buffer 中是已解码的数据
+class SlipFramer : public StreamFramer {
+public:
+    explicit SlipFramer(const Config &config)
+        : m_maxFrameSize(config.maxFrameSize), m_escape(false), m_overflow(false) {}
+
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        const char *bytes = data.constData();
+        const qsizetype size = data.size();
+        qsizetype runStart = 0; // 不含特殊字节的连续片段整段追加
+        for (qsizetype i = 0; i < size; ++i) {
+            const uchar byte = static_cast<uchar>(bytes[i]);
+            if (!m_escape && byte != kEnd && byte != kEsc) continue;
+            append(bytes + runStart, i - runStart);
+            runStart = i + 1;
+            if (m_escape) {
+                m_escape = false;
+                const char decoded = byte == kEscEnd ? char(kEnd) : byte == kEscEsc ? char(kEsc) : char(byte);
+                append(&decoded, 1);
+            } else if (byte == kEsc) {
+                m_escape = true;
+            } else {
+                endFrame(frames);
+            }
+        }
+        append(bytes + runStart, size - runStart);
+    }
+
+    void flush(QList<QByteArray> *frames) override {
+        endFrame(frames);
+    }
+
+    void reset() override {
+        StreamFramer::reset();
+        m_escape = false;
+        m_overflow = false;
+    }
+
+private:
+    static constexpr uchar kEnd = 0xC0;
+    static constexpr uchar kEsc = 0xDB;
+    static constexpr uchar kEscEnd = 0xDC;
+    static constexpr uchar kEscEsc = 0xDD;
+
+    void append(const char *data, qsizetype length) {
+        if (length <= 0) return;
+        if (m_overflow || m_buffer.size() + length > m_maxFrameSize) {
+            // 超长的帧整条丢弃，直到下一个 END
+            m_discardedBytes += m_buffer.size() + length;
+            m_buffer.clear();
+            m_overflow = true;
+            return;
+        }
+        m_buffer.append(data, length);
+    }
+
+    void endFrame(QList<QByteArray> *frames) {
+        // 连续的 END (帧间填充) 不产生空消息
+        if (!m_buffer.isEmpty() && !m_overflow) frames->append(m_buffer);
+        m_buffer.clear();
+        m_escape = false;
+        m_overflow = false;
+    }
+
+    qsizetype m_maxFrameSize;
+    bool m_escape;
+    bool m_overflow;
+};
+
+// COBS：帧以 0x00 结尾，帧内不含 0x00。收齐一帧后一次解码，解码失败的帧丢弃
+class CobsFramer : public StreamFramer {
+public:
+    explicit CobsFramer(const Config &config) : m_maxFrameSize(config.maxFrameSize), m_overflow(false) {}
+
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        const char *bytes = data.constData();
+        const qsizetype size = data.size();
+        qsizetype start = 0;
+        while (start < size) {
+            const void *zero = std::memchr(bytes + start, 0, size - start);
+            const qsizetype end = zero ? static_cast<const char *>(zero) - bytes : size;
+            append(bytes + start, end - start);
+            if (!zero) break;
+            endFrame(frames);
+            start = end + 1;
+        }
+    }
+
+    void flush(QList<QByteArray> *frames) override {
+        endFrame(frames);
+    }
+
+    void reset() override {
+        StreamFramer::reset();
+        m_overflow = false;
+    }
+
+private:
+    void append(const char *data, qsizetype length) {
+        if (length <= 0) return;
+        if (m_overflow || m_buffer.size() + length > m_maxFrameSize) {
+            m_discardedBytes += m_buffer.size() + length;
+            m_buffer.clear();
+            m_overflow = true;
+            return;
+        }
+        m_buffer.append(data, length);
+    }
+
+    void endFrame(QList<QByteArray> *frames) {
+        if (!m_buffer.isEmpty() && !m_overflow) {
+            QByteArray decoded;
+            if (decode(m_buffer, &decoded)) {
+                frames->append(decoded);
+            } else {
+                m_discardedBytes += m_buffer.size();
+            }
+        }
+        m_buffer.clear();
+        m_overflow = false;
+    }
+
+    static bool decode(const QByteArray &encoded, QByteArray *decoded) {
+        const uchar *bytes = reinterpret_cast<const uchar *>(encoded.constData());
+        const qsizetype size = encoded.size();
+        decoded->resize(size);
+        char *out = decoded->data();
+        qsizetype written = 0;
+        qsizetype pos = 0;
+        while (pos < size) {
+            const uchar code = bytes[pos++];
+            if (code == 0 || pos + code - 1 > size) return false;
+            std::memcpy(out + written, bytes + pos, code - 1);
+            written += code - 1;
+            pos += code - 1;
+            if (code != 0xFF && pos < size) out[written++] = 0;
+        }
+        decoded->truncate(written);
+        return true;
+    }
+
+    qsizetype m_maxFrameSize;
+    bool m_overflow;
+};
+
+class FixedSizeFramer : public StreamFramer {
+public:
+    explicit FixedSizeFramer(const Config &config) : m_frameSize(config.fixedSize) {}
+
+    void feed(const QByteArray &data, qint64, QList<QByteArray> *frames) override {
+        m_buffer.append(data);
+        qsizetype pos = 0;
+        while (m_buffer.size() - pos >= m_frameSize) {
+            frames->append(m_buffer.mid(pos, m_frameSize));
+            pos += m_frameSize;
+        }
+        if (pos > 0) m_buffer.remove(0, pos);
+    }
+
+private:
+    qsizetype m_frameSize;
+};
+
+bool parseDelimiter(const QString &text, QByteArray *delimiter) {
+    const QByteArray raw = text.toUtf8();
+    QByteArray result;
+    for (qsizetype i = 0; i < raw.size(); ++i) {
+        if (raw.at(i) != '\\' || i + 1 >= raw.size()) {
+            result.append(raw.at(i));
+            continue;
+        }
+        const char escape = raw.at(++i);
+        switch (escape) {
+        case 'r': result.append('\r'); break;
+        case 'n': result.append('\n'); break;
+        case 't': result.append('\t'); break;
+        case '0': result.append('\0'); break;
+        case '\\': result.append('\\'); break;
+        case 'x': {
+            bool ok = false;
+            const int value = raw.mid(i + 1, 2).toInt(&ok, 16);
+            if (!ok || i + 2 >= raw.size()) return false;
+            result.append(static_cast<char>(value));
+            i += 2;
+            break;
+        }
+        default:
+            return false;
+        }
+    }
+    if (result.isEmpty()) return false;
+    *delimiter = result;
+    return true;
+}
+
+}
+
+std::unique_ptr<StreamFramer> StreamFramer::create(const Config &config) {
+    switch (config.type) {
+    case Type::IdleGap: return std::make_unique<IdleGapFramer>(config);
+    case Type::LengthPrefixed: return std::make_unique<LengthPrefixedFramer>(config);
+    case Type::Delimiter: return std::make_unique<DelimiterFramer>(config);
+    case Type::Slip: return std::make_unique<SlipFramer>(config);
+    case Type::Cobs: return std::make_unique<CobsFramer>(config);
+    case Type::FixedSize: return std::make_unique<FixedSizeFramer>(config);
+    case Type::None: break;
+    }
+    return std::make_unique<PassThroughFramer>();
+}
+
+bool StreamFramer::parseSpec(const QString &spec, Config *config, QString *error) {
+    const QString trimmed = spec.trimmed();
+    const int colon = trimmed.indexOf(QLatin1Char(':'));
+    const QString name = (colon < 0 ? trimmed : trimmed.left(colon)).toLower();
+    const QString argument = colon < 0 ? QString() : trimmed.mid(colon + 1);
+    Config result;
+
+    if (name.isEmpty() || name == "none") {
+        result.type = Type::None;
+    } else if (name == "idle") {
+        result.type = Type::IdleGap;
+        if (!argument.isEmpty()) {
+            bool ok = false;
+            result.idleGapUs = argument.toLongLong(&ok);
+            if (!ok || result.idleGapUs <= 0) {
+                *error = QString("无效的空闲间隔: %1 (单位为微秒)").arg(argument);
+                return false;
+            }
+        }
+    } else if (name == "length") {
+        result.type = Type::LengthPrefixed;
+        QString rest = argument.toLower();
+        if (rest.endsWith("+hdr")) {
+            result.lengthIncludesHeader = true;
+            rest.chop(4);
+        }
+        if (rest.endsWith("le")) {
+            result.lengthBigEndian = false;
+            rest.chop(2);
+        } else if (rest.endsWith("be")) {
+            rest.chop(2);
+        }
+        if (!rest.isEmpty()) result.lengthFieldSize = rest.toInt();
+        if (result.lengthFieldSize != 1 && result.lengthFieldSize != 2 && result.lengthFieldSize != 4) {
+            *error = QString("无效的长度字段: %1，应为 1、2 或 4 字节，例如 length:2be").arg(argument);
+            return false;
+        }
+    } else if (name == "delim") {
+        result.type = Type::Delimiter;
+        if (!argument.isEmpty() && !parseDelimiter(argument, &result.delimiter)) {
+            *error = QString("无效的分隔符: %1").arg(argument);
+            return false;
+        }
+    } else if (name == "line") {
+        result.type = Type::Delimiter;
+        result.delimiter = "\n";
+    } else if (name == "slip") {
+        result.type = Type::Slip;
+    } else if (name == "cobs") {
+        result.type = Type::Cobs;
+    } else if (name == "fixed") {
+        result.type = Type::FixedSize;
+        bool ok = true;
+        if (!argument.isEmpty()) result.fixedSize = argument.toInt(&ok);
+        if (!ok || result.fixedSize <= 0 || result.fixedSize > result.maxFrameSize) {
+            *error = QString("无效的固定长度: %1").arg(argument);
+            return false;
+        }
+    } else {
+        *error = QString("未知的分帧方式: %1").arg(name);
+        return false;
+    }
+
+    *config = result;
+    return true;
+}
+
+void StreamFramer::poll(qint64, QList<QByteArray> *) {
+}
+
+void StreamFramer::flush(QList<QByteArray> *frames) {
+    if (!m_buffer.isEmpty()) frames->append(m_buffer);
+    reset();
+}
+
+void StreamFramer::reset() {
+    m_buffer.clear();
+}
@@ -0,0 +1,56 @@
+#ifndef STREAMFRAMER_H
+#define STREAMFRAMER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <memory>
+
+// 把字节流 (串口、TCP) 切分成消息的增量分帧器。每次 feed 送入新到达的数据，
+// 除空闲间隔方式外，消息的最后一个字节一到就立即交出，不需要等待超时。
+// 每条字节流 (一个串口、一个 TCP 连接) 各用一个实例。
+// 时间由调用方传入 (纳秒，单调递增)，本身不读时钟，也不是线程安全的。
+class StreamFramer {
+public:
+    enum class Type { None, IdleGap, LengthPrefixed, Delimiter, Slip, Cobs, FixedSize };
+
+    struct Config {
+        Type type = Type::None;
+        qint64 idleGapUs = 200000;          // IdleGap：静默这么久算一条消息结束
+        int lengthFieldSize = 2;            // LengthPrefixed：长度字段 1、2 或 4 字节
+        bool lengthBigEndian = true;
+        bool lengthIncludesHeader = false;  // 长度值是否包含长度字段本身
+        QByteArray delimiter = "\n";        // Delimiter：消息结尾，交出的消息不含分隔符
+        int fixedSize = 64;                 // FixedSize
+        int maxFrameSize = 16 * 1024 * 1024; // 超过即丢弃，防止错误的长度字段或丢失的分隔符吃光内存
+    };
+
+    virtual ~StreamFramer() = default;
+
+    static std::unique_ptr<StreamFramer> create(const Config &config);
+    // 解析文本描述，失败时返回 false 并填写 error：
+    //   none | idle[:<微秒>] | length[:<1|2|4>[be|le][+hdr]] | delim[:<分隔符>] | line | slip | cobs | fixed[:<字节数>]
+    // 省略参数时使用 Config 的默认值；分隔符支持 \r \n \t \0 \\ \xHH 转义
+    static bool parseSpec(const QString &spec, Config *config, QString *error);
+
+    // 送入新到达的数据，完整的消息按顺序追加到 frames
+    virtual void feed(const QByteArray &data, qint64 nowNs, QList<QByteArray> *frames) = 0;
+    // 只有空闲间隔方式使用：未交出的数据在这个时刻成为完整消息，-1 表示没有待定的数据
+    virtual qint64 deadlineNs() const { return -1; }
+    // 到达 deadlineNs() 之后调用，交出到期的消息
+    virtual void poll(qint64 nowNs, QList<QByteArray> *frames);
+    // 流结束 (断开) 时把残留的不完整数据作为最后一条消息交出
+    virtual void flush(QList<QByteArray> *frames);
+    virtual void reset();
+
+    // 因格式错误或超长而丢弃的字节数
+    quint64 discardedBytes() const { return m_discardedBytes; }
+
+protected:
+    StreamFramer() : m_discardedBytes(0) {}
+
+    QByteArray m_buffer;      // 尚未组成完整消息的数据
+    quint64 m_discardedBytes;
+};
+
+#endif // STREAMFRAMER_H
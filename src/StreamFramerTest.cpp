@@ -0,0 +1,288 @@
+// StreamFramer 的行为测试：每种分帧方式分别整段送入、逐字节送入、以及在每个位置切成两段送入，
+// 结果都必须相同；另外覆盖 SLIP / COBS 的转义、超长和乱码后的重新同步，以及空闲间隔的到期路径。
+#include "StreamFramer.h"
+#include <QTest>
+
+namespace {
+constexpr qint64 kNsPerUs = 1000;
+
+std::unique_ptr<StreamFramer> framerFor(const QString &spec, int maxFrameSize = 0) {
+    StreamFramer::Config config;
+    QString error;
+    if (!StreamFramer::parseSpec(spec, &config, &error)) return nullptr;
+    if (maxFrameSize > 0) config.maxFrameSize = maxFrameSize;
+    return StreamFramer::create(config);
+}
+
+// 按 chunkSize 切块送入，最后 flush (flush 为 false 时只送入)
+QList<QByteArray> feedInChunks(const QString &spec, const QByteArray &stream, qsizetype chunkSize, bool flush = false) {
+    std::unique_ptr<StreamFramer> framer = framerFor(spec);
+    QList<QByteArray> frames;
+    for (qsizetype pos = 0; pos < stream.size(); pos += chunkSize) {
+        framer->feed(stream.mid(pos, chunkSize), 0, &frames);
+    }
+    if (flush) framer->flush(&frames);
+    return frames;
+}
+
+QList<QByteArray> feedSplitAt(const QString &spec, const QByteArray &stream, qsizetype split) {
+    std::unique_ptr<StreamFramer> framer = framerFor(spec);
+    QList<QByteArray> frames;
+    framer->feed(stream.left(split), 0, &frames);
+    framer->feed(stream.mid(split), 0, &frames);
+    return frames;
+}
+
+// 整段、逐字节、每个切分点送入的结果都应等于 expected
+void verifyAllSplits(const QString &spec, const QByteArray &stream, const QList<QByteArray> &expected) {
+    QCOMPARE(feedInChunks(spec, stream, stream.size()), expected);
+    QCOMPARE(feedInChunks(spec, stream, 1), expected);
+    for (qsizetype split = 1; split < stream.size(); ++split) {
+        QVERIFY2(feedSplitAt(spec, stream, split) == expected, qPrintable(QString("%1 split=%2").arg(spec).arg(split)));
+    }
+}
+
+QByteArray encodeLengthPrefixed(const QByteArray &payload, int fieldSize, bool bigEndian, bool includesHeader) {
+    const quint32 length = static_cast<quint32>(payload.size() + (includesHeader ? fieldSize : 0));
+    QByteArray frame;
+    for (int i = 0; i < fieldSize; ++i) {
+        const int shift = 8 * (bigEndian ? fieldSize - 1 - i : i);
+        frame.append(static_cast<char>((length >> shift) & 0xFF));
+    }
+    return frame + payload;
+}
+
+QByteArray slipEncode(const QByteArray &payload) {
+    QByteArray encoded;
+    encoded.append(char(0xC0)); // 帧前的 END 冲掉线路噪声，不应产生空消息
+    for (char byte : payload) {
+        if (byte == char(0xC0)) {
+            encoded.append(char(0xDB)).append(char(0xDC));
+        } else if (byte == char(0xDB)) {
+            encoded.append(char(0xDB)).append(char(0xDD));
+        } else {
+            encoded.append(byte);
+        }
+    }
+    encoded.append(char(0xC0));
+    return encoded;
+}
+
+// 参考 COBS 编码，结果后面带 0x00 帧尾
+QByteArray cobsEncode(const QByteArray &payload) {
+    QByteArray encoded(1, '\0');
+    qsizetype codePos = 0;
+    uchar code = 1;
+    for (char byte : payload) {
+        if (byte != '\0') {
+            encoded.append(byte);
+            ++code;
+        }
+        if (byte == '\0' || code == 0xFF) {
+            encoded[codePos] = static_cast<char>(code);
+            codePos = encoded.size();
+            encoded.append('\0');
+            code = 1;
+        }
+    }
+    encoded[codePos] = static_cast<char>(code);
+    encoded.append('\0');
+    return encoded;
+}
+
+QByteArray nonZeroBytes(int count, int seed) {
+    QByteArray bytes;
+    for (int i = 0; i < count; ++i) {
+        bytes.append(static_cast<char>(1 + (i * 7 + seed) % 255));
+    }
+    return bytes;
+}
+}
+
+class StreamFramerTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void parseSpec();
+    void passThrough();
+    void lengthPrefixed();
+    void lengthPrefixedResync();
+    void delimiter();
+    void delimiterOversize();
+    void slipEscapes();
+    void slipOversizeResync();
+    void cobsGroups();
+    void cobsGarbageResync();
+    void fixedSize();
+    void idleGapDeadline();
+    void idleGapMaxFrameSize();
+};
+
+void StreamFramerTest::parseSpec() {
+    StreamFramer::Config config;
+    QString error;
+    QVERIFY(StreamFramer::parseSpec("length:4le+hdr", &config, &error));
+    QVERIFY(config.type == StreamFramer::Type::LengthPrefixed);
+    QCOMPARE(config.lengthFieldSize, 4);
+    QVERIFY(!config.lengthBigEndian);
+    QVERIFY(config.lengthIncludesHeader);
+
+    QVERIFY(StreamFramer::parseSpec("delim:\\r\\n", &config, &error));
+    QCOMPARE(config.delimiter, QByteArray("\r\n"));
+    QVERIFY(StreamFramer::parseSpec("delim:\\x7E", &config, &error));
+    QCOMPARE(config.delimiter, QByteArray("\x7E"));
+    QVERIFY(StreamFramer::parseSpec("idle:1500", &config, &error));
+    QCOMPARE(config.idleGapUs, qint64(1500));
+
+    QVERIFY(!StreamFramer::parseSpec("length:3", &config, &error));
+    QVERIFY(!StreamFramer::parseSpec("idle:0", &config, &error));
+    QVERIFY(!StreamFramer::parseSpec("fixed:-1", &config, &error));
+    QVERIFY(!StreamFramer::parseSpec("delim:\\q", &config, &error));
+    QVERIFY(!StreamFramer::parseSpec("bogus", &config, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void StreamFramerTest::passThrough() {
+    QCOMPARE(feedInChunks("none", "abcdef", 4), QList<QByteArray>({ "abcd", "ef" }));
+}
+
+void StreamFramerTest::lengthPrefixed() {
+    const QList<QByteArray> payloads = { "hello", QByteArray(1, '\0'), nonZeroBytes(300, 1), "x" };
+    struct Variant { const char *spec; int fieldSize; bool bigEndian; bool includesHeader; };
+    const Variant variants[] = {
+        { "length:1", 1, true, false }, { "length:2be", 2, true, false },
+        { "length:2le", 2, false, false }, { "length:4be+hdr", 4, true, true }, { "length:4le+hdr", 4, false, true },
+    };
+    for (const Variant &variant : variants) {
+        QByteArray stream;
+        QList<QByteArray> expected;
+        for (const QByteArray &payload : payloads) {
+            if (variant.fieldSize == 1 && payload.size() > 255) continue;
+            stream += encodeLengthPrefixed(payload, variant.fieldSize, variant.bigEndian, variant.includesHeader);
+            expected.append(payload);
+        }
+        verifyAllSplits(variant.spec, stream, expected);
+    }
+}
+
+void StreamFramerTest::lengthPrefixedResync() {
+    // 0xFFFF 和 0xFF00 都超过上限，逐字节丢弃后在 00 02 处重新对齐
+    const QByteArray stream = QByteArray("\xFF\xFF", 2) + encodeLengthPrefixed("ok", 2, true, false);
+    std::unique_ptr<StreamFramer> framer = framerFor("length:2be", 16);
+    QList<QByteArray> frames;
+    for (char byte : stream) {
+        framer->feed(QByteArray(1, byte), 0, &frames);
+    }
+    QCOMPARE(frames, QList<QByteArray>({ "ok" }));
+    QCOMPARE(framer->discardedBytes(), quint64(2));
+}
+
+void StreamFramerTest::delimiter() {
+    // 多字节分隔符被切在两次送入之间；连续的分隔符不产生空消息
+    verifyAllSplits("delim:\\r\\n", "ab\r\ncd\r\n\r\nlong line\r\n", { "ab", "cd", "long line" });
+    verifyAllSplits("line", "one\ntwo\n", { "one", "two" });
+    // 没有分隔符结尾的残留在 flush 时交出
+    QCOMPARE(feedInChunks("line", "a\nrest", 1, true), QList<QByteArray>({ "a", "rest" }));
+}
+
+void StreamFramerTest::delimiterOversize() {
+    std::unique_ptr<StreamFramer> framer = framerFor("line", 8);
+    QList<QByteArray> frames;
+    framer->feed("0123456789ABCDEF", 0, &frames);
+    QVERIFY(frames.isEmpty());
+    QCOMPARE(framer->discardedBytes(), quint64(16));
+    framer->feed("ok\n", 0, &frames);
+    QCOMPARE(frames, QList<QByteArray>({ "ok" }));
+}
+
+void StreamFramerTest::slipEscapes() {
+    const QByteArray special("\xC0\xDB\xDC\xDD", 4);
+    const QList<QByteArray> payloads = { "plain", special, QByteArray("a\xC0", 2), QByteArray("\xDB", 1), QByteArray("\xDB\xDC", 2) };
+    QByteArray stream;
+    for (const QByteArray &payload : payloads) {
+        stream += slipEncode(payload);
+    }
+    // DB DC 被切在两次送入之间时，转义状态必须跨调用保持
+    verifyAllSplits("slip", stream, payloads);
+}
+
+void StreamFramerTest::slipOversizeResync() {
+    const QByteArray stream = slipEncode("0123456789") + slipEncode("ok");
+    std::unique_ptr<StreamFramer> framer = framerFor("slip", 4);
+    QList<QByteArray> frames;
+    for (char byte : stream) {
+        framer->feed(QByteArray(1, byte), 0, &frames);
+    }
+    QCOMPARE(frames, QList<QByteArray>({ "ok" }));
+    QCOMPARE(framer->discardedBytes(), quint64(10));
+}
+
+void StreamFramerTest::cobsGroups() {
+    // 254 个非零字节正好填满一个 0xFF 组；更长的数据跨越 0xFF 组边界
+    const QList<QByteArray> payloads = {
+        QByteArray("a\0b\0\0c", 6), QByteArray(1, '\0'), nonZeroBytes(254, 2),
+        nonZeroBytes(254, 3) + QByteArray(1, '\0'), nonZeroBytes(300, 4), nonZeroBytes(600, 5) + QByteArray("\0z", 2),
+    };
+    QByteArray stream;
+    for (const QByteArray &payload : payloads) {
+        stream += cobsEncode(payload);
+    }
+    verifyAllSplits("cobs", stream, payloads);
+}
+
+void StreamFramerTest::cobsGarbageResync() {
+    std::unique_ptr<StreamFramer> framer = framerFor("cobs", 16);
+    QList<QByteArray> frames;
+    // 组长 5 超出帧尾：解码失败整帧丢弃；超长帧也丢弃到下一个 0x00
+    framer->feed(QByteArray("\x05" "ab\0", 4), 0, &frames);
+    framer->feed(nonZeroBytes(40, 6) + QByteArray(1, '\0'), 0, &frames);
+    framer->feed(cobsEncode(QByteArray("o\0k", 3)), 0, &frames);
+    QCOMPARE(frames, QList<QByteArray>({ QByteArray("o\0k", 3) }));
+    QCOMPARE(framer->discardedBytes(), quint64(3 + 40));
+}
+
+void StreamFramerTest::fixedSize() {
+    verifyAllSplits("fixed:3", "abcdefghi", { "abc", "def", "ghi" });
+    QCOMPARE(feedInChunks("fixed:3", "abcdefghij", 4, true), QList<QByteArray>({ "abc", "def", "ghi", "j" }));
+}
+
+void StreamFramerTest::idleGapDeadline() {
+    std::unique_ptr<StreamFramer> framer = framerFor("idle:1000");
+    const qint64 gapNs = 1000 * kNsPerUs;
+    QList<QByteArray> frames;
+    QCOMPARE(framer->deadlineNs(), qint64(-1));
+
+    framer->feed("ab", 0, &frames);
+    QCOMPARE(framer->deadlineNs(), gapNs);
+    // 间隔内的新数据延长期限
+    framer->feed("cd", gapNs / 2, &frames);
+    QCOMPARE(framer->deadlineNs(), gapNs / 2 + gapNs);
+    framer->poll(gapNs / 2 + gapNs - 1, &frames);
+    QVERIFY(frames.isEmpty());
+    framer->poll(gapNs / 2 + gapNs, &frames);
+    QCOMPARE(frames, QList<QByteArray>({ "abcd" }));
+    QCOMPARE(framer->deadlineNs(), qint64(-1));
+
+    // 调用方没来得及 poll 时，超时后到达的数据先把上一条交出
+    frames.clear();
+    framer->feed("ef", 10 * gapNs, &frames);
+    framer->feed("gh", 12 * gapNs, &frames);
+    QCOMPARE(frames, QList<QByteArray>({ "ef" }));
+    framer->flush(&frames);
+    QCOMPARE(frames, QList<QByteArray>({ "ef", "gh" }));
+    QCOMPARE(framer->deadlineNs(), qint64(-1));
+}
+
+void StreamFramerTest::idleGapMaxFrameSize() {
+    // 从不静默的流按最大长度切开
+    std::unique_ptr<StreamFramer> framer = framerFor("idle:1000", 4);
+    QList<QByteArray> frames;
+    framer->feed("abc", 0, &frames);
+    QVERIFY(frames.isEmpty());
+    framer->feed("def", 1, &frames);
+    QCOMPARE(frames, QList<QByteArray>({ "abcdef" }));
+    QCOMPARE(framer->deadlineNs(), qint64(-1));
+}
+
+QTEST_APPLESS_MAIN(StreamFramerTest)
+#include "StreamFramerTest.moc"
@@ -0,0 +1,79 @@
+#include "TcpClientListModel.h"
+#include <algorithm>
+
+TcpClientListModel::TcpClientListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int TcpClientListModel::rowCount(const QModelIndex &parent) const {
+    if (parent.isValid()) return 0;
+    return static_cast<int>(m_ids.size());
+}
+
+QVariant TcpClientListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= m_ids.size()) return QVariant();
+    const quint64 clientId = m_ids.at(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (m_sendStates.value(clientId, SendIdle)) {
+        case SendPending: return m_infos.value(clientId) + "  [发送中]";
+        case SendDone: return m_infos.value(clientId) + "  [已发送]";
+        case SendFailed: return m_infos.value(clientId) + "  [发送失败]";
+        default: return m_infos.value(clientId);
+        }
+    case ClientIdRole:
+        return clientId;
+    default:
+        return QVariant();
+    }
+}
+
+int TcpClientListModel::rowOf(quint64 clientId) const {
+    const auto it = std::lower_bound(m_ids.cbegin(), m_ids.cend(), clientId);
+    return (it != m_ids.cend() && *it == clientId) ? static_cast<int>(it - m_ids.cbegin()) : -1;
+}
+
+void TcpClientListModel::addClient(quint64 clientId, const QString &clientInfo) {
+    if (m_infos.contains(clientId)) return;
+    // 多个 I/O 线程的连接事件可能稍微乱序到达，按句柄找插入位置
+    const int row = static_cast<int>(std::upper_bound(m_ids.cbegin(), m_ids.cend(), clientId) - m_ids.cbegin());
+    beginInsertRows(QModelIndex(), row, row);
+    m_ids.insert(row, clientId);
+    m_infos.insert(clientId, clientInfo);
+    endInsertRows();
+}
+
+void TcpClientListModel::removeClient(quint64 clientId) {
+    const int row = rowOf(clientId);
+    if (row < 0) return;
+    beginRemoveRows(QModelIndex(), row, row);
+    m_ids.remove(row);
+    m_infos.remove(clientId);
+    m_sendStates.remove(clientId);
+    endRemoveRows();
+}
+
+void TcpClientListModel::clear() {
+    beginResetModel();
+    m_ids.clear();
+    m_infos.clear();
+    m_sendStates.clear();
+    endResetModel();
+}
+
+void TcpClientListModel::setSendState(quint64 clientId, SendState state) {
+    const int row = rowOf(clientId);
+    if (row < 0 || m_sendStates.value(clientId, SendIdle) == state) return;
+    if (state == SendIdle) {
+        m_sendStates.remove(clientId);
+    } else {
+        m_sendStates.insert(clientId, state);
+    }
+    const QModelIndex changed = index(row);
+    emit dataChanged(changed, changed, { Qt::DisplayRole });
+}
+
+quint64 TcpClientListModel::clientIdAt(int row) const {
+    return (row >= 0 && row < m_ids.size()) ? m_ids.at(row) : 0;
+}
@@ -0,0 +1,43 @@
+#ifndef TCPCLIENTLISTMODEL_H
+#define TCPCLIENTLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QVector>
+
+// TCP 服务器客户端列表的数据模型，按客户端句柄 (ITcpServerManager 的 clientId) 索引。
+// 句柄 -> 地址用哈希表，收包路径只用到这一项，开销与客户端数量无关；
+// 行按句柄升序排列，句柄单调递增，新客户端几乎总是追加在末尾，句柄 -> 行用二分查找
+class TcpClientListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    enum Role { ClientIdRole = Qt::UserRole + 1 };
+    // 最近一次群发在该客户端上的状态，显示在地址后面
+    enum SendState { SendIdle, SendPending, SendDone, SendFailed };
+
+    explicit TcpClientListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void addClient(quint64 clientId, const QString &clientInfo);
+    void removeClient(quint64 clientId);
+    void clear();
+
+    // 行无效时返回 0 (有效句柄从 1 开始)
+    quint64 clientIdAt(int row) const;
+    // 客户端不存在时返回空字符串
+    QString clientInfo(quint64 clientId) const { return m_infos.value(clientId); }
+    void setSendState(quint64 clientId, SendState state);
+
+private:
+    int rowOf(quint64 clientId) const;
+
+private:
+    QVector<quint64> m_ids;              // 按行排列，升序
+    QHash<quint64, QString> m_infos;
+    QHash<quint64, SendState> m_sendStates; // 只保存非 SendIdle 的客户端
+};
+
+#endif // TCPCLIENTLISTMODEL_H
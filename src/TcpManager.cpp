@@ -1,11 +1,13 @@
 #include "TcpManager.h"
+#include "TrafficStats.h"
 
-TcpManager::TcpManager(QObject *parent) : QObject(parent) {
+TcpManager::TcpManager(QObject *parent) : QObject(parent), m_trafficStats(nullptr) {
     m_tcpSocket = new QTcpSocket(this);
     connect(m_tcpSocket, &QTcpSocket::connected, this, &TcpManager::onConnected);
     connect(m_tcpSocket, &QTcpSocket::disconnected, this, &TcpManager::onDisconnected);
     connect(m_tcpSocket, &QTcpSocket::readyRead, this, &TcpManager::handleReadyRead);
     connect(m_tcpSocket, &QTcpSocket::errorOccurred, this, &TcpManager::handleSocketError);
+    connect(m_tcpSocket, &QTcpSocket::bytesWritten, this, &TcpManager::bytesWritten);
 }
 
 TcpManager::~TcpManager() {
@@ -19,14 +21,19 @@ void TcpManager::connectToServer(const QString &host, quint16 port) {
 }
 
 void TcpManager::disconnectFromServer() {
-    if (m_tcpSocket->isOpen()) {
+    if (isConnected()) {
         m_tcpSocket->disconnectFromHost();
+    } else if (m_tcpSocket->state() == QAbstractSocket::HostLookupState
+               || m_tcpSocket->state() == QAbstractSocket::ConnectingState) {
+        // 仍在解析地址或连接中：直接中止，否则稍后建立的连接会绕过这次断开
+        m_tcpSocket->abort();
     }
 }
 
 void TcpManager::writeData(const QByteArray &data) {
     if (isConnected()) {
         m_tcpSocket->write(data);
+        recordTraffic(TrafficStats::Tx, data.size());
     }
 }
 
@@ -34,8 +41,23 @@ bool TcpManager::isConnected() const {
     return m_tcpSocket->state() == QAbstractSocket::ConnectedState;
 }
 
+qint64 TcpManager::bytesToWrite() const {
+    return m_tcpSocket->bytesToWrite();
+}
+
 void TcpManager::handleReadyRead() {
-    emit dataReceived(m_tcpSocket->readAll());
+    const QByteArray data = m_tcpSocket->readAll();
+    recordTraffic(TrafficStats::Rx, data.size());
+    emit dataReceived(data);
+}
+
+void TcpManager::recordTraffic(TrafficStats::Direction direction, qint64 bytes) {
+    if (!m_trafficStats) return;
+    if (!m_statsPeer) {
+        m_statsPeer = m_trafficStats->peer(CaptureWriter::Transport::TcpClient,
+                                           m_tcpSocket->peerAddress().toString(), m_tcpSocket->peerPort());
+    }
+    m_trafficStats->record(direction, m_statsPeer, bytes);
 }
 
 void TcpManager::handleSocketError(QAbstractSocket::SocketError socketError) {
@@ -48,5 +70,6 @@ void TcpManager::onConnected() {
 }
 
 void TcpManager::onDisconnected() {
+    m_statsPeer.reset(); // 下次可能连到别的服务器
     emit disconnected();
 }
\ No newline at end of file
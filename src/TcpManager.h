@@ -3,6 +3,7 @@
 
 #include <QObject>
 #include <QTcpSocket>
+#include "TrafficStats.h"
 
 class TcpManager : public QObject {
     Q_OBJECT
@@ -15,11 +16,16 @@ public:
     void disconnectFromServer();
     void writeData(const QByteArray &data);
     bool isConnected() const;
+    // 已提交但尚未写入套接字的字节数，用于发送端背压
+    qint64 bytesToWrite() const;
+    // 为空时不统计
+    void setTrafficStats(TrafficStats *stats) { m_trafficStats = stats; m_statsPeer.reset(); }
 
 signals:
     void connected();
     void disconnected();
     void dataReceived(const QByteArray &data);
+    void bytesWritten(qint64 bytes);
     void errorOccurred(const QString &errorText);
 
 private slots:
@@ -29,7 +35,11 @@ private slots:
     void onDisconnected();
 
 private:
+    void recordTraffic(TrafficStats::Direction direction, qint64 bytes);
+
     QTcpSocket *m_tcpSocket;
+    TrafficStats *m_trafficStats;
+    TrafficStats::PeerHandle m_statsPeer; // 当前连接的统计句柄，连接后首次收发时查找
 };
 
 #endif // TCPMANAGER_H
\ No newline at end of file
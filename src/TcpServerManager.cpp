@@ -2,8 +2,9 @@
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QHostAddress>
+#include "TrafficStats.h"
 
-TcpServerManager::TcpServerManager(QObject *parent) : QObject(parent) {
+TcpServerManager::TcpServerManager(QObject *parent) : ITcpServerManager(parent), m_nextClientId(1) {
     m_server = new QTcpServer(this);
     connect(m_server, &QTcpServer::newConnection, this, &TcpServerManager::onNewConnection);
 }
@@ -24,23 +25,35 @@ bool TcpServerManager::startListening(quint16 port) {
 
 void TcpServerManager::stopListening() {
     // 断开所有客户端连接
-    for (QTcpSocket *client : m_clients.values()) {
-        client->disconnectFromHost();
+    // 遍历副本：没有待写数据的套接字会同步发出 disconnected，从 m_clients 中移除自己
+    const QList<quint64> clients = m_clients.keys();
+    for (quint64 clientId : clients) {
+        auto it = m_clients.find(clientId);
+        if (it != m_clients.end()) it->socket->disconnectFromHost();
     }
     m_server->close();
+    // 仍在写出的客户端不再跟踪，尚未完成的群发按失败报告
+    for (auto it = m_clients.begin(); it != m_clients.end(); ++it) {
+        failPendingCompletions(it.key(), *it);
+    }
     m_clients.clear();
     emit serverMessage("服务器已停止监听");
 }
 
-void TcpServerManager::writeData(const QByteArray &data, const QString &clientInfo) {
-    if (m_clients.contains(clientInfo)) {
-        m_clients[clientInfo]->write(data);
+void TcpServerManager::writeData(const QByteArray &data, quint64 clientId) {
+    auto it = m_clients.find(clientId);
+    if (it == m_clients.end()) return;
+    it->socket->write(data);
+    it->queuedBytes += data.size();
+    if (m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, it->statsPeer, data.size());
     }
 }
 
-void TcpServerManager::disconnectClient(const QString &clientInfo) {
-    if (m_clients.contains(clientInfo)) {
-        m_clients[clientInfo]->disconnectFromHost();
+void TcpServerManager::disconnectClient(quint64 clientId) {
+    auto it = m_clients.constFind(clientId);
+    if (it != m_clients.constEnd()) {
+        it->socket->disconnectFromHost();
     }
 }
 
@@ -48,42 +61,91 @@ bool TcpServerManager::isListening() const {
     return m_server->isListening();
 }
 
+qint64 TcpServerManager::bytesToWrite(quint64 clientId) const {
+    auto it = m_clients.constFind(clientId);
+    return it != m_clients.constEnd() ? it->socket->bytesToWrite() : 0;
+}
+
+QString TcpServerManager::clientInfo(quint64 clientId) const {
+    auto it = m_clients.constFind(clientId);
+    return it != m_clients.constEnd() ? it->info : QString();
+}
+
 void TcpServerManager::onNewConnection() {
     while (m_server->hasPendingConnections()) {
         QTcpSocket *clientSocket = m_server->nextPendingConnection();
         if (clientSocket) {
+            const quint64 clientId = m_nextClientId++;
             QString clientInfo = QString("%1:%2")
                                      .arg(clientSocket->peerAddress().toString())
                                      .arg(clientSocket->peerPort());
-            m_clients.insert(clientInfo, clientSocket);
-            
-            connect(clientSocket, &QTcpSocket::disconnected, this, &TcpServerManager::onClientDisconnected);
-            connect(clientSocket, &QTcpSocket::readyRead, this, &TcpServerManager::onReadyRead);
-            
-            emit clientConnected(clientInfo);
+            Client client { clientSocket, clientInfo };
+            if (m_trafficStats) client.statsPeer = m_trafficStats->peer(CaptureWriter::Transport::TcpServer, clientInfo, 0);
+            m_clients.insert(clientId, client);
+
+            // 每个连接捕获自己的句柄，收发和断开时不需要反查
+            connect(clientSocket, &QTcpSocket::disconnected, this, [this, clientId]() { onClientDisconnected(clientId); });
+            connect(clientSocket, &QTcpSocket::readyRead, this, [this, clientId]() { onReadyRead(clientId); });
+            connect(clientSocket, &QTcpSocket::bytesWritten, this, [this, clientId](qint64 bytes) {
+                onBytesWritten(clientId, bytes);
+            });
+            connect(clientSocket, &QTcpSocket::disconnected, clientSocket, &QObject::deleteLater);
+
+            emit clientConnected(clientId, clientInfo);
         }
     }
 }
 
-void TcpServerManager::onClientDisconnected() {
-    QTcpSocket *clientSocket = qobject_cast<QTcpSocket *>(sender());
-    if (!clientSocket) return;
+void TcpServerManager::onClientDisconnected(quint64 clientId) {
+    auto it = m_clients.find(clientId);
+    if (it != m_clients.end()) {
+        failPendingCompletions(clientId, *it);
+        // 先发信号再删除，槽函数里仍能查到 clientInfo
+        emit clientDisconnected(clientId);
+        m_clients.remove(clientId);
+    }
+}
+
+void TcpServerManager::onReadyRead(quint64 clientId) {
+    auto it = m_clients.constFind(clientId);
+    if (it == m_clients.constEnd()) return;
 
-    QString clientInfo = m_clients.key(clientSocket);
-    if (!clientInfo.isEmpty()) {
-        m_clients.remove(clientInfo);
-        emit clientDisconnected(clientInfo);
+    QByteArray data = it->socket->readAll();
+    if (m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Rx, it->statsPeer, data.size());
     }
-    clientSocket->deleteLater();
+    emit dataReceived(data, clientId);
 }
 
-void TcpServerManager::onReadyRead() {
-    QTcpSocket *clientSocket = qobject_cast<QTcpSocket *>(sender());
-    if (!clientSocket) return;
+void TcpServerManager::onBytesWritten(quint64 clientId, qint64 bytes) {
+    auto it = m_clients.find(clientId);
+    if (it != m_clients.end()) {
+        it->writtenBytes += bytes;
+        while (!it->completions.empty() && it->completions.front().endOffset <= it->writtenBytes) {
+            const quint64 sendId = it->completions.front().sendId;
+            it->completions.pop_front();
+            reportCompletion(sendId, clientId, true);
+        }
+    }
+    emit bytesWritten(bytes, clientId);
+}
 
-    QString clientInfo = m_clients.key(clientSocket);
-    if (!clientInfo.isEmpty()) {
-        QByteArray data = clientSocket->readAll();
-        emit dataReceived(data, clientInfo);
+void TcpServerManager::queueMulticast(quint64 sendId, const QByteArray &data, const QList<quint64> &clientIds) {
+    for (quint64 clientId : clientIds) {
+        auto it = m_clients.find(clientId);
+        if (it == m_clients.end() || data.isEmpty()) {
+            reportCompletion(sendId, clientId, it != m_clients.end());
+            continue;
+        }
+        writeData(data, clientId);
+        it->completions.push_back({ it->queuedBytes, sendId });
     }
-}
\ No newline at end of file
+}
+
+void TcpServerManager::failPendingCompletions(quint64 clientId, Client &client) {
+    std::deque<PendingCompletion> completions;
+    completions.swap(client.completions);
+    for (const PendingCompletion &completion : completions) {
+        reportCompletion(completion.sendId, clientId, false);
+    }
+}
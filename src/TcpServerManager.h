@@ -1,41 +1,64 @@
 #ifndef TCPSERVERMANAGER_H
 #define TCPSERVERMANAGER_H
 
-#include <QObject>
-#include <QList>
-#include <QMap>
+#include "ITcpServerManager.h"
+#include "TrafficStats.h"
+#include <QHash>
+#include <deque>
 
 class QTcpServer;
 class QTcpSocket;
 
-class TcpServerManager : public QObject {
+// 基于 QTcpServer 的实现，所有平台可用。
+// 注意 QTcpSocket::write 会把数据复制进各自的写缓冲，群发时每个客户端仍有一次复制
+class TcpServerManager : public ITcpServerManager {
     Q_OBJECT
 
 public:
     explicit TcpServerManager(QObject *parent = nullptr);
-    ~TcpServerManager();
+    ~TcpServerManager() override;
 
-    bool startListening(quint16 port);
-    void stopListening();
-    void writeData(const QByteArray &data, const QString &clientInfo);
-    void disconnectClient(const QString &clientInfo);
-    bool isListening() const;
+    bool startListening(quint16 port) override;
+    void stopListening() override;
+    void writeData(const QByteArray &data, quint64 clientId) override;
+    void disconnectClient(quint64 clientId) override;
+    bool isListening() const override;
+    qint64 bytesToWrite(quint64 clientId) const override;
+    QString clientInfo(quint64 clientId) const override;
+    QList<quint64> clientIds() const override { return m_clients.keys(); }
 
-signals:
-    void clientConnected(const QString &clientInfo);
-    void clientDisconnected(const QString &clientInfo);
-    void dataReceived(const QByteArray &data, const QString &clientInfo);
-    void serverMessage(const QString &message); // 用于向状态栏或日志发送信息
+protected:
+    void queueMulticast(quint64 sendId, const QByteArray &data, const QList<quint64> &clientIds) override;
 
 private slots:
     void onNewConnection();
-    void onClientDisconnected();
-    void onReadyRead();
+
+private:
+    // 群发的某一份数据在该客户端字节流中的结束位置，写出到这里即算完成
+    struct PendingCompletion {
+        qint64 endOffset;
+        quint64 sendId;
+    };
+
+    struct Client {
+        QTcpSocket *socket;
+        QString info;
+        TrafficStats::PeerHandle statsPeer; // 连接时查找一次
+        qint64 queuedBytes = 0;      // 累计交给套接字的字节数
+        qint64 writtenBytes = 0;     // 累计写入内核的字节数
+        std::deque<PendingCompletion> completions;
+    };
+
+    void onClientDisconnected(quint64 clientId);
+    void onReadyRead(quint64 clientId);
+    void onBytesWritten(quint64 clientId, qint64 bytes);
+    void failPendingCompletions(quint64 clientId, Client &client);
 
 private:
     QTcpServer *m_server;
-    // 使用 QMap 来方便地通过 clientInfo 字符串查找 socket
-    QMap<QString, QTcpSocket*> m_clients; 
+    // 句柄 -> 客户端；反方向 (套接字 -> 句柄) 由各套接字信号连接时捕获的句柄提供，同样不需要查找
+    QHash<quint64, Client> m_clients;
+    quint64 m_nextClientId;
 };
 
-#endif // TCPSERVERMANAGER_H
\ No newline at end of file
+#endif // TCPSERVERMANAGER_H
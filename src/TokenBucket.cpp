@@ -0,0 +1,38 @@
+#include "TokenBucket.h"
+#include <cmath>
+
+TokenBucket::TokenBucket()
+    : m_rate(0.0)
+    , m_capacity(0.0)
+    , m_tokens(0.0)
+    , m_lastNs(0)
+{
+}
+
+void TokenBucket::configure(double ratePerSecond, double capacity) {
+    m_rate = ratePerSecond;
+    m_capacity = capacity;
+    m_tokens = qMin(m_tokens, m_capacity);
+}
+
+void TokenBucket::reset(qint64 nowNs) {
+    // 从满桶开始，第一批突发可以立即发出
+    m_tokens = m_capacity;
+    m_lastNs = nowNs;
+}
+
+qint64 TokenBucket::reserve(double cost, qint64 nowNs) {
+    if (m_rate <= 0.0) return 0; // 未限速
+
+    if (nowNs > m_lastNs) {
+        m_tokens = qMin(m_capacity, m_tokens + (nowNs - m_lastNs) * m_rate / 1e9);
+        m_lastNs = nowNs;
+    }
+    // 代价超过桶容量时 (单包大于突发上限) 允许在桶满时放行，否则永远等不到
+    const double required = qMin(cost, m_capacity);
+    if (m_tokens >= required) {
+        m_tokens -= cost;
+        return 0;
+    }
+    return static_cast<qint64>(std::ceil((required - m_tokens) * 1e9 / m_rate));
+}
@@ -0,0 +1,31 @@
+#ifndef TOKENBUCKET_H
+#define TOKENBUCKET_H
+
+#include <QtGlobal>
+
+// 令牌桶限速器。令牌以 rate 个/秒的速度匀速补充，桶里最多积攒 capacity 个，
+// 因此长期速率不超过 rate，瞬时最多连续放行 capacity 个令牌 (突发)。
+// 令牌的单位由调用方决定：按字节限速时代价是包长，按包数限速时代价是 1。
+// 时间由调用方传入 (纳秒，单调递增)，本身不读时钟，也不是线程安全的。
+class TokenBucket {
+public:
+    TokenBucket();
+
+    void configure(double ratePerSecond, double capacity);
+    // 把桶装满 (可以立即突发 capacity 个令牌)，从 nowNs 开始计时；第一次 reserve 前必须调用
+    void reset(qint64 nowNs);
+
+    // 令牌足够时扣除并返回 0，否则不扣除，返回还需等待的纳秒数
+    qint64 reserve(double cost, qint64 nowNs);
+
+    double rate() const { return m_rate; }
+    double capacity() const { return m_capacity; }
+
+private:
+    double m_rate;
+    double m_capacity;
+    double m_tokens;
+    qint64 m_lastNs;
+};
+
+#endif // TOKENBUCKET_H
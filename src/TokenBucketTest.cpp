@@ -0,0 +1,123 @@
+// TokenBucket 的确定性测试：时间全部由测试传入，检查突发容量、补充速率、
+// 令牌不足时返回的等待时间，以及超过容量的单次代价和重新配置后的行为。
+#include "TokenBucket.h"
+#include <QTest>
+
+namespace {
+constexpr qint64 kNsPerMs = 1000000;
+constexpr qint64 kNsPerSecond = 1000000000;
+}
+
+class TokenBucketTest : public QObject {
+    Q_OBJECT
+
+private slots:
+    void unlimited();
+    void burstThenWait();
+    void waitIsNotCharged();
+    void refillCappedAtCapacity();
+    void longRunRate();
+    void costAboveCapacity();
+    void resetFillsBucket();
+    void shrinkCapacity();
+};
+
+void TokenBucketTest::unlimited() {
+    TokenBucket bucket;
+    bucket.configure(0.0, 10.0);
+    bucket.reset(0);
+    for (int i = 0; i < 100; ++i) {
+        QCOMPARE(bucket.reserve(1000.0, 0), qint64(0));
+    }
+}
+
+void TokenBucketTest::burstThenWait() {
+    // 1000 个/秒：每个令牌 1 ms
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(bucket.reserve(1.0, 0), qint64(0));
+    }
+    QCOMPARE(bucket.reserve(1.0, 0), qint64(kNsPerMs));
+    QCOMPARE(bucket.reserve(3.0, 0), qint64(3 * kNsPerMs));
+    // 等待期间已经补充了一部分，返回的是剩余的时间
+    QCOMPARE(bucket.reserve(1.0, kNsPerMs / 4), qint64(3 * kNsPerMs / 4));
+    QCOMPARE(bucket.reserve(1.0, kNsPerMs), qint64(0));
+}
+
+void TokenBucketTest::waitIsNotCharged() {
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    QCOMPARE(bucket.reserve(10.0, 0), qint64(0));
+    // 令牌不足时不扣除：先只补充到 1 个，等足 4 个后一次放行
+    QCOMPARE(bucket.reserve(4.0, kNsPerMs), qint64(3 * kNsPerMs));
+    QCOMPARE(bucket.reserve(4.0, 4 * kNsPerMs), qint64(0));
+    QCOMPARE(bucket.reserve(1.0, 4 * kNsPerMs), qint64(kNsPerMs));
+}
+
+void TokenBucketTest::refillCappedAtCapacity() {
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    QCOMPARE(bucket.reserve(10.0, 0), qint64(0));
+    // 空闲一秒本可补充 1000 个，但桶里最多 10 个
+    const qint64 later = kNsPerSecond;
+    QCOMPARE(bucket.reserve(10.0, later), qint64(0));
+    QCOMPARE(bucket.reserve(1.0, later), qint64(kNsPerMs));
+}
+
+void TokenBucketTest::longRunRate() {
+    // 按返回的等待时间推进时钟，一秒内放行 容量 + 速率 * 1 秒 个
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    qint64 nowNs = 0;
+    int granted = 0;
+    while (nowNs <= kNsPerSecond) {
+        const qint64 waitNs = bucket.reserve(1.0, nowNs);
+        if (waitNs == 0) {
+            ++granted;
+        } else {
+            QVERIFY(waitNs > 0);
+            nowNs += waitNs;
+        }
+    }
+    QCOMPARE(granted, 10 + 1000);
+}
+
+void TokenBucketTest::costAboveCapacity() {
+    // 单次代价大于容量时桶满即放行，欠下的令牌由之后的等待补足
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    QCOMPARE(bucket.reserve(25.0, 0), qint64(0));
+    QCOMPARE(bucket.reserve(1.0, 0), qint64(16 * kNsPerMs));
+    QCOMPARE(bucket.reserve(25.0, 16 * kNsPerMs), qint64(9 * kNsPerMs));
+    QCOMPARE(bucket.reserve(25.0, 25 * kNsPerMs), qint64(0));
+}
+
+void TokenBucketTest::resetFillsBucket() {
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    QCOMPARE(bucket.reserve(10.0, 0), qint64(0));
+    QVERIFY(bucket.reserve(1.0, 0) > 0);
+    bucket.reset(0);
+    QCOMPARE(bucket.reserve(10.0, 0), qint64(0));
+}
+
+void TokenBucketTest::shrinkCapacity() {
+    TokenBucket bucket;
+    bucket.configure(1000.0, 10.0);
+    bucket.reset(0);
+    bucket.configure(2000.0, 4.0);
+    QCOMPARE(bucket.rate(), 2000.0);
+    QCOMPARE(bucket.capacity(), 4.0);
+    QCOMPARE(bucket.reserve(4.0, 0), qint64(0));
+    QCOMPARE(bucket.reserve(1.0, 0), qint64(kNsPerMs / 2));
+}
+
+QTEST_APPLESS_MAIN(TokenBucketTest)
+#include "TokenBucketTest.moc"
@@ -0,0 +1,254 @@
+#include "TrafficStats.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QStringList>
+#include <QtAlgorithms>
+
+namespace {
+const char *const kDirectionNames[2] = { "rx", "tx" };
+
+int sizeBucket(quint64 size) {
+    // 64 字节以下为第 0 桶，此后按最高位分桶
+    const int bits = size > 0 ? 64 - qCountLeadingZeroBits(size) : 0;
+    return qBound(0, bits - 6, TrafficStats::kSizeBuckets - 1);
+}
+
+int gapBucket(qint64 gapNs) {
+    const quint64 gapUs = static_cast<quint64>(gapNs / 1000);
+    const int bits = gapUs > 0 ? 64 - qCountLeadingZeroBits(gapUs) : 0;
+    return qMin(bits, TrafficStats::kGapBuckets - 1);
+}
+
+QString formatBytes(quint64 bytes) {
+    if (bytes >= 1024 * 1024) return QString("%1M").arg(bytes / (1024 * 1024));
+    if (bytes >= 1024) return QString("%1K").arg(bytes / 1024);
+    return QString::number(bytes);
+}
+
+QString formatMicroseconds(quint64 us) {
+    if (us >= 1000000) return QString("%1s").arg(us / 1e6, 0, 'g', 3);
+    if (us >= 1000) return QString("%1ms").arg(us / 1e3, 0, 'g', 3);
+    return QString("%1us").arg(us);
+}
+
+double perSecond(quint64 now, quint64 before, double seconds) {
+    return (seconds > 0 && now >= before) ? (now - before) / seconds : 0.0;
+}
+}
+
+size_t qHash(const TrafficStats::PeerKey &key, size_t seed) {
+    return qHashMulti(seed, static_cast<int>(key.transport), key.host, key.port);
+}
+
+TrafficStats::TrafficStats() {
+    for (PeerHandle &overflow : m_overflowPeers) {
+        overflow = std::make_shared<PeerCounters>();
+    }
+    m_clock.start();
+    reset();
+}
+
+TrafficStats::~TrafficStats() {
+}
+
+void TrafficStats::clearDirection(DirectionCounters *counters) {
+    counters->bytes.store(0, std::memory_order_relaxed);
+    counters->packets.store(0, std::memory_order_relaxed);
+    counters->lastArrivalNs.store(-1, std::memory_order_relaxed);
+    for (std::atomic<quint64> &bucket : counters->sizeHistogram) bucket.store(0, std::memory_order_relaxed);
+    for (std::atomic<quint64> &bucket : counters->gapHistogram) bucket.store(0, std::memory_order_relaxed);
+}
+
+void TrafficStats::clearPeer(PeerCounters *counters) {
+    for (int i = 0; i < 2; ++i) {
+        counters->bytes[i].store(0, std::memory_order_relaxed);
+        counters->packets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+void TrafficStats::reset() {
+    // 调用方缓存着句柄，对端条目只清零不移除；没有流量的条目不出现在快照中
+    QReadLocker locker(&m_peerLock);
+    for (DirectionCounters &counters : m_direction) {
+        clearDirection(&counters);
+    }
+    for (const PeerHandle &counters : m_peers) {
+        clearPeer(counters.get());
+    }
+    for (const PeerHandle &overflow : m_overflowPeers) {
+        clearPeer(overflow.get());
+    }
+}
+
+TrafficStats::PeerHandle TrafficStats::peer(CaptureWriter::Transport transport, const QString &host, quint16 port) {
+    const PeerKey key { transport, host, port };
+    {
+        QReadLocker locker(&m_peerLock);
+        auto it = m_peers.constFind(key);
+        if (it != m_peers.constEnd()) return *it;
+    }
+
+    QWriteLocker locker(&m_peerLock);
+    auto existing = m_peers.constFind(key); // 解锁期间可能已被其他线程插入
+    if (existing != m_peers.constEnd()) return *existing;
+    if (m_peers.size() >= kMaxPeers) return m_overflowPeers[static_cast<int>(transport)];
+
+    PeerHandle created = std::make_shared<PeerCounters>();
+    clearPeer(created.get());
+    m_peers.insert(key, created);
+    return created;
+}
+
+void TrafficStats::record(Direction direction, const PeerHandle &peer, qint64 bytes, quint64 packets) {
+    if (bytes < 0 || packets == 0) return;
+    DirectionCounters &counters = m_direction[direction];
+    const qint64 nowNs = m_clock.nsecsElapsed();
+
+    counters.bytes.fetch_add(static_cast<quint64>(bytes), std::memory_order_relaxed);
+    counters.packets.fetch_add(packets, std::memory_order_relaxed);
+    counters.sizeHistogram[sizeBucket(static_cast<quint64>(bytes) / packets)].fetch_add(packets, std::memory_order_relaxed);
+
+    const qint64 previousNs = counters.lastArrivalNs.exchange(nowNs, std::memory_order_relaxed);
+    if (previousNs >= 0) {
+        counters.gapHistogram[gapBucket(nowNs - previousNs)].fetch_add(1, std::memory_order_relaxed);
+        // 一次批量记录的其余数据报视为同时到达
+        if (packets > 1) counters.gapHistogram[0].fetch_add(packets - 1, std::memory_order_relaxed);
+    }
+
+    if (peer) {
+        peer->bytes[direction].fetch_add(static_cast<quint64>(bytes), std::memory_order_relaxed);
+        peer->packets[direction].fetch_add(packets, std::memory_order_relaxed);
+    }
+}
+
+void TrafficStats::record(Direction direction, CaptureWriter::Transport transport, const QString &host, quint16 port,
+                          qint64 bytes, quint64 packets) {
+    if (bytes < 0 || packets == 0) return;
+    record(direction, peer(transport, host, port), bytes, packets);
+}
+
+TrafficStats::Snapshot TrafficStats::snapshot() const {
+    Snapshot snapshot;
+    snapshot.timestampNs = m_clock.nsecsElapsed();
+    for (int d = 0; d < 2; ++d) {
+        const DirectionCounters &counters = m_direction[d];
+        DirectionSnapshot &out = snapshot.direction[d];
+        out.bytes = counters.bytes.load(std::memory_order_relaxed);
+        out.packets = counters.packets.load(std::memory_order_relaxed);
+        for (int i = 0; i < kSizeBuckets; ++i) out.sizeHistogram[i] = counters.sizeHistogram[i].load(std::memory_order_relaxed);
+        for (int i = 0; i < kGapBuckets; ++i) out.gapHistogram[i] = counters.gapHistogram[i].load(std::memory_order_relaxed);
+    }
+
+    QReadLocker locker(&m_peerLock);
+    auto appendPeer = [&snapshot](CaptureWriter::Transport transport, const QString &peer, const PeerCounters &counters) {
+        PeerSnapshot out;
+        out.transport = transport;
+        out.peer = peer;
+        for (int d = 0; d < 2; ++d) {
+            out.bytes[d] = counters.bytes[d].load(std::memory_order_relaxed);
+            out.packets[d] = counters.packets[d].load(std::memory_order_relaxed);
+        }
+        snapshot.peers.append(out);
+    };
+    auto hasTraffic = [](const PeerCounters &counters) {
+        return counters.packets[Rx].load(std::memory_order_relaxed) + counters.packets[Tx].load(std::memory_order_relaxed) > 0;
+    };
+    snapshot.peers.reserve(m_peers.size() + kTransportCount);
+    for (auto it = m_peers.constBegin(); it != m_peers.constEnd(); ++it) {
+        if (!hasTraffic(*it.value())) continue;
+        const PeerKey &key = it.key();
+        appendPeer(key.transport, key.port ? QString("%1:%2").arg(key.host).arg(key.port) : key.host, *it.value());
+    }
+    for (int transport = 0; transport < kTransportCount; ++transport) {
+        if (hasTraffic(*m_overflowPeers[transport])) {
+            appendPeer(static_cast<CaptureWriter::Transport>(transport), QStringLiteral("(其他)"), *m_overflowPeers[transport]);
+        }
+    }
+    return snapshot;
+}
+
+QString TrafficStats::sizeBucketLabel(int bucket) {
+    if (bucket <= 0) return QStringLiteral("<64");
+    const quint64 low = quint64(1) << (bucket + 5);
+    if (bucket == kSizeBuckets - 1) return QString(">=%1").arg(formatBytes(low));
+    return QString("%1-%2").arg(formatBytes(low)).arg(formatBytes((low << 1) - 1));
+}
+
+QString TrafficStats::gapBucketLabel(int bucket) {
+    if (bucket <= 0) return QStringLiteral("<1us");
+    const quint64 low = quint64(1) << (bucket - 1);
+    if (bucket == kGapBuckets - 1) return QString(">=%1").arg(formatMicroseconds(low));
+    return QString("%1-%2").arg(formatMicroseconds(low)).arg(formatMicroseconds(low << 1));
+}
+
+QByteArray TrafficStats::toJsonLine(const Snapshot &current, const Snapshot *previous) {
+    const double seconds = previous ? (current.timestampNs - previous->timestampNs) / 1e9 : 0.0;
+
+    QJsonObject root;
+    root.insert("uptime_s", current.timestampNs / 1e9);
+    for (int d = 0; d < 2; ++d) {
+        const DirectionSnapshot &now = current.direction[d];
+        QJsonObject direction;
+        direction.insert("bytes", static_cast<double>(now.bytes));
+        direction.insert("packets", static_cast<double>(now.packets));
+        direction.insert("bytes_per_s", previous ? perSecond(now.bytes, previous->direction[d].bytes, seconds) : 0.0);
+        direction.insert("packets_per_s", previous ? perSecond(now.packets, previous->direction[d].packets, seconds) : 0.0);
+        QJsonArray sizes;
+        for (quint64 count : now.sizeHistogram) sizes.append(static_cast<double>(count));
+        QJsonArray gaps;
+        for (quint64 count : now.gapHistogram) gaps.append(static_cast<double>(count));
+        direction.insert("size_histogram", sizes);
+        direction.insert("gap_histogram_us", gaps);
+        root.insert(kDirectionNames[d], direction);
+    }
+
+    QJsonArray peers;
+    for (const PeerSnapshot &peer : current.peers) {
+        QJsonObject object;
+        object.insert("transport", CaptureWriter::transportName(peer.transport));
+        object.insert("peer", peer.peer);
+        for (int d = 0; d < 2; ++d) {
+            object.insert(QString("%1_bytes").arg(kDirectionNames[d]), static_cast<double>(peer.bytes[d]));
+            object.insert(QString("%1_packets").arg(kDirectionNames[d]), static_cast<double>(peer.packets[d]));
+        }
+        peers.append(object);
+    }
+    root.insert("peers", peers);
+    return QJsonDocument(root).toJson(QJsonDocument::Compact) + '\n';
+}
+
+QByteArray TrafficStats::csvHeader() {
+    QString header = QStringLiteral("uptime_s");
+    for (const char *direction : kDirectionNames) {
+        header += QString(",%1_bytes,%1_packets,%1_bytes_per_s,%1_packets_per_s").arg(direction);
+        for (int i = 0; i < kSizeBuckets; ++i) header += QString(",%1_size_%2").arg(direction).arg(sizeBucketLabel(i));
+        for (int i = 0; i < kGapBuckets; ++i) header += QString(",%1_gap_%2").arg(direction).arg(gapBucketLabel(i));
+    }
+    header += QStringLiteral(",peer_count,peers\n");
+    return header.toUtf8();
+}
+
+QByteArray TrafficStats::toCsvRow(const Snapshot &current, const Snapshot *previous) {
+    const double seconds = previous ? (current.timestampNs - previous->timestampNs) / 1e9 : 0.0;
+    QString row = QString::number(current.timestampNs / 1e9, 'f', 3);
+    for (int d = 0; d < 2; ++d) {
+        const DirectionSnapshot &now = current.direction[d];
+        row += QString(",%1,%2,%3,%4")
+                .arg(now.bytes)
+                .arg(now.packets)
+                .arg(previous ? perSecond(now.bytes, previous->direction[d].bytes, seconds) : 0.0, 0, 'f', 1)
+                .arg(previous ? perSecond(now.packets, previous->direction[d].packets, seconds) : 0.0, 0, 'f', 1);
+        for (quint64 count : now.sizeHistogram) row += QString(",%1").arg(count);
+        for (quint64 count : now.gapHistogram) row += QString(",%1").arg(count);
+    }
+    QStringList peers;
+    for (const PeerSnapshot &peer : current.peers) {
+        peers.append(QString("%1 %2 %3 %4 %5 %6")
+                     .arg(CaptureWriter::transportName(peer.transport), peer.peer)
+                     .arg(peer.bytes[Rx]).arg(peer.packets[Rx])
+                     .arg(peer.bytes[Tx]).arg(peer.packets[Tx]));
+    }
+    row += QString(",%1,%2\n").arg(current.peers.size()).arg(peers.join(';'));
+    return row.toUtf8();
+}
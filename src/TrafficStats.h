@@ -0,0 +1,122 @@
+#ifndef TRAFFICSTATS_H
+#define TRAFFICSTATS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QReadWriteLock>
+#include <QString>
+#include <array>
+#include <atomic>
+#include <memory>
+#include "CaptureWriter.h"
+
+// 收发流量统计。各通信管理器在收发路径上调用 record()，可以来自任意线程
+// (包括 recvmmsg / WinSock 接收线程和限速发送线程)：
+//   - 总计数、直方图和各对端的计数全部是 relaxed 原子量，record(direction, peer, ...) 不加锁；
+//   - 对端表用读写锁保护，只在 peer() 查找句柄时访问。热路径按连接或按发送方缓存句柄，
+//     不必每个数据报都取锁、对地址字符串求哈希。
+// 速率由两次 snapshot() 的差值得出，统计本身只保存累计值。
+class TrafficStats {
+public:
+    enum Direction { Rx = 0, Tx = 1 };
+
+    // 包长直方图：第 0 桶 < 64 字节，之后每桶翻倍，最后一桶 >= 1 MB
+    static constexpr int kSizeBuckets = 16;
+    // 到达间隔直方图 (微秒)：第 0 桶 < 1 us，第 i 桶 [2^(i-1), 2^i) us，最后一桶 >= 2^22 us (约 4 秒)
+    static constexpr int kGapBuckets = 24;
+    // 超过该数量的新对端合并到一个 "其他" 条目，防止扫描类流量把表撑大
+    static constexpr int kMaxPeers = 1024;
+
+    struct DirectionSnapshot {
+        quint64 bytes = 0;
+        quint64 packets = 0;
+        std::array<quint64, kSizeBuckets> sizeHistogram {};
+        std::array<quint64, kGapBuckets> gapHistogram {};
+    };
+
+    struct PeerSnapshot {
+        CaptureWriter::Transport transport = CaptureWriter::Transport::Serial;
+        QString peer;
+        quint64 bytes[2] = { 0, 0 };
+        quint64 packets[2] = { 0, 0 };
+    };
+
+    struct Snapshot {
+        qint64 timestampNs = 0;        // 相对统计开始的单调时间
+        DirectionSnapshot direction[2];
+        QList<PeerSnapshot> peers;
+    };
+
+    TrafficStats();
+    ~TrafficStats();
+
+    TrafficStats(const TrafficStats &) = delete;
+    TrafficStats &operator=(const TrafficStats &) = delete;
+
+    // 对端计数的句柄。对端一旦登记就不再移除 (reset() 只清零)，句柄一直有效
+    struct PeerCounters;
+    typedef std::shared_ptr<PeerCounters> PeerHandle;
+
+    // 线程安全。查找或登记对端，要取锁并对地址求哈希；对端超过 kMaxPeers 时返回该传输的 "其他" 条目
+    PeerHandle peer(CaptureWriter::Transport transport, const QString &host, quint16 port);
+    // 线程安全且无锁。packets > 1 表示一次批量发送了多个数据报，包长直方图按平均长度计入；
+    // peer 为空时只计入总计
+    void record(Direction direction, const PeerHandle &peer, qint64 bytes, quint64 packets = 1);
+    // 低频路径的便捷写法，每次调用都会查找对端
+    void record(Direction direction, CaptureWriter::Transport transport, const QString &host, quint16 port,
+                qint64 bytes, quint64 packets = 1);
+    Snapshot snapshot() const;
+    void reset();
+
+    static QString sizeBucketLabel(int bucket);
+    static QString gapBucketLabel(int bucket);
+
+    // 导出：JSON 每个快照一行 (JSON Lines)，速率按 previous 到 current 的间隔计算；
+    // previous 为空时速率为 0
+    static QByteArray toJsonLine(const Snapshot &current, const Snapshot *previous);
+    // CSV 每个快照一行：总计、速率、两个方向的包长和间隔直方图各一列一桶，
+    // 最后的 peers 列是按 ';' 分隔的 "传输 对端 rx字节 rx包数 tx字节 tx包数"
+    static QByteArray csvHeader();
+    static QByteArray toCsvRow(const Snapshot &current, const Snapshot *previous);
+
+private:
+    struct DirectionCounters {
+        std::atomic<quint64> bytes;
+        std::atomic<quint64> packets;
+        std::atomic<qint64> lastArrivalNs;
+        std::array<std::atomic<quint64>, kSizeBuckets> sizeHistogram;
+        std::array<std::atomic<quint64>, kGapBuckets> gapHistogram;
+    };
+
+    struct PeerKey {
+        CaptureWriter::Transport transport;
+        QString host;
+        quint16 port;
+        bool operator==(const PeerKey &other) const {
+            return transport == other.transport && port == other.port && host == other.host;
+        }
+    };
+    friend size_t qHash(const PeerKey &key, size_t seed);
+
+    static constexpr int kTransportCount = 4;
+
+    static void clearDirection(DirectionCounters *counters);
+    static void clearPeer(PeerCounters *counters);
+
+private:
+    QElapsedTimer m_clock;
+    DirectionCounters m_direction[2];
+
+    mutable QReadWriteLock m_peerLock;
+    QHash<PeerKey, PeerHandle> m_peers;
+    PeerHandle m_overflowPeers[kTransportCount]; // 按传输区分的 "其他" 条目
+};
+
+struct TrafficStats::PeerCounters {
+    std::atomic<quint64> bytes[2];
+    std::atomic<quint64> packets[2];
+};
+
+#endif // TRAFFICSTATS_H
@@ -0,0 +1,274 @@
+#include "TrafficStatsPanel.h"
+#include <QCheckBox>
+#include <QComboBox>
+#include <QDateTime>
+#include <QFileDialog>
+#include <QFileInfo>
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QMessageBox>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QSplitter>
+#include <QTableWidget>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <algorithm>
+
+namespace {
+constexpr int kRefreshIntervalMs = 1000;
+constexpr int kMaxPeerRows = 200;         // 对端很多时只显示流量最大的部分
+
+QTableWidget *createTable(const QStringList &headers, QWidget *parent) {
+    QTableWidget *table = new QTableWidget(0, headers.size(), parent);
+    table->setHorizontalHeaderLabels(headers);
+    table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    table->setSelectionMode(QAbstractItemView::NoSelection);
+    table->verticalHeader()->setVisible(false);
+    table->horizontalHeader()->setStretchLastSection(true);
+    return table;
+}
+
+double rate(quint64 now, quint64 before, double seconds) {
+    return (seconds > 0 && now >= before) ? (now - before) / seconds : 0.0;
+}
+}
+
+TrafficStatsPanel::TrafficStatsPanel(QWidget *parent)
+    : QWidget(parent)
+    , m_stats(nullptr)
+    , m_refreshTimer(new QTimer(this))
+    , m_exportTimer(new QTimer(this))
+    , m_hasLastSnapshot(false)
+    , m_exportCsv(false)
+    , m_hasLastExportSnapshot(false)
+{
+    m_summaryTable = createTable({ "指标", "接收", "发送" }, this);
+    m_peerTable = createTable({ "传输", "对端", "接收字节", "接收包", "发送字节", "发送包" }, this);
+    m_histogramTable = createTable({ "区间", "接收", "发送" }, this);
+
+    m_histogramComboBox = new QComboBox(this);
+    m_histogramComboBox->addItems({ "包长分布 (字节)", "到达间隔分布" });
+
+    QPushButton *resetButton = new QPushButton("清零", this);
+    QPushButton *exportButton = new QPushButton("导出快照", this);
+    exportButton->setToolTip("保存当前快照为 JSON 或 CSV (按扩展名)");
+    m_periodicExportCheckBox = new QCheckBox("定时导出", this);
+    m_periodicExportCheckBox->setToolTip("按间隔把快照追加到 JSON Lines (.jsonl) 或 CSV 文件");
+    m_exportIntervalSpinBox = new QSpinBox(this);
+    m_exportIntervalSpinBox->setRange(1, 3600);
+    m_exportIntervalSpinBox->setValue(1);
+    m_exportIntervalSpinBox->setSuffix(" 秒");
+    m_exportLabel = new QLabel(this);
+
+    QHBoxLayout *toolbar = new QHBoxLayout();
+    toolbar->addWidget(resetButton);
+    toolbar->addWidget(exportButton);
+    toolbar->addWidget(m_periodicExportCheckBox);
+    toolbar->addWidget(m_exportIntervalSpinBox);
+    toolbar->addWidget(m_exportLabel, 1);
+
+    QWidget *histogramWidget = new QWidget(this);
+    QVBoxLayout *histogramLayout = new QVBoxLayout(histogramWidget);
+    histogramLayout->setContentsMargins(0, 0, 0, 0);
+    histogramLayout->addWidget(m_histogramComboBox);
+    histogramLayout->addWidget(m_histogramTable);
+
+    QSplitter *splitter = new QSplitter(Qt::Vertical, this);
+    splitter->addWidget(m_summaryTable);
+    splitter->addWidget(m_peerTable);
+    splitter->addWidget(histogramWidget);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addLayout(toolbar);
+    layout->addWidget(splitter);
+
+    connect(resetButton, &QPushButton::clicked, this, &TrafficStatsPanel::resetStats);
+    connect(exportButton, &QPushButton::clicked, this, &TrafficStatsPanel::exportSnapshot);
+    connect(m_periodicExportCheckBox, &QCheckBox::toggled, this, &TrafficStatsPanel::onPeriodicExportToggled);
+    connect(m_exportIntervalSpinBox, &QSpinBox::valueChanged, this, [this](int seconds) {
+        m_exportTimer->setInterval(seconds * 1000);
+    });
+    connect(m_histogramComboBox, &QComboBox::currentIndexChanged, this, [this]() {
+        if (m_hasLastSnapshot) updateHistogramTable(m_lastSnapshot);
+    });
+    connect(m_refreshTimer, &QTimer::timeout, this, &TrafficStatsPanel::refresh);
+    connect(m_exportTimer, &QTimer::timeout, this, &TrafficStatsPanel::writePeriodicExport);
+
+    m_refreshTimer->start(kRefreshIntervalMs);
+}
+
+TrafficStatsPanel::~TrafficStatsPanel() {
+    stopPeriodicExport();
+}
+
+void TrafficStatsPanel::setTrafficStats(TrafficStats *stats) {
+    m_stats = stats;
+    m_hasLastSnapshot = false;
+    refresh();
+}
+
+void TrafficStatsPanel::refresh() {
+    if (!m_stats) return;
+    const TrafficStats::Snapshot snapshot = m_stats->snapshot();
+    const double seconds = m_hasLastSnapshot ? (snapshot.timestampNs - m_lastSnapshot.timestampNs) / 1e9 : 0.0;
+
+    // 面板不可见时只推进基准快照，省掉表格刷新
+    if (isVisible()) {
+        updateSummaryTable(snapshot, seconds);
+        updatePeerTable(snapshot);
+        updateHistogramTable(snapshot);
+    }
+    m_lastSnapshot = snapshot;
+    m_hasLastSnapshot = true;
+}
+
+void TrafficStatsPanel::setCell(QTableWidget *table, int row, int column, const QString &text) {
+    QTableWidgetItem *item = table->item(row, column);
+    if (!item) {
+        item = new QTableWidgetItem();
+        table->setItem(row, column, item);
+    }
+    item->setText(text);
+}
+
+void TrafficStatsPanel::updateSummaryTable(const TrafficStats::Snapshot &snapshot, double seconds) {
+    const TrafficStats::Snapshot *last = m_hasLastSnapshot ? &m_lastSnapshot : nullptr;
+    double bytesPerSecond[2] = { 0.0, 0.0 };
+    double packetsPerSecond[2] = { 0.0, 0.0 };
+    for (int d = 0; d < 2; ++d) {
+        if (!last) continue;
+        bytesPerSecond[d] = rate(snapshot.direction[d].bytes, last->direction[d].bytes, seconds);
+        packetsPerSecond[d] = rate(snapshot.direction[d].packets, last->direction[d].packets, seconds);
+    }
+
+    const QString rows[][3] = {
+        { "累计字节", QString::number(snapshot.direction[0].bytes), QString::number(snapshot.direction[1].bytes) },
+        { "累计包数", QString::number(snapshot.direction[0].packets), QString::number(snapshot.direction[1].packets) },
+        { "字节/秒", QString::number(bytesPerSecond[0], 'f', 0), QString::number(bytesPerSecond[1], 'f', 0) },
+        { "Mbit/s", QString::number(bytesPerSecond[0] * 8 / 1e6, 'f', 3), QString::number(bytesPerSecond[1] * 8 / 1e6, 'f', 3) },
+        { "包/秒", QString::number(packetsPerSecond[0], 'f', 1), QString::number(packetsPerSecond[1], 'f', 1) },
+    };
+    const int rowCount = static_cast<int>(sizeof(rows) / sizeof(rows[0]));
+    m_summaryTable->setRowCount(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            setCell(m_summaryTable, row, column, rows[row][column]);
+        }
+    }
+}
+
+void TrafficStatsPanel::updatePeerTable(const TrafficStats::Snapshot &snapshot) {
+    QList<TrafficStats::PeerSnapshot> peers = snapshot.peers;
+    std::sort(peers.begin(), peers.end(), [](const TrafficStats::PeerSnapshot &a, const TrafficStats::PeerSnapshot &b) {
+        return a.bytes[0] + a.bytes[1] > b.bytes[0] + b.bytes[1];
+    });
+    const int rowCount = qMin<int>(peers.size(), kMaxPeerRows);
+    m_peerTable->setRowCount(rowCount);
+    for (int row = 0; row < rowCount; ++row) {
+        const TrafficStats::PeerSnapshot &peer = peers.at(row);
+        setCell(m_peerTable, row, 0, CaptureWriter::transportName(peer.transport));
+        setCell(m_peerTable, row, 1, peer.peer);
+        setCell(m_peerTable, row, 2, QString::number(peer.bytes[TrafficStats::Rx]));
+        setCell(m_peerTable, row, 3, QString::number(peer.packets[TrafficStats::Rx]));
+        setCell(m_peerTable, row, 4, QString::number(peer.bytes[TrafficStats::Tx]));
+        setCell(m_peerTable, row, 5, QString::number(peer.packets[TrafficStats::Tx]));
+    }
+}
+
+void TrafficStatsPanel::updateHistogramTable(const TrafficStats::Snapshot &snapshot) {
+    const bool sizes = m_histogramComboBox->currentIndex() == 0;
+    const int buckets = sizes ? TrafficStats::kSizeBuckets : TrafficStats::kGapBuckets;
+    m_histogramTable->setRowCount(buckets);
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        setCell(m_histogramTable, bucket, 0, sizes ? TrafficStats::sizeBucketLabel(bucket) : TrafficStats::gapBucketLabel(bucket));
+        for (int d = 0; d < 2; ++d) {
+            const quint64 count = sizes ? snapshot.direction[d].sizeHistogram[bucket] : snapshot.direction[d].gapHistogram[bucket];
+            setCell(m_histogramTable, bucket, d + 1, QString::number(count));
+        }
+    }
+}
+
+void TrafficStatsPanel::resetStats() {
+    if (!m_stats) return;
+    m_stats->reset();
+    m_hasLastSnapshot = false;
+    m_hasLastExportSnapshot = false;
+    refresh();
+}
+
+void TrafficStatsPanel::exportSnapshot() {
+    if (!m_stats) return;
+    const QString filePath = QFileDialog::getSaveFileName(this, "导出流量统计",
+                                                          QString("traffic_stats_%1.json").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+                                                          "JSON (*.json);;CSV (*.csv)");
+    if (filePath.isEmpty()) return;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "错误", "无法写入文件: " + file.errorString());
+        return;
+    }
+    // 速率以上一次刷新为基准
+    const TrafficStats::Snapshot snapshot = m_stats->snapshot();
+    const TrafficStats::Snapshot *previous = m_hasLastSnapshot ? &m_lastSnapshot : nullptr;
+    if (filePath.endsWith(".csv", Qt::CaseInsensitive)) {
+        file.write(TrafficStats::csvHeader());
+        file.write(TrafficStats::toCsvRow(snapshot, previous));
+    } else {
+        file.write(TrafficStats::toJsonLine(snapshot, previous));
+    }
+    m_exportLabel->setText("已导出: " + QFileInfo(filePath).fileName());
+}
+
+void TrafficStatsPanel::onPeriodicExportToggled(bool checked) {
+    if (!checked) {
+        stopPeriodicExport();
+        return;
+    }
+    const QString filePath = QFileDialog::getSaveFileName(this, "定时导出流量统计",
+                                                          QString("traffic_stats_%1.jsonl").arg(QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss")),
+                                                          "JSON Lines (*.jsonl);;CSV (*.csv)");
+    if (filePath.isEmpty() || !m_stats) {
+        m_periodicExportCheckBox->setChecked(false);
+        return;
+    }
+    m_exportFile.setFileName(filePath);
+    if (!m_exportFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        QMessageBox::warning(this, "错误", "无法写入文件: " + m_exportFile.errorString());
+        m_periodicExportCheckBox->setChecked(false);
+        return;
+    }
+    m_exportCsv = filePath.endsWith(".csv", Qt::CaseInsensitive);
+    if (m_exportCsv) {
+        m_exportFile.write(TrafficStats::csvHeader());
+    }
+    m_hasLastExportSnapshot = false;
+    writePeriodicExport();
+    m_exportTimer->start(m_exportIntervalSpinBox->value() * 1000);
+    m_exportLabel->setText("正在导出: " + QFileInfo(filePath).fileName());
+}
+
+void TrafficStatsPanel::writePeriodicExport() {
+    if (!m_stats || !m_exportFile.isOpen()) return;
+    const TrafficStats::Snapshot snapshot = m_stats->snapshot();
+    const TrafficStats::Snapshot *previous = m_hasLastExportSnapshot ? &m_lastExportSnapshot : nullptr;
+    const QByteArray line = m_exportCsv ? TrafficStats::toCsvRow(snapshot, previous) : TrafficStats::toJsonLine(snapshot, previous);
+    if (m_exportFile.write(line) != line.size()) {
+        m_exportLabel->setText("导出失败: " + m_exportFile.errorString());
+        m_periodicExportCheckBox->setChecked(false);
+        return;
+    }
+    m_exportFile.flush();
+    m_lastExportSnapshot = snapshot;
+    m_hasLastExportSnapshot = true;
+}
+
+void TrafficStatsPanel::stopPeriodicExport() {
+    m_exportTimer->stop();
+    if (m_exportFile.isOpen()) {
+        m_exportFile.close();
+        m_exportLabel->setText("已停止导出: " + QFileInfo(m_exportFile.fileName()).fileName());
+    }
+}
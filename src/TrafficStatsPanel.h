@@ -0,0 +1,62 @@
+#ifndef TRAFFICSTATSPANEL_H
+#define TRAFFICSTATSPANEL_H
+
+#include <QWidget>
+#include <QFile>
+#include "TrafficStats.h"
+
+class QCheckBox;
+class QComboBox;
+class QLabel;
+class QSpinBox;
+class QTableWidget;
+class QTimer;
+
+// 流量统计面板：每秒刷新收发速率、按对端的分项和直方图，
+// 支持导出单个快照或按固定间隔把快照追加到 JSON Lines / CSV 文件
+class TrafficStatsPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit TrafficStatsPanel(QWidget *parent = nullptr);
+    ~TrafficStatsPanel() override;
+
+    void setTrafficStats(TrafficStats *stats);
+
+private slots:
+    void refresh();
+    void exportSnapshot();
+    void onPeriodicExportToggled(bool checked);
+    void writePeriodicExport();
+    void resetStats();
+
+private:
+    void updateSummaryTable(const TrafficStats::Snapshot &snapshot, double seconds);
+    void updatePeerTable(const TrafficStats::Snapshot &snapshot);
+    void updateHistogramTable(const TrafficStats::Snapshot &snapshot);
+    void stopPeriodicExport();
+    static void setCell(QTableWidget *table, int row, int column, const QString &text);
+
+private:
+    TrafficStats *m_stats;
+    QTimer *m_refreshTimer;
+    QTimer *m_exportTimer;
+
+    QTableWidget *m_summaryTable;
+    QTableWidget *m_peerTable;
+    QTableWidget *m_histogramTable;
+    QComboBox *m_histogramComboBox;
+    QCheckBox *m_periodicExportCheckBox;
+    QSpinBox *m_exportIntervalSpinBox;
+    QLabel *m_exportLabel;
+
+    TrafficStats::Snapshot m_lastSnapshot;     // 上一次刷新时的快照，用于计算速率
+    bool m_hasLastSnapshot;
+
+    QFile m_exportFile;
+    bool m_exportCsv;
+    TrafficStats::Snapshot m_lastExportSnapshot;
+    bool m_hasLastExportSnapshot;
+};
+
+#endif // TRAFFICSTATSPANEL_H
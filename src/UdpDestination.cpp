@@ -0,0 +1,202 @@
+#include "UdpDestination.h"
+#include <QHostAddress>
+#include <QDebug>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <cerrno>
+#endif
+#ifdef Q_OS_LINUX
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103      // 较旧的 glibc 头文件没有定义，内核 4.18 起支持
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP IPPROTO_UDP
+#endif
+#endif
+
+static_assert(sizeof(sockaddr_storage) <= 128, "UdpDestination storage too small");
+
+namespace {
+#ifdef Q_OS_WIN
+typedef SOCKET NativeSocket;
+#else
+typedef int NativeSocket;
+#endif
+
+#ifdef Q_OS_LINUX
+constexpr int kMaxBatchDatagrams = 64;     // 每次 sendmmsg 的数据报数，同时也是内核 UDP_MAX_SEGMENTS
+constexpr qsizetype kMaxGsoBytes = 65000;  // 一次 GSO 发送的总长度不能超过单个 UDP 数据报上限
+#endif
+}
+
+UdpDestination::UdpDestination()
+    : m_length(0)
+#ifdef Q_OS_LINUX
+    , m_gsoEnabled(true)
+#else
+    , m_gsoEnabled(false)
+#endif
+{
+    std::memset(m_storage, 0, sizeof(m_storage));
+}
+
+bool UdpDestination::resolve(qintptr socketDescriptor, const QString &host, quint16 port) {
+    m_length = 0;
+    std::memset(m_storage, 0, sizeof(m_storage));
+
+    QHostAddress address(host);
+    if (address.isNull() || socketDescriptor < 0) return false;
+
+    // 以套接字绑定时的地址族为准：Qt 绑定 Any 时是双栈 IPv6，原生实现是 IPv4
+    sockaddr_storage local{};
+    socklen_t localLength = sizeof(local);
+    if (getsockname(static_cast<NativeSocket>(socketDescriptor),
+                    reinterpret_cast<sockaddr *>(&local), &localLength) != 0) {
+        return false;
+    }
+
+    bool isV4 = false;
+    const quint32 v4 = address.toIPv4Address(&isV4);
+    if (local.ss_family == AF_INET) {
+        if (!isV4) return false;
+        sockaddr_in *dest = reinterpret_cast<sockaddr_in *>(m_storage);
+        dest->sin_family = AF_INET;
+        dest->sin_port = htons(port);
+        dest->sin_addr.s_addr = htonl(v4);
+        m_length = sizeof(sockaddr_in);
+    } else if (local.ss_family == AF_INET6) {
+        Q_IPV6ADDR v6 = address.toIPv6Address();
+        if (isV4) {
+            // ::ffff:a.b.c.d
+            std::memset(v6.c, 0, 10);
+            v6.c[10] = 0xff;
+            v6.c[11] = 0xff;
+            v6.c[12] = static_cast<quint8>(v4 >> 24);
+            v6.c[13] = static_cast<quint8>(v4 >> 16);
+            v6.c[14] = static_cast<quint8>(v4 >> 8);
+            v6.c[15] = static_cast<quint8>(v4);
+        }
+        sockaddr_in6 *dest = reinterpret_cast<sockaddr_in6 *>(m_storage);
+        dest->sin6_family = AF_INET6;
+        dest->sin6_port = htons(port);
+        std::memcpy(&dest->sin6_addr, v6.c, sizeof(v6.c));
+        m_length = sizeof(sockaddr_in6);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+UdpDestination::SendResult UdpDestination::send(qintptr socketDescriptor, const char *data, qsizetype size) const {
+#ifdef Q_OS_WIN
+    const int sent = ::sendto(static_cast<NativeSocket>(socketDescriptor), data, static_cast<int>(size), 0,
+                              reinterpret_cast<const sockaddr *>(m_storage), m_length);
+    if (sent >= 0) return SendResult::Sent;
+    const int error = WSAGetLastError();
+    return (error == WSAEWOULDBLOCK || error == WSAENOBUFS) ? SendResult::WouldBlock : SendResult::Failed;
+#else
+    const ssize_t sent = ::sendto(static_cast<NativeSocket>(socketDescriptor), data, static_cast<size_t>(size), 0,
+                                  reinterpret_cast<const sockaddr *>(m_storage), static_cast<socklen_t>(m_length));
+    if (sent >= 0) return SendResult::Sent;
+    // 发送缓冲满时非阻塞套接字返回 EAGAIN，Linux 在网卡队列满时也可能返回 ENOBUFS
+    return (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS || errno == EINTR)
+            ? SendResult::WouldBlock : SendResult::Failed;
+#endif
+}
+
+qsizetype UdpDestination::sendBatch(qintptr socketDescriptor, const char *data, qsizetype size, int segmentSize) const {
+    if (segmentSize <= 0) return -1;
+    qsizetype sent = 0;
+
+#ifdef Q_OS_LINUX
+    const int fd = static_cast<NativeSocket>(socketDescriptor);
+    while (sent < size) {
+        const qsizetype remaining = size - sent;
+
+        if (m_gsoEnabled && remaining > segmentSize && segmentSize <= kMaxGsoBytes / 2) {
+            // 一次交给内核整段数据，由协议栈 (或网卡) 切成 segmentSize 大小的数据报
+            const qsizetype maxSegments = qMin<qsizetype>(kMaxBatchDatagrams, kMaxGsoBytes / segmentSize);
+            const qsizetype length = qMin(remaining, maxSegments * segmentSize);
+
+            iovec iov;
+            iov.iov_base = const_cast<char *>(data + sent);
+            iov.iov_len = static_cast<size_t>(length);
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(quint16))] = {};
+            msghdr msg{};
+            msg.msg_name = const_cast<unsigned char *>(m_storage);
+            msg.msg_namelen = static_cast<socklen_t>(m_length);
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1;
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(quint16));
+            const quint16 gsoSize = static_cast<quint16>(segmentSize);
+            std::memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(gsoSize));
+
+            if (::sendmsg(fd, &msg, 0) >= 0) {
+                sent += length;
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) break;
+            if (errno != EINTR) {
+                // 内核过旧或网卡路径不支持，之后改用 sendmmsg
+                qDebug("[UdpDestination] UDP GSO unavailable (%s), falling back to sendmmsg", std::strerror(errno));
+                m_gsoEnabled = false;
+            }
+            continue;
+        }
+
+        mmsghdr msgs[kMaxBatchDatagrams];
+        iovec iovecs[kMaxBatchDatagrams];
+        int count = 0;
+        for (qsizetype offset = sent; offset < size && count < kMaxBatchDatagrams; offset += segmentSize, ++count) {
+            iovecs[count].iov_base = const_cast<char *>(data + offset);
+            iovecs[count].iov_len = static_cast<size_t>(qMin<qsizetype>(segmentSize, size - offset));
+            std::memset(&msgs[count], 0, sizeof(mmsghdr));
+            msgs[count].msg_hdr.msg_name = const_cast<unsigned char *>(m_storage);
+            msgs[count].msg_hdr.msg_namelen = static_cast<socklen_t>(m_length);
+            msgs[count].msg_hdr.msg_iov = &iovecs[count];
+            msgs[count].msg_hdr.msg_iovlen = 1;
+        }
+
+        const int result = ::sendmmsg(fd, msgs, static_cast<unsigned int>(count), 0);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS) break;
+            return sent > 0 ? sent : -1;
+        }
+        for (int i = 0; i < result; ++i) {
+            sent += static_cast<qsizetype>(iovecs[i].iov_len);
+        }
+        if (result < count) break; // 发送缓冲已满
+    }
+#else
+    while (sent < size) {
+        const qsizetype length = qMin<qsizetype>(segmentSize, size - sent);
+        const SendResult result = send(socketDescriptor, data + sent, length);
+        if (result == SendResult::WouldBlock) break;
+        if (result == SendResult::Failed) return sent > 0 ? sent : -1;
+        sent += length;
+    }
+#endif
+    return sent;
+}
+
+QString UdpDestination::lastErrorString() {
+#ifdef Q_OS_WIN
+    return QString("WSA error %1").arg(WSAGetLastError());
+#else
+    return QString::fromLocal8Bit(std::strerror(errno));
+#endif
+}
@@ -0,0 +1,36 @@
+#ifndef UDPDESTINATION_H
+#define UDPDESTINATION_H
+
+#include <QtGlobal>
+#include <QString>
+
+// 预先解析好的 UDP 目标地址。按套接字实际的地址族构造 sockaddr
+// (双栈 IPv6 套接字发往 IPv4 目标时使用 v4 映射地址)，发送循环中不再做任何解析和分配。
+// 只依赖原生套接字描述符，可以在任意线程中使用。
+class UdpDestination {
+public:
+    enum class SendResult { Sent, WouldBlock, Failed };
+
+    UdpDestination();
+
+    bool resolve(qintptr socketDescriptor, const QString &host, quint16 port);
+    bool isValid() const { return m_length > 0; }
+
+    SendResult send(qintptr socketDescriptor, const char *data, qsizetype size) const;
+
+    // 把 data 按 segmentSize 切成多个数据报 (最后一个可以较短) 发往同一目标。
+    // Linux 上优先用 UDP_SEGMENT (GSO) 一次系统调用交给内核切分，不支持时退回 sendmmsg；
+    // 其他平台逐个 sendto。返回已发出的字节数 (按数据报对齐，小于 size 表示发送缓冲已满)，
+    // 一个都没发出且出错时返回 -1
+    qsizetype sendBatch(qintptr socketDescriptor, const char *data, qsizetype size, int segmentSize) const;
+
+    // 最近一次套接字调用失败的系统错误描述
+    static QString lastErrorString();
+
+private:
+    alignas(8) unsigned char m_storage[128]; // 足够容纳 sockaddr_storage
+    int m_length;
+    mutable bool m_gsoEnabled; // 内核或网卡不支持 GSO 时关闭，之后只用 sendmmsg
+};
+
+#endif // UDPDESTINATION_H
@@ -0,0 +1,71 @@
+#ifndef VIDEOPACKETHEADER_H
+#define VIDEOPACKETHEADER_H
+
+#include <QtGlobal>
+#include <cstring>
+
+// 分包视频协议的数据报头。每个 UDP 数据报携带一帧中的一段像素，
+// 接收端按 offset 直接放到帧缓冲中，不再需要搜索帧头。
+//
+// 格式 (24 字节，大端):
+//   F1 5A | 版本(1) 标志(1) | 帧号(4) | 包序号(2) 包总数(2) | 像素偏移(4)
+//   | 宽(2) 高(2) | 状态(3) | 保留(1) | RGB565 像素 (大端)
+struct VideoPacketHeader {
+    static constexpr qsizetype kSize = 24;
+    static constexpr uchar kMagic0 = 0xF1;
+    static constexpr uchar kMagic1 = 0x5A;
+    static constexpr uchar kVersion = 1;
+
+    quint8 flags = 0;
+    quint32 frameId = 0;
+    quint16 packetIndex = 0;
+    quint16 packetCount = 0;
+    quint32 offset = 0;        // 本包像素数据在整帧中的字节偏移
+    quint16 width = 0;
+    quint16 height = 0;
+    uchar status[3] = { 0, 0, 0 };
+
+    // 解析 data 开头的报头，魔数或版本不符时返回 false
+    static bool parse(const uchar *data, qsizetype size, VideoPacketHeader *header) {
+        if (size < kSize || data[0] != kMagic0 || data[1] != kMagic1 || data[2] != kVersion) {
+            return false;
+        }
+        header->flags = data[3];
+        header->frameId = (quint32(data[4]) << 24) | (quint32(data[5]) << 16) | (quint32(data[6]) << 8) | data[7];
+        header->packetIndex = quint16((data[8] << 8) | data[9]);
+        header->packetCount = quint16((data[10] << 8) | data[11]);
+        header->offset = (quint32(data[12]) << 24) | (quint32(data[13]) << 16) | (quint32(data[14]) << 8) | data[15];
+        header->width = quint16((data[16] << 8) | data[17]);
+        header->height = quint16((data[18] << 8) | data[19]);
+        std::memcpy(header->status, data + 20, 3);
+        return true;
+    }
+
+    // 写入 kSize 字节的报头
+    void write(uchar *out) const {
+        out[0] = kMagic0;
+        out[1] = kMagic1;
+        out[2] = kVersion;
+        out[3] = flags;
+        out[4] = uchar(frameId >> 24);
+        out[5] = uchar(frameId >> 16);
+        out[6] = uchar(frameId >> 8);
+        out[7] = uchar(frameId);
+        out[8] = uchar(packetIndex >> 8);
+        out[9] = uchar(packetIndex);
+        out[10] = uchar(packetCount >> 8);
+        out[11] = uchar(packetCount);
+        out[12] = uchar(offset >> 24);
+        out[13] = uchar(offset >> 16);
+        out[14] = uchar(offset >> 8);
+        out[15] = uchar(offset);
+        out[16] = uchar(width >> 8);
+        out[17] = uchar(width);
+        out[18] = uchar(height >> 8);
+        out[19] = uchar(height);
+        std::memcpy(out + 20, status, 3);
+        out[23] = 0;
+    }
+};
+
+#endif // VIDEOPACKETHEADER_H
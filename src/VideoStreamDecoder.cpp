@@ -0,0 +1,520 @@
+#include "VideoStreamDecoder.h"
+#include "Rgb565Kernels.h"
+#include "VideoPacketHeader.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <cstring>
+#include <utility>
+
+namespace {
+const uchar kFrameHeader[4] = { 0xF0, 0x5A, 0xA5, 0x0F };
+constexpr qsizetype kMetaSize = 9;                 // 宽(2) + 高(2) + 状态头(5)
+constexpr qsizetype kRingCapacity = 256 * 1024;    // 远大于单个UDP数据报
+// 分包模式下帧号倒退的重新同步条件：连续这么多个包都迟到，或一次倒退超过这么多帧。
+// 正常的乱序只会零星迟到几个包，也不会倒退出重排窗口太远
+constexpr int kResyncLatePackets = 64;
+constexpr quint32 kResyncBackwardFrames = 64;
+
+// 帧号按 32 位回绕比较
+bool isNewerFrame(quint32 a, quint32 b) {
+    return static_cast<qint32>(a - b) > 0;
+}
+}
+
+VideoStreamDecoder::VideoStreamDecoder(QObject *parent)
+    : QObject(parent)
+    , m_ring(kRingCapacity)
+    , m_outputFormat(QImage::Format_RGB32)
+    , m_state(ParseState::SearchHeader)
+    , m_headerMatch(0)
+    , m_width(0)
+    , m_height(0)
+    , m_payloadFill(0)
+    , m_pendingFrames(0)
+    , m_packetized(false)
+    , m_haveLastFrame(false)
+    , m_lastFrameId(0)
+    , m_consecutiveLate(0)
+    , m_lastWidth(0)
+    , m_lastHeight(0)
+{
+    for (std::atomic<quint64> &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+VideoStreamDecoder::~VideoStreamDecoder() {
+}
+
+void VideoStreamDecoder::appendData(const QByteArray &data) {
+    if (m_packetized) {
+        processPacket(data);
+        return;
+    }
+
+    const char *src = data.constData();
+    qsizetype remaining = data.size();
+    // 每轮解析都会把环形缓冲区消费到只剩不足一个元数据头，因此总能写完
+    while (remaining > 0) {
+        const qsizetype written = m_ring.write(src, remaining);
+        src += written;
+        remaining -= written;
+        processVideoFrameBuffer();
+    }
+}
+
+void VideoStreamDecoder::reset() {
+    m_ring.clear();
+    m_state = ParseState::SearchHeader;
+    m_headerMatch = 0;
+    m_payloadFill = 0;
+
+    for (FrameSlot &slot : m_slots) {
+        slot.active = false;
+    }
+    m_haveLastFrame = false;
+    m_consecutiveLate = 0;
+    m_lastPayload.clear();
+    for (std::atomic<quint64> &counter : m_counters) {
+        counter.store(0, std::memory_order_relaxed);
+    }
+
+    QMutexLocker locker(&m_latestMutex);
+    m_latestImage = QImage();
+    m_latestStatus.clear();
+    m_pendingFrames = 0;
+}
+
+int VideoStreamDecoder::takeLatestFrame(QImage *image, QByteArray *statusBytes) {
+    QMutexLocker locker(&m_latestMutex);
+    const int frames = m_pendingFrames;
+    if (frames > 0) {
+        *image = std::move(m_latestImage);
+        *statusBytes = std::move(m_latestStatus);
+        m_latestImage = QImage();
+        m_latestStatus.clear();
+        m_pendingFrames = 0;
+    }
+    return frames;
+}
+
+void VideoStreamDecoder::bump(Counter counter, quint64 amount) {
+    m_counters[counter].fetch_add(amount, std::memory_order_relaxed);
+}
+
+VideoStreamDecoder::Stats VideoStreamDecoder::stats() const {
+    auto value = [this](Counter counter) { return m_counters[counter].load(std::memory_order_relaxed); };
+    Stats stats;
+    stats.discardedBytes = value(DiscardedBytes);
+    stats.invalidHeaders = value(InvalidHeaders);
+    stats.corruptedFrames = value(CorruptedFrames);
+    stats.packets = value(Packets);
+    stats.lostPackets = value(LostPackets);
+    stats.latePackets = value(LatePackets);
+    stats.frameResyncs = value(FrameResyncs);
+    stats.duplicatePackets = value(DuplicatePackets);
+    stats.invalidPackets = value(InvalidPackets);
+    stats.partialFrames = value(PartialFrames);
+    stats.skippedFrames = value(SkippedFrames);
+    stats.completedFrames = value(CompletedFrames);
+    stats.decodedFrames = value(DecodedFrames);
+    stats.decodeTimeNs = value(DecodeTimeNs);
+    stats.maxDecodeTimeNs = value(MaxDecodeTimeNs);
+    return stats;
+}
+
+void VideoStreamDecoder::setPacketizedMode(bool enabled) {
+    if (m_packetized == enabled) return;
+    m_packetized = enabled;
+    reset();
+}
+
+void VideoStreamDecoder::publishFrame(const QImage &image, const QByteArray &statusBytes) {
+    bool wasEmpty = false;
+    {
+        QMutexLocker locker(&m_latestMutex);
+        wasEmpty = (m_pendingFrames == 0);
+        m_latestImage = image;
+        m_latestStatus = statusBytes;
+        ++m_pendingFrames;
+    }
+    // 信箱里已有未取走的帧时，上一次的通知还在排队，无需重复发送
+    if (wasEmpty) {
+        emit frameReady();
+    }
+}
+
+void VideoStreamDecoder::setOutputFormat(QImage::Format format) {
+    switch (format) {
+        case QImage::Format_RGB16:
+        case QImage::Format_RGB32:
+        case QImage::Format_ARGB32_Premultiplied:
+            m_outputFormat = format;
+            break;
+        default:
+            qWarning() << "[Video] 不支持的输出格式" << format << "，使用 RGB32";
+            m_outputFormat = QImage::Format_RGB32;
+            break;
+    }
+}
+
+void VideoStreamDecoder::processVideoFrameBuffer() {
+    // 循环推进状态机，直到缓冲区中的数据不足以继续
+    while (true) {
+        bool progressed = false;
+        switch (m_state) {
+            case ParseState::SearchHeader: progressed = searchHeader(); break;
+            case ParseState::ReadMeta:     progressed = readMeta();     break;
+            case ParseState::ReadPayload:  progressed = readPayload();  break;
+        }
+        if (!progressed) {
+            return;
+        }
+    }
+}
+
+// 在 data 中继续匹配帧头，返回帧头最后一个字节之后的偏移；未找到返回 -1。
+// 匹配进度保存在 m_headerMatch 中，因此跨越数据报边界的帧头也能识别。
+qsizetype VideoStreamDecoder::scanForHeader(const uchar *data, qsizetype len) {
+    qsizetype i = 0;
+    while (i < len) {
+        if (m_headerMatch == 0) {
+            const void *hit = std::memchr(data + i, kFrameHeader[0], static_cast<size_t>(len - i));
+            if (!hit) {
+                return -1;
+            }
+            i = static_cast<const uchar *>(hit) - data + 1;
+            m_headerMatch = 1;
+            continue;
+        }
+        if (data[i] == kFrameHeader[m_headerMatch]) {
+            ++i;
+            if (++m_headerMatch == 4) {
+                m_headerMatch = 0;
+                return i;
+            }
+        } else {
+            // 帧头首字节不在其余位置出现，回到起点重新检查当前字节即可
+            m_headerMatch = 0;
+        }
+    }
+    return -1;
+}
+
+// --- 步骤 1: 寻找并对齐帧头，帧头前的所有无效数据直接丢弃 ---
+bool VideoStreamDecoder::searchHeader() {
+    while (!m_ring.isEmpty()) {
+        qsizetype len = 0;
+        const uchar *data = reinterpret_cast<const uchar *>(m_ring.readPointer(&len));
+        const qsizetype end = scanForHeader(data, len);
+        if (end < 0) {
+            m_ring.skip(len);
+            bump(DiscardedBytes, static_cast<quint64>(len));
+            continue;
+        }
+        m_ring.skip(end);
+        // 帧头本身的 4 个字节不算丢弃 (跨块的帧头前半部分已在上一轮计入，这里一并扣除)
+        bump(DiscardedBytes, static_cast<quint64>(end));
+        m_counters[DiscardedBytes].fetch_sub(4, std::memory_order_relaxed);
+        m_state = ParseState::ReadMeta;
+        return true;
+    }
+    return false;
+}
+
+// --- 步骤 2/3: 解析并验证分辨率和状态头 ---
+bool VideoStreamDecoder::readMeta() {
+    if (m_ring.size() < kMetaSize) {
+        // 数据不足以解析出宽度、高度和状态，退出等待
+        return false;
+    }
+
+    uchar meta[kMetaSize];
+    m_ring.peek(reinterpret_cast<char *>(meta), kMetaSize);
+    const quint16 width  = (meta[0] << 8) | meta[1];
+    const quint16 height = (meta[2] << 8) | meta[3];
+
+    // 校验失败时不消费这 9 个字节，回到帧头搜索状态从它们开始重新扫描
+    if (width == 0 || height == 0 || width > 4096 || height > 4096) {
+        // 分辨率数值无效，说明这个帧头是伪造的或已损坏
+        qDebug() << "[Video Sync Error] 解析到无效分辨率: " << width << "x" << height << ". 丢弃数据并寻找下一个帧头...";
+        bump(InvalidHeaders);
+        m_state = ParseState::SearchHeader;
+        return true;
+    }
+
+    // 检查状态头格式 FF ... FF
+    if (meta[4] != 0xFF || meta[8] != 0xFF) {
+        qDebug() << "[Video Sync Error] 状态头格式错误 (FF ... FF). 丢弃数据并寻找下一个帧头...";
+        bump(InvalidHeaders);
+        m_state = ParseState::SearchHeader;
+        return true;
+    }
+
+    m_ring.skip(kMetaSize);
+    m_width = width;
+    m_height = height;
+    m_statusBytes = QByteArray(reinterpret_cast<const char *>(meta + 5), 3);
+
+    // 分辨率不变时 resize 不会重新分配内存
+    m_payload.resize(static_cast<qsizetype>(width) * height * 2);
+    m_payloadFill = 0;
+    m_headerMatch = 0;
+    m_state = ParseState::ReadPayload;
+    return true;
+}
+
+// --- 步骤 4/5: 接收像素数据，同时检查帧内部是否混入下一个帧头 ---
+bool VideoStreamDecoder::readPayload() {
+    while (m_payloadFill < m_payload.size()) {
+        if (m_ring.isEmpty()) {
+            // 缓冲区的数据还不够一整帧，退出等待
+            return false;
+        }
+
+        qsizetype len = 0;
+        const uchar *data = reinterpret_cast<const uchar *>(m_ring.readPointer(&len));
+        len = qMin(len, m_payload.size() - m_payloadFill);
+
+        const qsizetype headerEnd = scanForHeader(data, len);
+        if (headerEnd >= 0) {
+            // 在当前帧结束前就出现了下一个帧头，说明当前帧因丢包而损坏
+            qDebug() << "[Video Sync] 检测到损坏的帧，正在重新同步...";
+            bump(CorruptedFrames);
+            bump(DiscardedBytes, static_cast<quint64>(m_payloadFill + qMax<qsizetype>(headerEnd - 4, 0)));
+            m_ring.skip(headerEnd); // 丢弃损坏帧的数据，直接从新帧头之后继续
+            m_state = ParseState::ReadMeta;
+            return true;
+        }
+
+        std::memcpy(m_payload.data() + m_payloadFill, data, static_cast<size_t>(len));
+        m_ring.skip(len);
+        m_payloadFill += len;
+    }
+
+    // 帧尾可能是下一个帧头的前半部分 (例如 ... F0 5A | A5 0F)，需要看到后续字节才能判断
+    if (m_headerMatch > 0) {
+        const qsizetype needed = 4 - m_headerMatch;
+        if (m_ring.size() < needed) {
+            return false;
+        }
+        uchar tail[3];
+        m_ring.peek(reinterpret_cast<char *>(tail), needed);
+        if (std::memcmp(tail, kFrameHeader + m_headerMatch, static_cast<size_t>(needed)) == 0) {
+            qDebug() << "[Video Sync] 检测到损坏的帧，正在重新同步...";
+            bump(CorruptedFrames);
+            bump(DiscardedBytes, static_cast<quint64>(m_payloadFill - m_headerMatch));
+            m_ring.skip(needed);
+            m_headerMatch = 0;
+            m_state = ParseState::ReadMeta;
+            return true;
+        }
+        m_headerMatch = 0;
+    }
+
+    bump(CompletedFrames);
+    decodeFrame(m_payload, m_width, m_height, m_statusBytes);
+    m_state = ParseState::SearchHeader;
+    return true;
+}
+
+// --- 所有检查通过，解码图像 ---
+void VideoStreamDecoder::decodeFrame(const QByteArray &payload, quint16 width, quint16 height,
+                                     const QByteArray &statusBytes) {
+    QElapsedTimer timer;
+    timer.start();
+
+    // 直接写入 QImage 自己的内存，生成的图像不引用缓冲区，可以安全地跨线程传递
+    QImage image(width, height, m_outputFormat);
+    if (image.isNull()) {
+        qDebug() << "[Video ERROR] QImage无法从数据加载。";
+        return;
+    }
+
+    const uchar *src = reinterpret_cast<const uchar *>(payload.constData());
+    const qsizetype srcStride = static_cast<qsizetype>(width) * 2;
+    const qsizetype pixelCount = static_cast<qsizetype>(width) * height;
+
+    if (m_outputFormat == QImage::Format_RGB16) {
+        // 修正字节序；奇数宽度时 QImage 行尾有填充，需要逐行处理
+        if (image.bytesPerLine() == srcStride) {
+            Rgb565Kernels::swapBytes(src, image.bits(), pixelCount);
+        } else {
+            for (int y = 0; y < height; ++y) {
+                Rgb565Kernels::swapBytes(src + y * srcStride, image.scanLine(y), width);
+            }
+        }
+    } else {
+        // 32 位格式每行恰好 width*4 字节，整帧一次转换
+        Rgb565Kernels::convertBigEndianToRgb32(src, reinterpret_cast<quint32 *>(image.bits()), pixelCount);
+    }
+
+    // 连同状态码一起放入信箱，交给 UI 线程显示和检查
+    publishFrame(image, statusBytes);
+
+    const quint64 elapsedNs = static_cast<quint64>(timer.nsecsElapsed());
+    bump(DecodedFrames);
+    bump(DecodeTimeNs, elapsedNs);
+    // 只有解码线程写入，读后写不会丢失更新
+    if (elapsedNs > m_counters[MaxDecodeTimeNs].load(std::memory_order_relaxed)) {
+        m_counters[MaxDecodeTimeNs].store(elapsedNs, std::memory_order_relaxed);
+    }
+}
+
+// ===================================================================
+//  分包模式
+// ===================================================================
+void VideoStreamDecoder::processPacket(const QByteArray &datagram) {
+    const uchar *data = reinterpret_cast<const uchar *>(datagram.constData());
+    VideoPacketHeader header;
+    if (!VideoPacketHeader::parse(data, datagram.size(), &header)) {
+        bump(InvalidPackets);
+        return;
+    }
+
+    const qsizetype frameBytes = static_cast<qsizetype>(header.width) * header.height * 2;
+    const qsizetype length = datagram.size() - VideoPacketHeader::kSize;
+    if (header.width == 0 || header.height == 0 || header.width > 4096 || header.height > 4096
+            || header.packetCount == 0 || header.packetIndex >= header.packetCount
+            || static_cast<qsizetype>(header.offset) + length > frameBytes) {
+        bump(InvalidPackets);
+        return;
+    }
+    if (m_haveLastFrame && !isNewerFrame(header.frameId, m_lastFrameId) && !handleLatePacket(header.frameId)) {
+        return;
+    }
+
+    FrameSlot *slot = slotForFrame(header.frameId);
+    if (!slot) {
+        if (!handleLatePacket(header.frameId)) return;
+        slot = slotForFrame(header.frameId); // 重新同步后所有槽都已空闲
+    }
+    m_consecutiveLate = 0;
+    if (!slot->active) {
+        slot->active = true;
+        slot->frameId = header.frameId;
+        slot->width = header.width;
+        slot->height = header.height;
+        slot->statusBytes = QByteArray(reinterpret_cast<const char *>(header.status), 3);
+        slot->payload.resize(frameBytes); // 尺寸不变时不会重新分配
+        slot->packetCount = header.packetCount;
+        slot->receivedPackets = 0;
+        slot->segmentSize = 0;
+        slot->receivedMask.assign((header.packetCount + 63) / 64, 0);
+    } else if (slot->width != header.width || slot->height != header.height
+               || slot->packetCount != header.packetCount) {
+        // 同一帧号的包描述了不同的帧，发送端出错
+        bump(InvalidPackets);
+        return;
+    }
+
+    quint64 &word = slot->receivedMask[header.packetIndex / 64];
+    const quint64 bit = quint64(1) << (header.packetIndex % 64);
+    if (word & bit) {
+        bump(DuplicatePackets);
+        return;
+    }
+    word |= bit;
+    bump(Packets);
+
+    std::memcpy(slot->payload.data() + header.offset, data + VideoPacketHeader::kSize, static_cast<size_t>(length));
+    if (header.packetIndex + 1 < header.packetCount && slot->segmentSize == 0) {
+        slot->segmentSize = length;
+    }
+    if (++slot->receivedPackets == slot->packetCount) {
+        completeSlot(slot);
+    }
+}
+
+// 返回该帧已有的槽；没有时分配一个空槽，窗口已满则先把最旧的帧补齐显示。
+// 包所属的帧比窗口中所有帧都旧时返回 nullptr
+VideoStreamDecoder::FrameSlot *VideoStreamDecoder::slotForFrame(quint32 frameId) {
+    FrameSlot *freeSlot = nullptr;
+    FrameSlot *oldest = nullptr;
+    for (FrameSlot &slot : m_slots) {
+        if (!slot.active) {
+            if (!freeSlot) freeSlot = &slot;
+            continue;
+        }
+        if (slot.frameId == frameId) return &slot;
+        if (!oldest || isNewerFrame(oldest->frameId, slot.frameId)) oldest = &slot;
+    }
+    if (freeSlot) return freeSlot;
+    // 比窗口中所有帧都旧的包来得太晚，腾出位置也只会让画面倒退
+    if (isNewerFrame(oldest->frameId, frameId)) return nullptr;
+
+    concealAndPublish(oldest);
+    return oldest;
+}
+
+void VideoStreamDecoder::completeSlot(FrameSlot *slot) {
+    // 比它旧的未完成帧已经没有显示的意义，记为丢包后放弃
+    for (FrameSlot &other : m_slots) {
+        if (other.active && &other != slot && isNewerFrame(slot->frameId, other.frameId)) {
+            bump(LostPackets, static_cast<quint64>(other.packetCount - other.receivedPackets));
+            bump(SkippedFrames);
+            other.active = false;
+        }
+    }
+    bump(CompletedFrames);
+    decodeFrame(slot->payload, slot->width, slot->height, slot->statusBytes);
+    releaseSlot(slot);
+}
+
+void VideoStreamDecoder::concealAndPublish(FrameSlot *slot) {
+    bump(LostPackets, static_cast<quint64>(slot->packetCount - slot->receivedPackets));
+    bump(PartialFrames);
+
+    // 缺失的包用上一帧同一位置的像素补齐；还没有可用的上一帧时保留槽中的旧数据
+    const bool canConceal = slot->segmentSize > 0 && m_lastWidth == slot->width && m_lastHeight == slot->height
+            && m_lastPayload.size() == slot->payload.size();
+    if (canConceal) {
+        const qsizetype frameBytes = slot->payload.size();
+        for (int index = 0; index < slot->packetCount; ++index) {
+            if (slot->receivedMask[index / 64] & (quint64(1) << (index % 64))) continue;
+            const qsizetype begin = static_cast<qsizetype>(index) * slot->segmentSize;
+            if (begin >= frameBytes) break;
+            const qsizetype end = (index + 1 == slot->packetCount) ? frameBytes : qMin(begin + slot->segmentSize, frameBytes);
+            std::memcpy(slot->payload.data() + begin, m_lastPayload.constData() + begin, static_cast<size_t>(end - begin));
+        }
+    }
+    decodeFrame(slot->payload, slot->width, slot->height, slot->statusBytes);
+    releaseSlot(slot);
+}
+
+// 帧号比已显示或正在组装的帧都旧。通常是乱序迟到的包，直接丢弃；但如果连续迟到太多，
+// 或者一次倒退太远 (发送端重启、帧号被重置)，继续丢弃会让画面永远停住：
+// 此时放弃所有组装状态，返回 true 让这个包作为新的起点
+bool VideoStreamDecoder::handleLatePacket(quint32 frameId) {
+    quint32 newestId = m_lastFrameId;
+    bool haveNewest = m_haveLastFrame;
+    for (const FrameSlot &slot : m_slots) {
+        if (slot.active && (!haveNewest || isNewerFrame(slot.frameId, newestId))) {
+            newestId = slot.frameId;
+            haveNewest = true;
+        }
+    }
+    const quint32 backwardFrames = newestId - frameId;
+    if (backwardFrames <= kResyncBackwardFrames && ++m_consecutiveLate < kResyncLatePackets) {
+        bump(LatePackets);
+        return false;
+    }
+
+    for (FrameSlot &slot : m_slots) {
+        slot.active = false;
+    }
+    m_haveLastFrame = false;
+    m_consecutiveLate = 0;
+    bump(FrameResyncs);
+    return true;
+}
+
+void VideoStreamDecoder::releaseSlot(FrameSlot *slot) {
+    m_haveLastFrame = true;
+    m_lastFrameId = slot->frameId;
+    m_lastWidth = slot->width;
+    m_lastHeight = slot->height;
+    // 交换缓冲区：刚显示的帧留作补齐用，槽复用上上帧的内存
+    m_lastPayload.swap(slot->payload);
+    slot->active = false;
+}
@@ -0,0 +1,150 @@
+#ifndef VIDEOSTREAMDECODER_H
+#define VIDEOSTREAMDECODER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QImage>
+#include <QMutex>
+#include <array>
+#include <atomic>
+#include <vector>
+#include "ByteRingBuffer.h"
+
+// UDP视频流解码器：在独立的工作线程中完成帧同步、校验和解码，
+// 只把解码完成的图像交回 UI 线程显示。
+//
+// 解码结果放在一个"最新帧"信箱中：UI 来不及显示时新帧直接覆盖旧帧，
+// 队列里永远不会积压图像，解码速度也不受绘制速度限制。
+//
+// 帧格式: F0 5A A5 0F | 宽(2) 高(2) | FF xx xx xx FF | RGB565 像素 (大端)
+//
+// 解析器是一个可续接的状态机：每个字节只被扫描一次，像素数据从环形缓冲区
+// 直接复制到预分配的帧缓冲中，不再对整条缓冲区反复 indexOf / remove。
+//
+// 分包模式 (见 VideoPacketHeader.h) 下每次 appendData 是一个完整的数据报，
+// 按报头中的偏移直接放入对应帧的缓冲区。最多同时组装 kReorderFrames 帧以容忍乱序；
+// 窗口溢出时最旧的未完成帧用上一帧的内容补齐缺失部分后照常显示，丢一个包不再丢一整帧。
+// 帧号连续迟到或大幅倒退 (发送端重启) 时放弃组装状态，从新的帧号重新开始。
+class VideoStreamDecoder : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int kReorderFrames = 4;
+
+    // 解码健康统计 (累计值)，可在任意线程读取
+    struct Stats {
+        // 字节流模式
+        quint64 discardedBytes = 0;   // 重新同步时丢弃的字节
+        quint64 invalidHeaders = 0;   // 分辨率或状态头无效的帧头
+        quint64 corruptedFrames = 0;  // 未收完就出现下一个帧头而放弃的帧
+        // 分包模式
+        quint64 packets = 0;          // 有效数据包
+        quint64 lostPackets = 0;      // 帧结束时仍未收到的包
+        quint64 latePackets = 0;      // 所属帧已经显示或放弃后才到达
+        quint64 frameResyncs = 0;     // 帧号倒退 (发送端重启等) 后丢弃组装状态、重新同步的次数
+        quint64 duplicatePackets = 0;
+        quint64 invalidPackets = 0;   // 报头或偏移无效
+        quint64 partialFrames = 0;    // 缺包但补齐后显示的帧
+        quint64 skippedFrames = 0;    // 被更新的完整帧越过、不再显示的帧
+        // 两种模式通用
+        quint64 completedFrames = 0;  // 数据完整的帧
+        quint64 decodedFrames = 0;    // 送入信箱的帧 (完整帧 + 补齐帧)
+        quint64 decodeTimeNs = 0;     // 累计解码耗时
+        quint64 maxDecodeTimeNs = 0;
+    };
+
+    explicit VideoStreamDecoder(QObject *parent = nullptr);
+    ~VideoStreamDecoder() override;
+
+    // 线程安全：取出信箱中的最新帧，返回自上次取帧以来解码完成的帧数 (0 表示没有新帧)
+    int takeLatestFrame(QImage *image, QByteArray *statusBytes);
+    Stats stats() const;
+
+public slots:
+    void appendData(const QByteArray &data);
+    void reset(); // 丢弃所有已接收但未处理的数据
+    // 切换到分包协议 (每个数据报带帧号/包序号/偏移)，会丢弃尚未处理的数据
+    void setPacketizedMode(bool enabled);
+    // 输出格式：Format_RGB16 只做字节交换；Format_RGB32 / Format_ARGB32_Premultiplied
+    // 一次完成字节交换和像素扩展，UI 线程绘制时无需再转换
+    void setOutputFormat(QImage::Format format);
+
+signals:
+    // 信箱由空变为非空时发出一次，接收方应调用 takeLatestFrame() 取帧
+    void frameReady();
+
+private:
+    enum class ParseState {
+        SearchHeader, // 寻找 F0 5A A5 0F
+        ReadMeta,     // 等待并校验 宽/高/状态头 (9 字节)
+        ReadPayload   // 接收像素数据
+    };
+
+    void processVideoFrameBuffer();
+    bool searchHeader();
+    bool readMeta();
+    bool readPayload();
+    qsizetype scanForHeader(const uchar *data, qsizetype len);
+    void decodeFrame(const QByteArray &payload, quint16 width, quint16 height, const QByteArray &statusBytes);
+    void publishFrame(const QImage &image, const QByteArray &statusBytes);
+
+    // 分包模式
+    struct FrameSlot {
+        bool active = false;
+        quint32 frameId = 0;
+        quint16 width = 0;
+        quint16 height = 0;
+        QByteArray statusBytes;
+        QByteArray payload;
+        std::vector<quint64> receivedMask; // 按包序号的到达位图
+        int packetCount = 0;
+        int receivedPackets = 0;
+        qsizetype segmentSize = 0;         // 非末尾包的长度，用于推算缺失包的位置
+    };
+    void processPacket(const QByteArray &datagram);
+    FrameSlot *slotForFrame(quint32 frameId);
+    void completeSlot(FrameSlot *slot);
+    void concealAndPublish(FrameSlot *slot);
+    void releaseSlot(FrameSlot *slot);
+    bool handleLatePacket(quint32 frameId);
+
+private:
+    ByteRingBuffer m_ring;
+    QImage::Format m_outputFormat;
+    ParseState m_state;
+    int m_headerMatch;          // 已匹配的帧头字节数，跨数据报保持
+
+    quint16 m_width;
+    quint16 m_height;
+    QByteArray m_statusBytes;
+    QByteArray m_payload;       // 当前帧的像素数据，按帧大小预分配
+    qsizetype m_payloadFill;
+
+    // 最新帧信箱，由 m_latestMutex 保护
+    QMutex m_latestMutex;
+    QImage m_latestImage;
+    QByteArray m_latestStatus;  // 状态头中间的 3 个字节
+    int m_pendingFrames;        // 信箱中尚未被取走的解码帧数
+
+    // 分包模式状态，只在解码线程中访问
+    bool m_packetized;
+    std::array<FrameSlot, kReorderFrames> m_slots;
+    bool m_haveLastFrame;
+    quint32 m_lastFrameId;      // 最近显示或放弃的帧号，不比它新的包都算迟到
+    int m_consecutiveLate;      // 连续迟到的包数，收到可用的包时清零
+    QByteArray m_lastPayload;   // 最近显示的帧，用于补齐缺包
+    quint16 m_lastWidth;
+    quint16 m_lastHeight;
+
+    // 统计计数，解码线程写入，stats() 读取
+    enum Counter {
+        DiscardedBytes, InvalidHeaders, CorruptedFrames,
+        Packets, LostPackets, LatePackets, FrameResyncs, DuplicatePackets, InvalidPackets, PartialFrames, SkippedFrames,
+        CompletedFrames, DecodedFrames, DecodeTimeNs, MaxDecodeTimeNs,
+        CounterCount
+    };
+    void bump(Counter counter, quint64 amount = 1);
+    std::array<std::atomic<quint64>, CounterCount> m_counters;
+};
+
+#endif // VIDEOSTREAMDECODER_H
@@ -0,0 +1,306 @@
+#include "VideoStreamGenerator.h"
+#include "TokenBucket.h"
+#include "VideoPacketHeader.h"
+#include <QElapsedTimer>
+#include <QThread>
+#include <cstring>
+
+namespace {
+constexpr int kPatternFrames = 8;                     // 循环使用的图案帧数
+constexpr qsizetype kByteStreamHeaderSize = 13;       // F0 5A A5 0F | 宽 高 | FF xx xx xx FF
+constexpr int kMaxBatchPackets = 64;                  // 不限速时每次 sendBatch 的数据报数
+constexpr qint64 kSpinThresholdNs = 200000;           // 与 PacedUdpSender 相同的休眠/让出策略
+constexpr qint64 kMaxSleepUs = 50000;
+constexpr int kWouldBlockRetryUs = 50;
+
+// 斜向移动的彩条，逐帧平移，肉眼可以看出卡顿和撕裂
+quint16 patternPixel(int x, int y, int frame, int width, int height) {
+    const quint16 r = quint16(((x + frame * 16) * 32 / width) & 0x1F);
+    const quint16 g = quint16((y * 64 / height) & 0x3F);
+    const quint16 b = quint16(((x + y + frame * 8) >> 4) & 0x1F);
+    return quint16((r << 11) | (g << 5) | b);
+}
+}
+
+VideoStreamGenerator::VideoStreamGenerator(const Config &config, QObject *parent)
+    : QObject(parent)
+    , m_config(config)
+    , m_sequence(0)
+    , m_rng(config.seed)
+    , m_runToken(0)
+    , m_currentToken(0)
+    , m_frames(0)
+    , m_packets(0)
+    , m_bytes(0)
+    , m_droppedPackets(0)
+    , m_reorderedPackets(0)
+    , m_corruptedPackets(0)
+    , m_lateFrames(0)
+{
+}
+
+VideoStreamGenerator::~VideoStreamGenerator() {
+}
+
+quint64 VideoStreamGenerator::prepareRun() {
+    const quint64 token = m_runToken.fetch_add(1, std::memory_order_acq_rel) + 1;
+    QMutexLocker locker(&m_runMutex);
+    return token;
+}
+
+void VideoStreamGenerator::requestStop() {
+    m_runToken.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void VideoStreamGenerator::stopAndWait() {
+    requestStop();
+    QMutexLocker locker(&m_runMutex);
+}
+
+VideoStreamGenerator::Stats VideoStreamGenerator::stats() const {
+    Stats stats;
+    stats.frames = m_frames.load(std::memory_order_relaxed);
+    stats.packets = m_packets.load(std::memory_order_relaxed);
+    stats.bytes = m_bytes.load(std::memory_order_relaxed);
+    stats.droppedPackets = m_droppedPackets.load(std::memory_order_relaxed);
+    stats.reorderedPackets = m_reorderedPackets.load(std::memory_order_relaxed);
+    stats.corruptedPackets = m_corruptedPackets.load(std::memory_order_relaxed);
+    stats.lateFrames = m_lateFrames.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void VideoStreamGenerator::buildPatternFrames() {
+    const int width = m_config.width;
+    const int height = m_config.height;
+    m_patternFrames.clear();
+    for (int frame = 0; frame < kPatternFrames; ++frame) {
+        QByteArray pixels(qsizetype(width) * height * 2, Qt::Uninitialized);
+        uchar *out = reinterpret_cast<uchar *>(pixels.data());
+        for (int y = 0; y < height; ++y) {
+            for (int x = 0; x < width; ++x) {
+                const quint16 pixel = patternPixel(x, y, frame, width, height);
+                *out++ = uchar(pixel >> 8);
+                *out++ = uchar(pixel);
+            }
+        }
+        // 图案本身不应该拼出帧头，帧头只由损伤注入制造
+        for (char &byte : pixels) {
+            if (uchar(byte) == 0xF0) byte = char(0xF1);
+        }
+        m_patternFrames.push_back(pixels);
+    }
+}
+
+void VideoStreamGenerator::buildWireFrame(quint32 frameId) {
+    const QByteArray &pixels = m_patternFrames[frameId % m_patternFrames.size()];
+    const int width = m_config.width;
+    const int height = m_config.height;
+    m_wire.clear();
+    m_packetOffsets.clear();
+
+    if (!m_config.packetized) {
+        // 字节流：帧头紧接像素，整体按数据报长度切分，和板卡的连续发送一致
+        const uchar header[kByteStreamHeaderSize] = {
+            0xF0, 0x5A, 0xA5, 0x0F,
+            uchar(width >> 8), uchar(width), uchar(height >> 8), uchar(height),
+            0xFF, m_config.status[0], m_config.status[1], m_config.status[2], 0xFF };
+        m_wire.reserve(kByteStreamHeaderSize + pixels.size());
+        m_wire.append(reinterpret_cast<const char *>(header), kByteStreamHeaderSize);
+        m_wire.append(pixels);
+        for (qsizetype offset = 0; offset < m_wire.size(); offset += m_config.packetSize) {
+            m_packetOffsets.push_back(offset);
+        }
+    } else {
+        const qsizetype segment = m_config.packetSize;
+        const int packetCount = int((pixels.size() + segment - 1) / segment);
+        m_wire.reserve(pixels.size() + qsizetype(packetCount) * VideoPacketHeader::kSize);
+        VideoPacketHeader header;
+        header.frameId = frameId;
+        header.packetCount = quint16(packetCount);
+        header.width = quint16(width);
+        header.height = quint16(height);
+        std::memcpy(header.status, m_config.status, 3);
+        uchar headerBytes[VideoPacketHeader::kSize];
+        for (int packet = 0; packet < packetCount; ++packet) {
+            header.packetIndex = quint16(packet);
+            header.offset = quint32(qsizetype(packet) * segment);
+            header.write(headerBytes);
+            m_packetOffsets.push_back(m_wire.size());
+            m_wire.append(reinterpret_cast<const char *>(headerBytes), VideoPacketHeader::kSize);
+            m_wire.append(pixels.constData() + header.offset, qMin<qsizetype>(segment, pixels.size() - header.offset));
+        }
+    }
+    m_packetOffsets.push_back(m_wire.size());
+}
+
+void VideoStreamGenerator::waitUntil(qint64 deadlineNs, qint64 nowNs) {
+    const qint64 remainingNs = deadlineNs - nowNs;
+    if (remainingNs > kSpinThresholdNs) {
+        const qint64 sleepUs = qMin<qint64>((remainingNs - kSpinThresholdNs) / 1000, kMaxSleepUs);
+        QThread::usleep(static_cast<unsigned long>(qMax<qint64>(sleepUs, 1)));
+    } else {
+        QThread::yieldCurrentThread();
+    }
+}
+
+bool VideoStreamGenerator::sendPacket(qintptr socketDescriptor, const char *data, qsizetype size) {
+    while (!stopRequested()) {
+        switch (m_destination.send(socketDescriptor, data, size)) {
+        case UdpDestination::SendResult::Sent:
+            m_packets.fetch_add(1, std::memory_order_relaxed);
+            m_bytes.fetch_add(static_cast<quint64>(size), std::memory_order_relaxed);
+            return true;
+        case UdpDestination::SendResult::WouldBlock:
+            QThread::usleep(kWouldBlockRetryUs);
+            break;
+        case UdpDestination::SendResult::Failed:
+            return false;
+        }
+    }
+    return true;
+}
+
+// 对一个数据报依次判定丢弃、推迟和损坏；推迟的包在其后第 reorderDepth 个包处理完时补发
+bool VideoStreamGenerator::handlePacket(qintptr socketDescriptor, const char *data, qsizetype size) {
+    std::uniform_real_distribution<double> chance(0.0, 1.0);
+    ++m_sequence;
+    if (m_config.lossRate > 0 && chance(m_rng) < m_config.lossRate) {
+        m_droppedPackets.fetch_add(1, std::memory_order_relaxed);
+        return releaseDelayed(socketDescriptor, false);
+    }
+
+    QByteArray corrupted;
+    if (m_config.corruptRate > 0 && chance(m_rng) < m_config.corruptRate) {
+        corrupted = QByteArray(data, size);
+        const qsizetype position = std::uniform_int_distribution<qsizetype>(0, size - 1)(m_rng);
+        corrupted[position] = char(corrupted[position] ^ (1 << std::uniform_int_distribution<int>(0, 7)(m_rng)));
+        data = corrupted.constData();
+        m_corruptedPackets.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (m_config.reorderRate > 0 && chance(m_rng) < m_config.reorderRate) {
+        m_delayed.push_back({ m_sequence + static_cast<quint64>(m_config.reorderDepth),
+                              corrupted.isEmpty() ? QByteArray(data, size) : corrupted });
+        m_reorderedPackets.fetch_add(1, std::memory_order_relaxed);
+        return releaseDelayed(socketDescriptor, false);
+    }
+
+    return sendPacket(socketDescriptor, data, size) && releaseDelayed(socketDescriptor, false);
+}
+
+bool VideoStreamGenerator::releaseDelayed(qintptr socketDescriptor, bool all) {
+    for (auto it = m_delayed.begin(); it != m_delayed.end(); ) {
+        if (all || it->releaseAt <= m_sequence) {
+            if (!sendPacket(socketDescriptor, it->data.constData(), it->data.size())) return false;
+            it = m_delayed.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return true;
+}
+
+void VideoStreamGenerator::run(quint64 token, qintptr socketDescriptor, const QString &host, quint16 port) {
+    QMutexLocker locker(&m_runMutex);
+    m_currentToken = token;
+    if (stopRequested()) return; // 排队期间已被新的启动命令或退出取代
+
+    if (!m_destination.resolve(socketDescriptor, host, port)) {
+        emit finished(QString("无效的目标地址: %1:%2").arg(host).arg(port));
+        return;
+    }
+    if (m_patternFrames.empty()) {
+        buildPatternFrames();
+    }
+    m_delayed.clear();
+    m_sequence = 0;
+
+    const bool impaired = m_config.lossRate > 0 || m_config.reorderRate > 0 || m_config.corruptRate > 0;
+    const qsizetype packetBytes = m_config.packetized ? m_config.packetSize + VideoPacketHeader::kSize : m_config.packetSize;
+    const bool paced = m_config.rateMbps > 0;
+    const int burst = paced ? qMax(m_config.burstPackets, 1) : kMaxBatchPackets;
+    TokenBucket bucket;
+    if (paced) {
+        bucket.configure(m_config.rateMbps * 1e6 / 8.0, static_cast<double>(burst) * packetBytes);
+    }
+    const qint64 frameIntervalNs = m_config.fps > 0 ? static_cast<qint64>(1e9 / m_config.fps) : 0;
+
+    QElapsedTimer clock;
+    clock.start();
+    bucket.reset(0);
+    qint64 nextFrameNs = 0;
+    QString errorText;
+
+    for (quint32 frameId = 0; m_config.frameLimit <= 0 || frameId < m_config.frameLimit; ++frameId) {
+        qint64 nowNs = clock.nsecsElapsed();
+        while (nowNs < nextFrameNs && !stopRequested()) {
+            waitUntil(nextFrameNs, nowNs);
+            nowNs = clock.nsecsElapsed();
+        }
+        if (stopRequested()) break;
+
+        buildWireFrame(frameId);
+        const int packetCount = static_cast<int>(m_packetOffsets.size()) - 1;
+        for (int packet = 0; packet < packetCount && errorText.isEmpty(); ) {
+            if (stopRequested()) break;
+
+            // 令牌允许的连续若干个包作为一批
+            nowNs = clock.nsecsElapsed();
+            int batchEnd = packet;
+            qint64 waitNs = 0;
+            while (batchEnd < packetCount && batchEnd - packet < burst) {
+                const qsizetype length = m_packetOffsets[batchEnd + 1] - m_packetOffsets[batchEnd];
+                if (paced && (waitNs = bucket.reserve(static_cast<double>(length), nowNs)) > 0) break;
+                ++batchEnd;
+            }
+            if (batchEnd == packet) {
+                waitUntil(nowNs + waitNs, nowNs);
+                continue;
+            }
+
+            if (!impaired) {
+                // 除最后一个外所有数据报等长，可以整批交给 sendmmsg / GSO
+                const char *batch = m_wire.constData() + m_packetOffsets[packet];
+                const qsizetype batchBytes = m_packetOffsets[batchEnd] - m_packetOffsets[packet];
+                qsizetype batchSent = 0;
+                while (batchSent < batchBytes && !stopRequested()) {
+                    const qsizetype result = m_destination.sendBatch(socketDescriptor, batch + batchSent,
+                                                                     batchBytes - batchSent, static_cast<int>(packetBytes));
+                    if (result < 0) {
+                        errorText = "发送失败: " + UdpDestination::lastErrorString();
+                        break;
+                    }
+                    batchSent += result;
+                    if (batchSent < batchBytes) {
+                        QThread::usleep(kWouldBlockRetryUs);
+                    }
+                }
+                m_packets.fetch_add(static_cast<quint64>((batchSent + packetBytes - 1) / packetBytes), std::memory_order_relaxed);
+                m_bytes.fetch_add(static_cast<quint64>(batchSent), std::memory_order_relaxed);
+            } else {
+                for (int i = packet; i < batchEnd && errorText.isEmpty(); ++i) {
+                    if (!handlePacket(socketDescriptor, m_wire.constData() + m_packetOffsets[i],
+                                      m_packetOffsets[i + 1] - m_packetOffsets[i])) {
+                        errorText = "发送失败: " + UdpDestination::lastErrorString();
+                    }
+                }
+            }
+            packet = batchEnd;
+        }
+        if (!errorText.isEmpty() || stopRequested()) break;
+        m_frames.fetch_add(1, std::memory_order_relaxed);
+
+        // 落后超过一整帧时不再追赶，从当前时刻重新排期，避免背靠背地连发多帧
+        nextFrameNs += frameIntervalNs;
+        nowNs = clock.nsecsElapsed();
+        if (frameIntervalNs > 0 && nowNs > nextFrameNs) {
+            m_lateFrames.fetch_add(1, std::memory_order_relaxed);
+            if (nowNs > nextFrameNs + frameIntervalNs) nextFrameNs = nowNs;
+        }
+    }
+
+    if (errorText.isEmpty() && !releaseDelayed(socketDescriptor, true)) {
+        errorText = "发送失败: " + UdpDestination::lastErrorString();
+    }
+    emit finished(errorText);
+}
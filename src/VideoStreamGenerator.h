@@ -0,0 +1,102 @@
+#ifndef VIDEOSTREAMGENERATOR_H
+#define VIDEOSTREAMGENERATOR_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QMutex>
+#include <QString>
+#include <atomic>
+#include <random>
+#include <vector>
+#include "UdpDestination.h"
+
+// 模拟 FPGA 板卡的视频流发送工作者，运行在独立线程中。
+// 按固定帧率生成 RGB565 测试图案，以字节流格式 (F0 5A A5 0F | 宽 高 | FF xx xx xx FF | 像素)
+// 或分包协议 (VideoPacketHeader) 切成数据报发出，可选令牌桶限速，
+// 并按概率注入丢包、乱序 (延后若干个包再发) 和单字节损坏，用于在回环上压测解码和重同步。
+// 与 PacedUdpSender 一样直接在外部套接字上 sendto，调用方必须在关闭套接字前调用 stopAndWait()。
+class VideoStreamGenerator : public QObject {
+    Q_OBJECT
+
+public:
+    struct Config {
+        int width = 640;
+        int height = 480;
+        double fps = 30.0;
+        int packetSize = 1400;       // 字节流模式为整个数据报长度，分包模式为报头之后的像素长度
+        bool packetized = false;
+        double rateMbps = 0.0;       // 0 表示每帧开始时尽快发完
+        int burstPackets = 16;
+        double lossRate = 0.0;       // 以下三项为每个数据报的概率 (0 ~ 1)
+        double reorderRate = 0.0;
+        double corruptRate = 0.0;
+        int reorderDepth = 8;        // 乱序的包推迟到其后第几个包之后发出
+        quint32 seed = 1;
+        qint64 frameLimit = 0;       // 0 表示一直发送
+        uchar status[3] = { 0x00, 0x00, 0x01 };
+    };
+
+    struct Stats {
+        quint64 frames = 0;
+        quint64 packets = 0;         // 实际发出的数据报 (含乱序后补发的)
+        quint64 bytes = 0;
+        quint64 droppedPackets = 0;
+        quint64 reorderedPackets = 0;
+        quint64 corruptedPackets = 0;
+        quint64 lateFrames = 0;      // 没能在帧间隔内发完的帧
+    };
+
+    explicit VideoStreamGenerator(const Config &config, QObject *parent = nullptr);
+    ~VideoStreamGenerator() override;
+
+    // 可在任意线程调用。每次发送对应一个令牌，令牌失效即停止：
+    // prepareRun() 让当前 (以及已排队但未开始的) 发送失效并等它退出，返回新发送要用的令牌
+    quint64 prepareRun();
+    void requestStop();
+    void stopAndWait();
+    Stats stats() const;
+
+public slots:
+    void run(quint64 token, qintptr socketDescriptor, const QString &host, quint16 port);
+
+signals:
+    void finished(const QString &errorText);
+
+private:
+    struct DelayedPacket {
+        quint64 releaseAt;           // 在发出第几个包之后补发
+        QByteArray data;
+    };
+
+    void buildPatternFrames();
+    void buildWireFrame(quint32 frameId);
+    bool sendPacket(qintptr socketDescriptor, const char *data, qsizetype size);
+    bool handlePacket(qintptr socketDescriptor, const char *data, qsizetype size);
+    bool releaseDelayed(qintptr socketDescriptor, bool all);
+    void waitUntil(qint64 deadlineNs, qint64 nowNs);
+    bool stopRequested() const { return m_runToken.load(std::memory_order_acquire) != m_currentToken; }
+
+private:
+    Config m_config;
+    std::vector<QByteArray> m_patternFrames;  // 预先生成的大端 RGB565 图案，循环使用
+    QByteArray m_wire;                        // 当前帧按数据报排列后的发送缓冲
+    std::vector<qsizetype> m_packetOffsets;   // 每个数据报在 m_wire 中的起始位置，末尾多一项为总长
+    std::vector<DelayedPacket> m_delayed;
+    quint64 m_sequence;                       // 已处理 (发出、丢弃或推迟) 的包数，用于安排乱序补发
+    std::mt19937 m_rng;                       // 固定种子，同样的参数每次注入的损伤完全相同
+    UdpDestination m_destination;
+
+    std::atomic<quint64> m_runToken;
+    quint64 m_currentToken;                   // 正在执行的 run 的令牌，只在发送线程中访问
+    QMutex m_runMutex;                        // run 执行期间持有
+
+    std::atomic<quint64> m_frames;
+    std::atomic<quint64> m_packets;
+    std::atomic<quint64> m_bytes;
+    std::atomic<quint64> m_droppedPackets;
+    std::atomic<quint64> m_reorderedPackets;
+    std::atomic<quint64> m_corruptedPackets;
+    std::atomic<quint64> m_lateFrames;
+};
+
+#endif // VIDEOSTREAMGENERATOR_H
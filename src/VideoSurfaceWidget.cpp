@@ -0,0 +1,87 @@
+#include "VideoSurfaceWidget.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <QResizeEvent>
+
+VideoSurfaceWidget::VideoSurfaceWidget(QWidget *parent)
+    : QWidget(parent)
+    , m_scalingMode(ScalingMode::Fast)
+    , m_geometryDirty(true)
+    , m_hasNewFrame(false)
+    , m_paintedFrames(0)
+{
+    // 每次都绘制整个控件，Qt 无需预先擦除背景
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+void VideoSurfaceWidget::setFrame(const QImage &frame) {
+    if (frame.size() != m_frame.size()) {
+        m_geometryDirty = true;
+    }
+    m_frame = frame;
+    m_hasNewFrame = true;
+    update();
+}
+
+void VideoSurfaceWidget::clear() {
+    m_frame = QImage();
+    m_hasNewFrame = false;
+    m_geometryDirty = true;
+    update();
+}
+
+void VideoSurfaceWidget::setScalingMode(ScalingMode mode) {
+    if (m_scalingMode == mode) return;
+    m_scalingMode = mode;
+    m_geometryDirty = true;
+    update();
+}
+
+void VideoSurfaceWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    m_geometryDirty = true;
+}
+
+void VideoSurfaceWidget::updateTargetRect() {
+    m_geometryDirty = false;
+    if (m_frame.isNull()) {
+        m_targetRect = QRect();
+        return;
+    }
+
+    const QSize frameSize = m_frame.size();
+    QSize targetSize;
+    if (m_scalingMode == ScalingMode::Fast
+        && frameSize.width() <= width() && frameSize.height() <= height()) {
+        // 放大时取整数倍，最近邻采样不会产生宽窄不一的像素
+        const int factor = qMin(width() / frameSize.width(), height() / frameSize.height());
+        targetSize = frameSize * factor;
+    } else {
+        targetSize = frameSize.scaled(size(), Qt::KeepAspectRatio);
+    }
+
+    m_targetRect = QRect(QPoint((width() - targetSize.width()) / 2,
+                                (height() - targetSize.height()) / 2),
+                         targetSize);
+}
+
+void VideoSurfaceWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event);
+    if (m_geometryDirty) {
+        updateTargetRect();
+    }
+
+    QPainter painter(this);
+    painter.fillRect(rect(), Qt::black);
+    if (m_frame.isNull()) {
+        return;
+    }
+
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, m_scalingMode == ScalingMode::Smooth);
+    painter.drawImage(m_targetRect, m_frame);
+
+    if (m_hasNewFrame) {
+        m_hasNewFrame = false;
+        ++m_paintedFrames;
+    }
+}
@@ -0,0 +1,46 @@
+#ifndef VIDEOSURFACEWIDGET_H
+#define VIDEOSURFACEWIDGET_H
+
+#include <QWidget>
+#include <QImage>
+
+// 视频流显示控件：只保存最新一帧，直接从 QImage 绘制。
+// 多次 setFrame() 之间如果还没来得及绘制，update() 会被合并，中间帧自然被跳过。
+class VideoSurfaceWidget : public QWidget {
+    Q_OBJECT
+
+public:
+    enum class ScalingMode {
+        Fast,   // 最近邻；放大时使用整数倍，像素边缘清晰
+        Smooth  // 双线性平滑缩放
+    };
+
+    explicit VideoSurfaceWidget(QWidget *parent = nullptr);
+
+    void setFrame(const QImage &frame);
+    void clear();
+    const QImage &frame() const { return m_frame; }
+
+    void setScalingMode(ScalingMode mode);
+    ScalingMode scalingMode() const { return m_scalingMode; }
+
+    // 实际绘制到屏幕上的帧数，可与解码帧数对比得出跳帧数
+    quint64 paintedFrameCount() const { return m_paintedFrames; }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    void updateTargetRect();
+
+private:
+    QImage m_frame;
+    ScalingMode m_scalingMode;
+    QRect m_targetRect;       // 缓存的绘制区域，只在控件或帧尺寸变化时重新计算
+    bool m_geometryDirty;
+    bool m_hasNewFrame;
+    quint64 m_paintedFrames;
+};
+
+#endif // VIDEOSURFACEWIDGET_H
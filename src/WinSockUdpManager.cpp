@@ -6,9 +6,10 @@
 
 #include <ws2tcpip.h>
 #include <QDebug>
+#include "TrafficStats.h"
 
-UdpReceiverWorker::UdpReceiverWorker(SOCKET socket, QObject* parent)
-    : QObject(parent), m_socket(socket), m_stop(false) {}
+UdpReceiverWorker::UdpReceiverWorker(SOCKET socket, TrafficStats *trafficStats, QObject* parent)
+    : QObject(parent), m_socket(socket), m_stop(false), m_trafficStats(trafficStats) {}
 
 UdpReceiverWorker::~UdpReceiverWorker() {}
 
@@ -20,6 +21,10 @@ void UdpReceiverWorker::startReceiving() {
     char buffer[65535]; // Max UDP packet size
     sockaddr_in senderAddr;
     int senderAddrSize = sizeof(senderAddr);
+    // 缓存上一个发送方的统计句柄，发送方不变时每个数据报只更新原子计数
+    ULONG statsAddr = INADDR_NONE;
+    USHORT statsPort = 0;
+    TrafficStats::PeerHandle statsPeer;
 
     // 设置超时，以便我们可以定期检查 m_stop 标志
     struct timeval tv;
@@ -38,8 +43,17 @@ void UdpReceiverWorker::startReceiving() {
             inet_ntop(AF_INET, &senderAddr.sin_addr, senderIp, INET_ADDRSTRLEN);
 
             quint16 senderPort = ntohs(senderAddr.sin_port);
+            const QString senderHost(senderIp);
+            if (m_trafficStats) {
+                if (!statsPeer || senderAddr.sin_addr.s_addr != statsAddr || senderAddr.sin_port != statsPort) {
+                    statsAddr = senderAddr.sin_addr.s_addr;
+                    statsPort = senderAddr.sin_port;
+                    statsPeer = m_trafficStats->peer(CaptureWriter::Transport::Udp, senderHost, senderPort);
+                }
+                m_trafficStats->record(TrafficStats::Rx, statsPeer, bytesReceived);
+            }
 
-            emit dataReady(datagram, QString(senderIp), senderPort);
+            emit dataReady(datagram, senderHost, senderPort);
         } else {
             // Check for errors other than timeout
             if (WSAGetLastError() != WSAETIMEDOUT) {
@@ -55,7 +69,8 @@ void UdpReceiverWorker::startReceiving() {
 //  WinSockUdpManager Implementation
 // ===================================================================
 WinSockUdpManager::WinSockUdpManager(QObject *parent)
-    : IUdpManager(parent), m_isBound(false), m_socket(INVALID_SOCKET), m_receiverThread(nullptr), m_worker(nullptr) {
+    : IUdpManager(parent), m_isBound(false), m_socket(INVALID_SOCKET), m_receiverThread(nullptr), m_worker(nullptr)
+    , m_destinationPort(0) {
     initWinSock();
 }
 
@@ -102,7 +117,7 @@ bool WinSockUdpManager::bindPort(quint16 port) {
     
     // 创建并启动接收线程
     m_receiverThread = new QThread(this);
-    m_worker = new UdpReceiverWorker(m_socket);
+    m_worker = new UdpReceiverWorker(m_socket, m_trafficStats);
     m_worker->moveToThread(m_receiverThread);
 
     connect(m_receiverThread, &QThread::started, m_worker, &UdpReceiverWorker::startReceiving);
@@ -133,23 +148,49 @@ void WinSockUdpManager::unbindPort() {
 
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
+    m_destination = UdpDestination();
     m_isBound = false;
     emit portUnbound();
 }
 
-void WinSockUdpManager::writeData(const QByteArray &data, const QString &host, quint16 port) {
-    if (!isBound()) return;
+bool WinSockUdpManager::updateDestination(const QString &host, quint16 port) {
+    if (m_destination.isValid() && port == m_destinationPort && host == m_destinationHost) return true;
+    m_destinationHost = host;
+    m_destinationPort = port;
+    if (!m_destination.resolve(static_cast<qintptr>(m_socket), host, port)) {
+        qWarning() << "Invalid UDP destination:" << host << port;
+        return false;
+    }
+    return true;
+}
 
-    sockaddr_in destAddr;
-    destAddr.sin_family = AF_INET;
-    destAddr.sin_port = htons(port);
-    inet_pton(AF_INET, host.toStdString().c_str(), &destAddr.sin_addr);
+void WinSockUdpManager::writeData(const QByteArray &data, const QString &host, quint16 port) {
+    if (!isBound() || !updateDestination(host, port)) return;
+    if (m_destination.send(static_cast<qintptr>(m_socket), data.constData(), data.size()) == UdpDestination::SendResult::Sent
+            && m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, CaptureWriter::Transport::Udp, host, port, data.size());
+    }
+}
 
-    sendto(m_socket, data.constData(), data.size(), 0, (sockaddr*)&destAddr, sizeof(destAddr));
+void WinSockUdpManager::writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) {
+    if (!isBound() || segmentSize <= 0 || !updateDestination(host, port)) return;
+    // WinSock 没有 sendmmsg，sendBatch 内部逐个 sendto，但省掉了每包的地址解析
+    const qsizetype sent = m_destination.sendBatch(static_cast<qintptr>(m_socket), data.constData(), data.size(), segmentSize);
+    if (sent > 0 && m_trafficStats) {
+        m_trafficStats->record(TrafficStats::Tx, CaptureWriter::Transport::Udp, host, port, sent,
+                               (sent + segmentSize - 1) / segmentSize);
+    }
+    if (sent < data.size()) {
+        qWarning() << "UDP batch send incomplete:" << UdpDestination::lastErrorString();
+    }
 }
 
 bool WinSockUdpManager::isBound() const {
     return m_isBound;
 }
 
+qintptr WinSockUdpManager::socketDescriptor() const {
+    return m_isBound ? static_cast<qintptr>(m_socket) : -1;
+}
+
 #endif // Q_OS_WIN
\ No newline at end of file
@@ -8,14 +8,17 @@
 #ifdef Q_OS_WIN // <-- 现在这个检查可以正常工作了
 
 #include <QThread>
+#include "UdpDestination.h"
 #include <winsock2.h> // 包含WinSock头文件
 
+class TrafficStats;
+
 // 创建一个工作类来处理阻塞的接收操作
 class UdpReceiverWorker : public QObject
 {
     Q_OBJECT
 public:
-    UdpReceiverWorker(SOCKET socket, QObject* parent = nullptr);
+    UdpReceiverWorker(SOCKET socket, TrafficStats *trafficStats, QObject* parent = nullptr);
     ~UdpReceiverWorker();
 public slots:
     void startReceiving();
@@ -25,6 +28,7 @@ signals:
 private:
     SOCKET m_socket;
     volatile bool m_stop;
+    TrafficStats *m_trafficStats; // 可为空
 };
 
 
@@ -37,7 +41,9 @@ public:
     bool bindPort(quint16 port) override;
     void unbindPort() override;
     void writeData(const QByteArray &data, const QString &host, quint16 port) override;
+    void writeDatagrams(const QByteArray &data, int segmentSize, const QString &host, quint16 port) override;
     bool isBound() const override;
+    qintptr socketDescriptor() const override;
 
 private:
     bool m_isBound;
@@ -45,6 +51,12 @@ private:
     QThread* m_receiverThread;
     UdpReceiverWorker* m_worker;
 
+    // 目标地址缓存，绑定后首次发送时解析，目标不变时不再重复解析
+    UdpDestination m_destination;
+    QString m_destinationHost;
+    quint16 m_destinationPort;
+
+    bool updateDestination(const QString &host, quint16 port);
     bool initWinSock();
     void cleanupWinSock();
 };